@@ -5,10 +5,23 @@
 #ifndef PRINTING_H
 #define PRINTING_H
 
-inline void PrintExecutionTime (const clock_t time,  const string & message) {
+/**
+* Returns the current wall clock time. Unlike clock(), it is not summed across the OpenMP threads
+* @return The wall clock time in seconds, relative to an arbitrary point in the past
+*/
+inline double GetWallTime() {
+    return omp_get_wtime();
+}
+
+/**
+* Prints the wall clock time spent executing a task
+* @param time The elapsed time in seconds, measured with GetWallTime
+* @param message The description of the task
+*/
+inline void PrintExecutionTime (const double time,  const string & message) {
     // Printing the provided time and message
-    cout << fixed << setprecision(2) << "It took " << ((float)time)/CLOCKS_PER_SEC<< " seconds (" <<
-                    (float)time / CLOCKS_PER_SEC / 60 << " minutes) to " << message << endl << endl;
+    cout << fixed << setprecision(2) << "It took " << time << " seconds (" <<
+                    time / 60 << " minutes) to " << message << endl << endl;
 }
 
 inline void PrintGenericMessage(const string & message) {
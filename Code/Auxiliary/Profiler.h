@@ -0,0 +1,183 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+/**
+* A wall clock interval spent executing a task on a thread
+*/
+struct ProfilerSpan {
+    string name; ///< Name of the task
+    const char * category; ///< Category of the task (io, build, render, post)
+    double starting_time; ///< Wall clock time at the beginning of the task, in seconds
+    double duration; ///< Duration of the task, in seconds
+    int first_argument; ///< Optional argument, exported only if non-negative (tile column)
+    int second_argument; ///< Optional argument, exported only if non-negative (tile row)
+};
+
+/**
+* The spans recorded by a single thread
+*/
+struct ThreadProfile {
+    int thread_index = 0; ///< Index of the thread in the timeline
+    vector<ProfilerSpan> spans {}; ///< The recorded spans
+};
+
+inline const double profiler_origin = GetWallTime(); ///< Wall clock time of the timeline origin
+inline mutex profiler_mutex; ///< Mutex protecting the list of the threads profiles
+inline vector<ThreadProfile *> threads_profiles; ///< The profiles of every thread that recorded a span
+inline thread_local ThreadProfile * thread_profile = nullptr; ///< The profile of the current thread
+
+/**
+* Returns the profile of the current thread, registering it on first use
+*/
+inline ThreadProfile & getThreadProfile() {
+    // Case in which the thread has not recorded anything yet
+    if(thread_profile == nullptr) {
+        // Registering the profile, it outlives the thread so that its spans are not lost
+        lock_guard lock(profiler_mutex);
+        thread_profile = new ThreadProfile { .thread_index = static_cast<int>(threads_profiles.size()) };
+        threads_profiles.push_back(thread_profile);
+    }
+
+    return * thread_profile;
+}
+
+/**
+* Verifies if the spans should be recorded, which happens only when a trace path is set
+*/
+inline bool isProfilerRecording() {
+    return !render_configuration.trace_path.empty();
+}
+
+/**
+* RAII timer measuring the wall clock time of the enclosing scope. The span is recorded in the timeline of the
+* current thread, and the execution time is optionally printed when the scope ends
+*/
+class ProfilerScope {
+    string name; ///< Name of the task, also used as message when printing the execution time
+    const char * category; ///< Category of the task
+    bool print_execution_time; ///< Flag indicating weather or not print the execution time
+    int first_argument; ///< Optional argument of the span
+    int second_argument; ///< Optional argument of the span
+    double starting_time; ///< Wall clock time at the beginning of the scope
+
+public:
+    /**
+    * Starts measuring a scope
+    * @param name Name of the task
+    * @param category Category of the task
+    * @param print_execution_time Flag indicating weather or not print the execution time at the end of the scope
+    * @param first_argument Optional argument of the span
+    * @param second_argument Optional argument of the span
+    */
+    explicit ProfilerScope(string name, const char * category, const bool print_execution_time = false,
+        const int first_argument = -1, const int second_argument = -1)
+    : name(std::move(name)), category(category), print_execution_time(print_execution_time),
+    first_argument(first_argument), second_argument(second_argument), starting_time(GetWallTime()) {
+    }
+
+    ProfilerScope(const ProfilerScope &) = delete;
+    ProfilerScope & operator=(const ProfilerScope &) = delete;
+
+    /**
+    * Stops measuring the scope
+    */
+    ~ProfilerScope() {
+        // Computing the duration
+        const double duration = GetWallTime() - starting_time;
+
+        // Recording the span
+        if(isProfilerRecording())
+            getThreadProfile().spans.push_back(ProfilerSpan {
+                .name = name,
+                .category = category,
+                .starting_time = starting_time,
+                .duration = duration,
+                .first_argument = first_argument,
+                .second_argument = second_argument
+            });
+
+        // Printing the execution time
+        if(print_execution_time)
+            PrintExecutionTime(duration, name);
+    }
+};
+
+/**
+* Escapes a string so that it can be written within a JSON string
+* @param text The string to escape
+* @return The escaped string
+*/
+inline string escapeJSON(const string & text) {
+    string escaped;
+    escaped.reserve(text.size());
+    for(const char character : text) {
+        // Escaping the quotes and the backslashes
+        if(character == '"' || character == '\\') {
+            escaped += '\\';
+            escaped += character;
+        }
+        // Escaping the control characters
+        else if(static_cast<unsigned char>(character) < 0x20) {
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", character);
+            escaped += code;
+        }
+        else
+            escaped += character;
+    }
+    return escaped;
+}
+
+/**
+* Writes the recorded spans in the Chrome trace event format, readable by chrome://tracing and Perfetto
+* @param path The path of the JSON file
+*/
+inline void writeProfilerTrace(const string & path) {
+    // Opening the file
+    ofstream file(path);
+
+    // Verifying that the file opened correctly
+    if(!file.is_open()) {
+        PrintError("Error opening file: " + path);
+        return;
+    }
+
+    // Avoiding concurrent registrations while exporting
+    lock_guard lock(profiler_mutex);
+
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << endl;
+    file << fixed << setprecision(3);
+
+    bool first_event = true;
+    for(const auto current_profile : threads_profiles) {
+        // Naming the thread
+        file << (first_event ? "" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": "
+            << current_profile->thread_index << ", \"args\": {\"name\": \"Thread "
+            << current_profile->thread_index << "\"}}";
+        first_event = false;
+
+        // Writing the complete events, with time expressed in microseconds
+        for(const auto & span : current_profile->spans) {
+            file << ",\n{\"name\": \"" << escapeJSON(span.name) << "\", \"cat\": \"" << escapeJSON(span.category)
+                << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << current_profile->thread_index
+                << ", \"ts\": " << (span.starting_time - profiler_origin) * 1e6
+                << ", \"dur\": " << span.duration * 1e6;
+
+            // Writing the optional arguments
+            if(span.first_argument >= 0)
+                file << ", \"args\": {\"x\": " << span.first_argument << ", \"y\": " << span.second_argument << "}";
+
+            file << "}";
+        }
+    }
+
+    file << endl << "]}" << endl;
+
+    cout << "Writing profiler trace to " << path << endl;
+}
+
+#endif //PROFILER_H
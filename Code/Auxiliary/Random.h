@@ -19,6 +19,14 @@ public:
 
     static RandomGenerator * getInstance();
 
+    /**
+    * Reseeds the generator, used to make runs reproducible
+    * @param seed The new seed
+    */
+    void setSeed(const unsigned int seed) {
+        std::srand(seed);
+    }
+
     int getRandomInt() {
         return rand();
     }
@@ -62,4 +70,91 @@ inline glm::vec3 generateSphericalRandomDirection(const float sphere_radius) {
     return random_direction;
 }
 
+/**
+* PCG32 generator drawing the samples of the rendering. Each pixel reseeds it from its own coordinates, so that the
+* samples of a pixel do not depend on the thread or on the order in which the tiles are rendered
+*/
+class SampleGenerator {
+    uint64_t state = 0; ///< The current state of the generator
+    uint64_t increment = 1; ///< The increment of the generator, selecting its stream
+
+public:
+    /**
+    * Computes the seed of the samples of an image, so that the frames and the cameras do not share the same noise
+    * @param frame_number The frame the image belongs to, starting from 0
+    * @param camera_index The index of the camera capturing the image within the cameras of the frame
+    * @return The seed of the image, RENDER_SAMPLES_SEED for the first camera of the first frame
+    */
+    static uint64_t computeImageSeed(const int frame_number, const int camera_index) {
+        // Scrambling the frame and the camera, the first camera of the first frame being left unchanged
+        uint64_t scrambled = static_cast<uint64_t>(static_cast<uint32_t>(frame_number)) << 32
+            | static_cast<uint32_t>(camera_index);
+        scrambled = (scrambled ^ (scrambled >> 30)) * 0xBF58476D1CE4E5B9ull;
+        scrambled = (scrambled ^ (scrambled >> 27)) * 0x94D049BB133111EBull;
+        scrambled ^= scrambled >> 31;
+
+        return RENDER_SAMPLES_SEED ^ scrambled;
+    }
+
+    /**
+    * Reseeds the generator on the stream of the random elements of the scene of a frame, such as the area light samples
+    * @param frame_number The frame whose scene is prepared, starting from 0
+    */
+    void seedScene(const int frame_number) {
+        // Using a camera index no camera has, so that the scene does not share the stream of a pixel
+        seedPixel(computeImageSeed(frame_number, -1), 0);
+    }
+
+    /**
+    * Reseeds the generator on the stream of a pixel
+    * @param seed The seed of the render
+    * @param pixel_index The index of the pixel within the image, in row major order
+    */
+    void seedPixel(const uint64_t seed, const uint64_t pixel_index) {
+        // Scrambling the pixel index, so that adjacent pixels do not start from correlated states
+        uint64_t scrambled = seed + pixel_index * 0x9E3779B97F4A7C15ull;
+        scrambled = (scrambled ^ (scrambled >> 30)) * 0xBF58476D1CE4E5B9ull;
+        scrambled = (scrambled ^ (scrambled >> 27)) * 0x94D049BB133111EBull;
+        scrambled ^= scrambled >> 31;
+
+        // Initializing the state as the reference implementation does
+        state = 0;
+        increment = (pixel_index << 1u) | 1u;
+        getRandomUInt();
+        state += scrambled;
+        getRandomUInt();
+    }
+
+    /**
+    * Returns a uniformly distributed 32 bit integer
+    */
+    uint32_t getRandomUInt() {
+        const uint64_t previous_state = state;
+        state = previous_state * 6364136223846793005ull + increment;
+        const auto shifted = static_cast<uint32_t>(((previous_state >> 18u) ^ previous_state) >> 27u);
+        const auto rotation = static_cast<uint32_t>(previous_state >> 59u);
+        return rotr(shifted, static_cast<int>(rotation));
+    }
+
+    /**
+    * Returns a float in range [0, 1)
+    */
+    float getRandomFloat() {
+        return static_cast<float>(getRandomUInt() >> 8) * 0x1p-24f;
+    }
+
+    /**
+    * Returns a point uniformly distributed within a disk centered at the origin
+    * @param disk_radius The radius of the disk
+    */
+    glm::vec2 getDiskSample(const float disk_radius) {
+        const float radius = disk_radius * sqrt(getRandomFloat());
+        const float angle = glm::two_pi<float>() * getRandomFloat();
+        return { radius * cos(angle), radius * sin(angle) };
+    }
+};
+
+inline thread_local SampleGenerator sample_generator; ///< The generator of the samples of the current thread
+inline SampleGenerator scene_generator; ///< The generator of the random elements of the scene, reseeded at each frame
+
 #endif //RANDOM_H
@@ -0,0 +1,191 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+// Names of the statistic counters, in the same order as the statistic_counter enum
+constexpr const char * statistic_counter_names[STATISTIC_COUNTERS_AMOUNT] = {
+    "camera_rays",
+    "reflected_rays",
+    "refracted_rays",
+    "volumetric_rays",
+    "shadow_rays",
+    "occluded_shadow_rays",
+    "photon_rays",
+    "bvh_nodes_visited",
+    "bvh_leaves_tested",
+    "bvh_node_bytes_read",
+    "brick_page_ins",
+    "triangle_tests",
+    "triangle_hits",
+    "knn_queries",
+    "knn_photons_touched"
+};
+
+/**
+* Set of counters describing the work done while rendering
+*/
+struct RenderStatistics {
+    array<uint64_t, STATISTIC_COUNTERS_AMOUNT> counters {}; ///< Value of each statistic_counter
+    array<uint64_t, MAX_RAY_TRACING_RECURSION_LEVEL + 1> recursion_depths {}; ///< Histogram of the traceRay depths
+
+    /**
+    * Adds the counters of another set of statistics to this one
+    * @param other The statistics to add
+    */
+    void add(const RenderStatistics & other) {
+        for(int i = 0; i < STATISTIC_COUNTERS_AMOUNT; i++)
+            counters[i] += other.counters[i];
+        for(int i = 0; i <= MAX_RAY_TRACING_RECURSION_LEVEL; i++)
+            recursion_depths[i] += other.recursion_depths[i];
+    }
+
+    /**
+    * Computes the ratio between two counters
+    * @return The ratio, or 0 if the denominator is 0
+    */
+    [[nodiscard]] double getRatio(const statistic_counter numerator, const statistic_counter denominator) const {
+        return counters[denominator] > 0 ?
+            static_cast<double>(counters[numerator]) / static_cast<double>(counters[denominator]) : 0.0;
+    }
+
+    /**
+    * Prints a summary of the statistics
+    * @param title The title of the summary
+    */
+    void print(const string & title) const {
+        cout << "Render statistics of " << title << endl;
+
+        // Printing the counters
+        for(int i = 0; i < STATISTIC_COUNTERS_AMOUNT; i++)
+            cout << "    " << left << setw(24) << statistic_counter_names[i] << right << setw(16) << counters[i] << endl;
+
+        // Computing the total amount of rays traversing the BVH
+        const uint64_t traced_rays = counters[CAMERA_RAYS] + counters[REFLECTED_RAYS] + counters[REFRACTED_RAYS]
+                                     + counters[VOLUMETRIC_RAYS] + counters[SHADOW_RAYS] + counters[PHOTON_RAYS];
+
+        // Printing the derived values
+        cout << fixed << setprecision(2);
+        if(traced_rays > 0)
+            cout << "    BVH nodes per ray:          " << static_cast<double>(counters[BVH_NODES_VISITED]) / traced_rays << endl
+                 << "    BVH node bytes per ray:     " << static_cast<double>(counters[BVH_NODE_BYTES_READ]) / traced_rays
+                 << endl
+                 << "    triangle tests per ray:     " << static_cast<double>(counters[TRIANGLE_TESTS]) / traced_rays << endl;
+        cout << "    triangle hit rate:          " << 100 * getRatio(TRIANGLE_HITS, TRIANGLE_TESTS) << " %" << endl
+             << "    shadow rays occluded:       " << 100 * getRatio(OCCLUDED_SHADOW_RAYS, SHADOW_RAYS) << " %" << endl
+             << "    photons touched per query:  " << getRatio(KNN_PHOTONS_TOUCHED, KNN_QUERIES) << endl;
+
+        // Printing the recursion histogram
+        cout << "    traceRay recursion depths: ";
+        for(int i = 0; i <= MAX_RAY_TRACING_RECURSION_LEVEL; i++)
+            cout << " [" << i << "] " << recursion_depths[i];
+        cout << endl << endl;
+    }
+
+    /**
+    * Writes the statistics as a JSON object
+    * @param stream The output stream
+    * @param title The title of the statistics
+    */
+    void writeJSON(ostream & stream, const string & title) const {
+        stream << "{\"title\": \"" << title << "\"";
+
+        // Writing the counters
+        for(int i = 0; i < STATISTIC_COUNTERS_AMOUNT; i++)
+            stream << ", \"" << statistic_counter_names[i] << "\": " << counters[i];
+
+        // Writing the recursion histogram
+        stream << ", \"recursion_depths\": [";
+        for(int i = 0; i <= MAX_RAY_TRACING_RECURSION_LEVEL; i++)
+            stream << (i > 0 ? ", " : "") << recursion_depths[i];
+        stream << "]}";
+    }
+};
+
+inline mutex statistics_mutex; ///< Mutex protecting the list of the threads statistics
+inline vector<RenderStatistics *> threads_statistics; ///< The statistics of every thread that counted something
+inline thread_local RenderStatistics * thread_statistics = nullptr; ///< The statistics of the current thread
+
+/**
+* Returns the statistics of the current thread, registering them on first use
+*/
+inline RenderStatistics & getThreadStatistics() {
+    // Case in which the thread has not counted anything yet
+    if(thread_statistics == nullptr) {
+        // Allocating the statistics, they outlive the thread so that its counters are not lost
+        thread_statistics = new RenderStatistics();
+
+        // Registering the statistics
+        lock_guard lock(statistics_mutex);
+        threads_statistics.push_back(thread_statistics);
+    }
+
+    return * thread_statistics;
+}
+
+/**
+* Increments a statistic counter of the current thread. Compiled out if USE_RENDER_STATISTICS is disabled
+* @param counter The counter to increment
+* @param amount The increment
+*/
+inline void countStatistic(const statistic_counter counter, const uint64_t amount = 1) {
+    if constexpr (USE_RENDER_STATISTICS)
+        getThreadStatistics().counters[counter] += amount;
+}
+
+/**
+* Records the recursion depth of a traceRay call. Compiled out if USE_RENDER_STATISTICS is disabled
+* @param recursion_level The recursion level of the call
+*/
+inline void countRecursionDepth(const unsigned int recursion_level) {
+    if constexpr (USE_RENDER_STATISTICS)
+        getThreadStatistics().recursion_depths[min(recursion_level,
+            static_cast<unsigned int>(MAX_RAY_TRACING_RECURSION_LEVEL))]++;
+}
+
+/**
+* Aggregates the statistics of all the threads and resets them. Must be called while no thread is counting
+* @return The aggregated statistics
+*/
+inline RenderStatistics collectRenderStatistics() {
+    // Initializing the aggregated statistics
+    RenderStatistics aggregated_statistics;
+
+    // Summing and resetting the statistics of each thread
+    lock_guard lock(statistics_mutex);
+    for(const auto current_statistics : threads_statistics) {
+        aggregated_statistics.add(* current_statistics);
+        * current_statistics = RenderStatistics();
+    }
+
+    return aggregated_statistics;
+}
+
+/**
+* Writes a list of statistics to a JSON file
+* @param path The path of the JSON file
+* @param statistics The statistics with their titles
+*/
+inline void writeRenderStatistics(const string & path, const vector<pair<string, RenderStatistics>> & statistics) {
+    // Opening the file
+    ofstream file(path);
+
+    // Verifying that the file opened correctly
+    if(!file.is_open()) {
+        PrintError("Error opening file: " + path);
+        return;
+    }
+
+    // Writing the statistics
+    file << "[" << endl;
+    for(size_t i = 0; i < statistics.size(); i++) {
+        file << "  ";
+        statistics[i].second.writeJSON(file, statistics[i].first);
+        file << (i + 1 < statistics.size() ? "," : "") << endl;
+    }
+    file << "]" << endl;
+}
+
+#endif //STATISTICS_H
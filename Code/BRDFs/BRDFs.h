@@ -89,7 +89,7 @@ inline glm::vec3 computeReflectedIntensity(const glm::vec3 & light_intensity, co
     float D;
 
     // Extracting the primitive roughness
-    const float roughness = interaction.primitive->getRoughness(interaction.uv_coordinates);
+    const float roughness = interaction.primitive->getRoughness(interaction);
 
     // Case in which the material is not isotropic
     if(surface_material->anisotropy != 0) {
@@ -131,7 +131,7 @@ inline glm::vec3 computeReflectedIntensity(const glm::vec3 & light_intensity, co
     float diffuse_intensity = 1 - specular_intensity;
 
     // Extracting the material diffuse and specular
-    const auto diffuse = interaction.primitive->getDiffuse(interaction.uv_coordinates);
+    const auto diffuse = interaction.primitive->getDiffuse(interaction);
     const auto material_specular = surface_material->getSpecular(interaction.intersection);
 
     // Adding current light contribution to the final color
@@ -153,10 +153,12 @@ inline glm::vec3 computeReflectedIntensity(const glm::vec3 & light_intensity, co
 
 /** Function for computing color of an object according to the Cook-Torrance model. Currently using Blinn-Pong
  * distribution and Schlick’s approximation for Fresnel effect.
+ @tparam FEATURES The render_feature flags the kernel is specialized on
  @param interaction A point belonging to the object for which the color is computer
  @param ray The ray
 */
-inline glm::vec3 CookTorrance(const Interaction & interaction, const Ray & ray) {
+template <unsigned int FEATURES>
+glm::vec3 CookTorrance(const Interaction & interaction, const Ray & ray) {
     // Initializing the color of the pixel
     glm::vec3 surface_intensity(0.0);
 
@@ -173,7 +175,7 @@ inline glm::vec3 CookTorrance(const Interaction & interaction, const Ray & ray)
     surface_intensity.z += surface_material.self_illuminance.z;
 
     // Extracting potential occlusion from the texture
-    const float ambient_occlusion = interaction.primitive->getAmbientOcclusion(interaction.uv_coordinates);
+    const float ambient_occlusion = interaction.primitive->getAmbientOcclusion(interaction);
 
     // AMBIENT
     // Computing RED channel
@@ -217,9 +219,9 @@ inline glm::vec3 CookTorrance(const Interaction & interaction, const Ray & ray)
     surface_intensity += direct_intensity;
 
     // PHOTONS CONTRIBUTION
-    if (USE_PHOTON_MAPPING) {
+    if constexpr ((FEATURES & (INDIRECT_LIGHTING_FEATURE | CAUSTIC_FEATURE)) != 0) {
         // INDIRECT LIGHTING
-        if(USE_INDIRECT_LIGHTING) {
+        if constexpr ((FEATURES & INDIRECT_LIGHTING_FEATURE) != 0) {
             // Static coefficients
             constexpr int max_photons = 150;
             constexpr float smoothing_kernel_sigma = 0.2f;
@@ -275,7 +277,7 @@ inline glm::vec3 CookTorrance(const Interaction & interaction, const Ray & ray)
         }
 
         // CAUSTICS
-        if(USE_CAUSTIC) {
+        if constexpr ((FEATURES & CAUSTIC_FEATURE) != 0) {
             // Static coefficients
             constexpr int max_photons = 60;
             constexpr float alpha = 0.918;
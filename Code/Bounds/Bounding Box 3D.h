@@ -67,6 +67,13 @@ public:
         this->max_coordinates = glm::vec3(-INFINITY);
     }
 
+    /**
+    * @return True if the bounding box contains no point, false otherwise
+    */
+    [[nodiscard]] bool isEmpty() const {
+        return glm::any(glm::greaterThan(this->min_coordinates, this->max_coordinates));
+    }
+
     /**
     * Getter function of the bounding box diagonal
     * @return The internal diagonal vector of the bounding box
@@ -172,6 +179,94 @@ public:
         return max_lambda > 0;
     }
 
+    /**
+    * Function that computes the distance at which a ray enters a bounding box, with a single slab test
+    * @param ray The ray in global coordinates
+    * @param reciprocals The ray direction reciprocals
+    * @param is_reciprocal_negative An array indicating weather or not the ray reciprocals are negative
+    * @param max_distance The distance past which the box is considered missed
+    * @return The entry distance, 0 if the ray starts within the box, INFINITY if the box is missed
+    */
+    [[nodiscard]] float IntersectEntry(const Ray & ray,
+        const glm::vec3 & reciprocals,
+        const int is_reciprocal_negative[3],
+        const float max_distance) const {
+        // Extracting the reference to the current bounding box
+        const BoundingBox3 & bounding_box = * this;
+
+        // Computing the lambda value on X axis
+        float min_lambda = (bounding_box[    is_reciprocal_negative[0]].x - ray.origin.x) * reciprocals.x;
+        float max_lambda = (bounding_box[1 - is_reciprocal_negative[0]].x - ray.origin.x) * reciprocals.x;
+
+        // Computing the lambda value on Y axis
+        const float min_lambda_y = (bounding_box[    is_reciprocal_negative[1]].y - ray.origin.y) * reciprocals.y;
+        const float max_lambda_y = (bounding_box[1 - is_reciprocal_negative[1]].y - ray.origin.y) * reciprocals.y;
+
+        // Verifying intersection condition
+        if (min_lambda > max_lambda_y || min_lambda_y > max_lambda)
+            return INFINITY;
+
+        // Updating the min and max value of lambda
+        if (min_lambda_y > min_lambda) min_lambda = min_lambda_y;
+        if (max_lambda_y < max_lambda) max_lambda = max_lambda_y;
+
+        // Computing the lambda value on Z axis
+        const float min_lambda_z = (bounding_box[    is_reciprocal_negative[2]].z - ray.origin.z) * reciprocals.z;
+        const float max_lambda_z = (bounding_box[1 - is_reciprocal_negative[2]].z - ray.origin.z) * reciprocals.z;
+
+        // Verifying intersection condition
+        if (min_lambda > max_lambda_z || min_lambda_z > max_lambda)
+            return INFINITY;
+
+        // Updating the min and max value of lambda
+        if (min_lambda_z > min_lambda) min_lambda = min_lambda_z;
+        if (max_lambda_z < max_lambda) max_lambda = max_lambda_z;
+
+        // Verifying that the intersection is neither behind the ray nor past the max distance
+        if (max_lambda < 0 || min_lambda > max_distance)
+            return INFINITY;
+
+        return max(min_lambda, 0.0f);
+    }
+
+    /**
+    * Function that computes the range of distances over which a ray crosses a bounding box
+    * @param ray The ray in global coordinates
+    * @param reciprocals The ray direction reciprocals
+    * @param is_reciprocal_negative An array indicating weather or not the ray reciprocals are negative
+    * @param entry_distance The distance at which the ray enters the box, 0 if it starts within it
+    * @param exit_distance The distance at which the ray exits the box
+    * @return True if the ray crosses the box ahead of its origin, false otherwise
+    */
+    bool IntersectRange(const Ray & ray,
+        const glm::vec3 & reciprocals,
+        const int is_reciprocal_negative[3],
+        float & entry_distance,
+        float & exit_distance) const {
+        // Extracting the reference to the current bounding box
+        const BoundingBox3 & bounding_box = * this;
+
+        // Intersecting the slabs of each axis
+        float min_lambda = 0.0f;
+        float max_lambda = INFINITY;
+        for(int axis = 0; axis < 3; axis++) {
+            const float slab_min = (bounding_box[    is_reciprocal_negative[axis]][axis] - ray.origin[axis])
+                                   * reciprocals[axis];
+            const float slab_max = (bounding_box[1 - is_reciprocal_negative[axis]][axis] - ray.origin[axis])
+                                   * reciprocals[axis];
+
+            // Updating the min and max value of lambda, the undefined slabs of rays lying on a face being ignored
+            if(slab_min > min_lambda) min_lambda = slab_min;
+            if(slab_max < max_lambda) max_lambda = slab_max;
+            if(min_lambda > max_lambda)
+                return false;
+        }
+
+        entry_distance = min_lambda;
+        exit_distance = max_lambda;
+        return true;
+    }
+
     /**
     * Function that verifies if a ray intersect a bounding box. Core function of the BVH traversal algorithm
     * @param ray The ray in global coordinates
@@ -249,6 +344,22 @@ public:
         return {min_coordinates, max_coordinates};
     }
 
+    /**
+    * Function that given two bounding box, computes their intersection
+    * @return A bounding box result of the intersection of the input, empty if they do not overlap
+    */
+    static BoundingBox3 Intersection(const BoundingBox3 & first_box, const BoundingBox3 & second_box) {
+        // Computing the overlapping range on each axis
+        const glm::vec3 min_coordinates = glm::max(first_box.min_coordinates, second_box.min_coordinates);
+        const glm::vec3 max_coordinates = glm::min(first_box.max_coordinates, second_box.max_coordinates);
+
+        // Case in which the boxes do not overlap
+        if(glm::any(glm::greaterThan(min_coordinates, max_coordinates)))
+            return {};
+
+        return {min_coordinates, max_coordinates};
+    }
+
     /**
     * Function that given a bounding box and a point computes their union
     * @return A bounding box result of the union of a bounding box and a point
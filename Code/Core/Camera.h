@@ -55,6 +55,13 @@ public:
         local_ray.direction = transform * glm::vec4(local_ray.direction, 0);
         local_ray.direction = normalize(local_ray.direction);
         local_ray.origin = transform * glm::vec4(local_ray.origin, 1);
+
+        // Globalizing the differentials
+        if(local_ray.has_differentials) {
+            local_ray.dx_direction = normalize(glm::vec3(transform * glm::vec4(local_ray.dx_direction, 0)));
+            local_ray.dy_direction = normalize(glm::vec3(transform * glm::vec4(local_ray.dy_direction, 0)));
+        }
+
         return local_ray;
     }
 
@@ -16,13 +16,15 @@ using namespace std;
  Structure representing the even of hitting an object
  */
 struct Interaction {
-    bool hit; ///< Boolean indicating whether there was or there was no intersection with an object
-    glm::vec3 normal; ///< Normal vector of the intersected object at the intersection point
-    glm::vec3 intersection; ///< Surface point in global coordinates
-    glm::vec2 uv_coordinates; ///< Surface point in UV coordinates
-    float distance; ///< Distance from the origin of the ray to the intersection point
-    Primitive * primitive; ///< A pointer to the intersected object
-    const Material * material; ///< The material of the surface hit
+    bool hit = false; ///< Boolean indicating whether there was or there was no intersection with an object
+    glm::vec3 normal = glm::vec3(0.0f); ///< Normal vector of the intersected object at the intersection point
+    glm::vec3 intersection = glm::vec3(0.0f); ///< Surface point in global coordinates
+    glm::vec2 uv_coordinates = glm::vec2(0.0f); ///< Surface point in UV coordinates
+    glm::vec2 uv_dx = glm::vec2(0.0f); ///< Change of the UV coordinates between horizontally adjacent pixels
+    glm::vec2 uv_dy = glm::vec2(0.0f); ///< Change of the UV coordinates between vertically adjacent pixels
+    float distance = INFINITY; ///< Distance from the origin of the ray to the intersection point
+    Primitive * primitive = nullptr; ///< A pointer to the intersected object
+    const Material * material = nullptr; ///< The material of the surface hit
 };
 
 /**
@@ -33,6 +35,11 @@ struct Ray {
     glm::vec3 direction; ///< Direction of the ray
 
     float current_medium_refraction_index = 1; ///< Refraction index of the medium the ray is travelling in
+
+    // RAY DIFFERENTIALS
+    bool has_differentials = false; ///< Flag indicating weather or not the differentials are valid (camera rays only)
+    glm::vec3 dx_direction {}; ///< Direction of the ray shot through the horizontally adjacent pixel, same origin
+    glm::vec3 dy_direction {}; ///< Direction of the ray shot through the vertically adjacent pixel, same origin
 };
 
 /**
@@ -60,4 +67,14 @@ struct Vertex {
     glm::vec3 bitangent; ///< Bitangent in object space
 };
 
+/**
+* Rectangular portion of an image, rendered as a single unit of work
+*/
+struct RenderTile {
+    int x_start = 0; ///< First column of the tile (inclusive)
+    int y_start = 0; ///< First row of the tile (inclusive)
+    int x_end = 0; ///< Last column of the tile (exclusive)
+    int y_end = 0; ///< Last row of the tile (exclusive)
+};
+
 #endif //CORE_STRUCTS_H
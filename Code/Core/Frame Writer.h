@@ -0,0 +1,147 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef FRAME_WRITER_H
+#define FRAME_WRITER_H
+
+/**
+* Background stage post-processing and writing the rendered images while the next ones are rendered. The images are
+* taken from a fixed pool of framebuffers, so that the memory stays constant regardless of the amount of frames: once
+* every framebuffer is either rendering or queued, acquiring a new one waits for the oldest image to be written.
+* The post-processing of the stage is serial, leaving the cores to the render
+*/
+class FrameWriter {
+
+    /**
+    * An image waiting to be written
+    */
+    struct QueuedImage {
+        Image * image; ///< The rendered image
+        RenderConfiguration configuration; ///< The configuration at the time of the rendering
+    };
+
+    mutex writer_mutex; ///< Mutex protecting the queue and the framebuffers
+    condition_variable queue_changed; ///< Notified when an image is queued or the stage is finishing
+    condition_variable framebuffer_released; ///< Notified when a framebuffer becomes available
+
+    queue<QueuedImage> queued_images; ///< The images waiting to be written, from the oldest
+    vector<Image *> available_framebuffers; ///< The framebuffers not in use
+    int framebuffers_amount = 0; ///< Amount of allocated framebuffers
+    bool finishing = false; ///< Flag indicating that no further image will be queued
+
+    thread writer_thread; ///< The thread post-processing and writing the images
+
+    /**
+    * Loop of the background thread, writing the queued images until the stage is finishing and the queue is empty
+    */
+    void writeQueuedImages() {
+        // Running the parallel regions of the post-processing on this thread alone, since the render of the next
+        // frame already occupies every core. The setting only affects the regions started by this thread
+        omp_set_num_threads(1);
+
+        while(true) {
+            QueuedImage current;
+            {
+                unique_lock lock(writer_mutex);
+                queue_changed.wait(lock, [this] { return finishing || !queued_images.empty(); });
+
+                // Case in which every image was written
+                if(queued_images.empty())
+                    return;
+
+                current = std::move(queued_images.front());
+                queued_images.pop();
+            }
+
+            // Applying the post-processing pipeline
+            {
+                const ProfilerScope profiler_scope("execute post processing", "post",
+                    PRINT_POST_PROCESSING_EXECUTION_TIME);
+                current.image->applyPostProcessing(current.configuration);
+            }
+
+            // Writing the image
+            {
+                const ProfilerScope profiler_scope("write " + current.image->getName(), "io");
+                current.image->writeImage("./" + current.image->getName() + ".ppm");
+            }
+
+            // Releasing the framebuffer
+            {
+                lock_guard lock(writer_mutex);
+                available_framebuffers.push_back(current.image);
+            }
+            framebuffer_released.notify_one();
+        }
+    }
+
+public:
+    FrameWriter() : writer_thread(& FrameWriter::writeQueuedImages, this) {
+    }
+
+    FrameWriter(const FrameWriter &) = delete;
+    FrameWriter & operator=(const FrameWriter &) = delete;
+
+    ~FrameWriter() {
+        finish();
+
+        // Releasing the framebuffers
+        for(const auto framebuffer : available_framebuffers)
+            delete framebuffer;
+    }
+
+    /**
+    * Function that returns a framebuffer for a new rendering, waiting for one to be written if the pool is exhausted
+    * @param name Name of the image
+    * @param width Width of the image
+    * @param height Height of the image
+    */
+    Image * acquireImage(string name, const int width, const int height) {
+        unique_lock lock(writer_mutex);
+
+        // Allocating a new framebuffer as long as the pool is not full
+        if(available_framebuffers.empty() && framebuffers_amount < OUTPUT_FRAMEBUFFERS_AMOUNT) {
+            framebuffers_amount++;
+            return new Image(std::move(name), width, height);
+        }
+
+        // Waiting for the oldest queued image to be written
+        framebuffer_released.wait(lock, [this] { return !available_framebuffers.empty(); });
+
+        // Reusing the framebuffer
+        Image * framebuffer = available_framebuffers.back();
+        available_framebuffers.pop_back();
+        framebuffer->reset(std::move(name), width, height);
+        return framebuffer;
+    }
+
+    /**
+    * Function that queues a rendered image, to be post-processed and written in background
+    * @param image The image, acquired from this stage
+    * @param configuration The configuration selecting the post-processing stages
+    */
+    void submitImage(Image * image, const RenderConfiguration & configuration) {
+        {
+            lock_guard lock(writer_mutex);
+            queued_images.push(QueuedImage { .image = image, .configuration = configuration });
+        }
+        queue_changed.notify_one();
+    }
+
+    /**
+    * Function that waits for every queued image to be written, after which no further image can be queued
+    */
+    void finish() {
+        {
+            lock_guard lock(writer_mutex);
+            finishing = true;
+        }
+        queue_changed.notify_one();
+
+        if(writer_thread.joinable())
+            writer_thread.join();
+    }
+};
+
+#endif //FRAME_WRITER_H
@@ -16,6 +16,15 @@ using namespace std;
 
 constexpr int MAX_PPM_VALUE = 255;
 
+/**
+* Features of the surface seen through a pixel, written by the renderer to guide the denoiser
+*/
+struct PixelFeatures {
+    glm::vec3 albedo = glm::vec3(0.0f); ///< Diffuse color of the surface
+    glm::vec3 normal = glm::vec3(0.0f); ///< Normal of the surface, null if the pixel sees no surface
+    float depth = 0.0f; ///< Distance of the surface from the camera
+};
+
 /**
  Class allowing for creating an image and writing it to a file
  */
@@ -27,261 +36,367 @@ class Image {
     int height; ///< Resolution height of the image
 
     float * hdr_data; ///< a pointer to the hdr_data representing the images
-    unsigned int * ppm_data{}; ///< data that is placed into the ppm file
+    unsigned char * ldr_data = nullptr; ///< 8 bit data placed into the ppm file, produced by the post-processing
+    PixelFeatures * features = nullptr; ///< Features guiding the denoiser, allocated only if requested
+    float * denoised_data = nullptr; ///< The denoised HDR data, produced by the post-processing
 
     /**
-     * Function that computes output luminance using the Extended Reinhard function
-     * @param input_luminance The array containing the input luminance
-     * @param output_luminance The array containing the output luminance
-     * @param max_luminance The max luminance present in the input array
+     * Function that computes the output luminance of a TMO curve
+     * @tparam OPERATOR The TMO curve
+     * @param input_luminance The input luminance
+     * @param max_luminance The max luminance present in the image
+     * @return The output luminance
      */
-    void extendedReinhardTM(const std::vector<float> & input_luminance, std::vector<float> & output_luminance,
-                            const float max_luminance) const {
-        // Applying the TMO
-        for(int h = 0; h < height; h++) {
-            for(int w = 0; w < width; w++) {
-                // Current index
-                int current_index = h * width + w;
+    template <TMO OPERATOR>
+    static float applyTMO(const float input_luminance, const float max_luminance) {
+        // Extended Reinhard function
+        if constexpr (OPERATOR == EXTENDED_REINHARD)
+            return input_luminance * (1.0f + input_luminance / (max_luminance * max_luminance))
+                   / (1.0f + input_luminance);
+
+        // Simplified ACES by Krzysztof Narkowicz
+        if constexpr (OPERATOR == ACES) {
+            constexpr float A = 2.51f;
+            constexpr float B = 0.03f;
+            constexpr float C = 2.43f;
+            constexpr float D = 0.59f;
+            constexpr float E = 0.14f;
+            return (input_luminance * (A * input_luminance + B)) / (input_luminance * (C * input_luminance + D) + E);
+        }
 
-                // Applying the function
-                float current_input_luminance = input_luminance[current_index];
-                float numerator = current_input_luminance * (1.0f + current_input_luminance
-                        / pow(max_luminance, 2));
+        // Logarithmic function
+        if constexpr (OPERATOR == LOGARITHMIC) {
+            constexpr float C = 1.0f;
+            return log(C * input_luminance + 1) / log(max_luminance + 1);
+        }
 
-                // Filling the output array
-                output_luminance[current_index] = numerator / (1.0f + current_input_luminance);
-            }
+        // Power function
+        if constexpr (OPERATOR == POWER) {
+            constexpr float ALPHA = 0.8f;
+            constexpr float BETA = 0.85f;
+            return ALPHA * pow(input_luminance, BETA);
         }
+
+        // Linear function
+        if constexpr (OPERATOR == LINEAR)
+            return input_luminance / max_luminance;
+
+        return input_luminance;
     }
 
     /**
-     * Function that computes output luminance using the simplified ACES by Krzysztof Narkowicz
-     * @param input_luminance The array containing the input luminance
-     * @param output_luminance The array containing the output luminance
-     * @param max_luminance The max luminance present in the input array
+     * Function that computes the luminance of a pixel
+     * @param rgb Pointer to the RGB values of the pixel
      */
-    void simplifiedACES (const std::vector<float> & input_luminance, std::vector<float> & output_luminance,
-                         float max_luminance) const {
-        // Constants
-        constexpr float A = 2.51f;
-        constexpr float B = 0.03f;
-        constexpr float C = 2.43f;
-        constexpr float D = 0.59f;
-        constexpr float E = 0.14f;
-
-        // Applying the TMO
-        for(int h = 0; h < height; h++) {
-            for(int w = 0; w < width; w++) {
-                // Current index
-                int current_index = h * width + w;
+    static float computeLuminance(const float * rgb) {
+        // Constants for luminance calculation
+        constexpr float RED_LUMINANCE_COEFF = 0.2125f;
+        constexpr float GREEN_LUMINANCE_COEFF = 0.7154f;
+        constexpr float BLUE_LUMINANCE_COEFF = 0.0721f;
 
-                // Applying the function
-                float current_input_luminance = input_luminance[current_index];
-                output_luminance[current_index] = (current_input_luminance * (A * current_input_luminance + B ))
-                        / ( current_input_luminance * (C * current_input_luminance + D) + E);
-            }
-        }
+        return RED_LUMINANCE_COEFF * rgb[0] + GREEN_LUMINANCE_COEFF * rgb[1] + BLUE_LUMINANCE_COEFF * rgb[2];
     }
 
     /**
-     * Function that computes output luminance using a logarithmic function
-     * @param input_luminance The array containing the input luminance
-     * @param output_luminance The array containing the output luminance
-     * @param max_luminance The max luminance present in the input array
+     * Function that computes the max luminance of the image, reducing in parallel
+     * @param source The HDR data
      */
-    void logarithmicTM(const std::vector<float> & input_luminance, std::vector<float> & output_luminance,
-                       const float max_luminance) const {
-        // Constants
-        constexpr float C = 1.0f;
-
-        // Applying TMO
-        for(int h = 0; h < height; h++) {
-            for(int w = 0; w < width; w++) {
-                // Current index
-                int current_index = h * width + w;
+    [[nodiscard]] float computeMaxLuminance(const float * source) const {
+        float max_luminance = 0;
+        const int pixels_amount = width * height;
+        const float * hdr_pixels = source;
 
-                // Applying the function
-                output_luminance [current_index] = log(C * input_luminance[current_index] + 1)
-                                                        / log(max_luminance + 1);
-            }
-        }
+        #pragma omp parallel for simd reduction(max : max_luminance) schedule(static)
+        for(int i = 0; i < pixels_amount; i++)
+            max_luminance = max(max_luminance, computeLuminance(hdr_pixels + 3 * i));
+
+        return max_luminance;
     }
 
     /**
-     * Function that computes output luminance using a power function
-     * @param input_luminance The array containing the input luminance
-     * @param output_luminance The array containing the output luminance
-     * @param max_luminance The max luminance present in the input array
+     * Function that encodes a value in range [0, 1] to 8 bit, truncating like the PPM writer does
+     * @param value The value to encode
      */
-    void powerTM(const std::vector<float> & input_luminance, std::vector<float> & output_luminance,
-                 float max_luminance) const {
-        // Constants
-        constexpr float ALPHA  = 0.8f;
-        constexpr float BETA = 0.85f;
-
-        // Applying TMO
-        for(int h = 0; h < height; h++) {
-            for(int w = 0; w < width; w++) {
-                // Current index
-                int current_index = h * width + w;
+    static unsigned char encodeLinear(const float value) {
+        return static_cast<unsigned char>(MAX_PPM_VALUE * glm::clamp(value, 0.0f, 1.0f));
+    }
 
-                // Applying the function
-                output_luminance [current_index] = ALPHA * pow(input_luminance[current_index], BETA) ;
+    /**
+    * Table replacing the power function of the gamma correction. The range [2^-20, 1] is split in buckets made of
+    * the floats sharing exponent and top 7 bits of mantissa, each bucket being narrower than a gamma corrected code:
+    * a bucket stores its first code and the value at which the next code starts, if it falls within the bucket
+    */
+    struct GammaTable {
+        static constexpr uint32_t FIRST_BUCKET = (127 - 20) << 7; ///< Bucket of 2^-20, values below encode to 0
+        static constexpr int BUCKETS_AMOUNT = 20 << 7; ///< Amount of buckets in range [2^-20, 1)
+
+        array<unsigned char, BUCKETS_AMOUNT + 1> codes {}; ///< First code of each bucket, the last one holding 1
+        array<float, BUCKETS_AMOUNT + 1> next_code_thresholds {}; ///< Value at which the next code starts
+
+        GammaTable() {
+            // Computing the linear values at which each gamma corrected code starts
+            array<float, MAX_PPM_VALUE + 2> thresholds {};
+            for(int code = 1; code <= MAX_PPM_VALUE; code++)
+                thresholds[code] = pow(static_cast<float>(code) / MAX_PPM_VALUE, 1.0f / GAMMA_CORRECTION_FACTOR);
+            thresholds[MAX_PPM_VALUE + 1] = INFINITY;
+
+            // Filling the buckets
+            int code = 0;
+            for(int i = 0; i <= BUCKETS_AMOUNT; i++) {
+                // Extracting the range of the bucket
+                const float bucket_start = bit_cast<float>((FIRST_BUCKET + i) << 16);
+                const float bucket_end = bit_cast<float>((FIRST_BUCKET + i + 1) << 16);
+
+                // Advancing to the code of the bucket start
+                while(thresholds[code + 1] <= bucket_start)
+                    code++;
+
+                codes[i] = static_cast<unsigned char>(code);
+                next_code_thresholds[i] = thresholds[code + 1] < bucket_end ? thresholds[code + 1] : INFINITY;
             }
         }
+    };
 
+    /**
+     * Function that encodes a value in range [0, 1] to 8 bit after gamma correction, truncating like the PPM writer
+     * does. Instead of evaluating the power function, the code is read from the gamma table
+     * @param value The value to encode
+     */
+    static unsigned char encodeGammaCorrected(float value) {
+        static const GammaTable table;
+
+        // Finding the bucket of the value
+        value = glm::clamp(value, 0.0f, 1.0f);
+        const int bucket = glm::clamp(static_cast<int>(bit_cast<uint32_t>(value) >> 16)
+            - static_cast<int>(GammaTable::FIRST_BUCKET), 0, GammaTable::BUCKETS_AMOUNT);
+
+        return table.codes[bucket] + (value >= table.next_code_thresholds[bucket]);
     }
 
     /**
-     * Function that computes output luminance using a linear function
-     * @param input_luminance The array containing the input luminance
-     * @param output_luminance The array containing the output luminance
-     * @param max_luminance The max luminance present in the input array
+     * Function that applies the whole post-processing pipeline to a band of rows in a single pass: tone mapping,
+     * clamping, gamma correction and 8 bit encoding. The HDR data is left untouched
+     * @tparam OPERATOR The TMO curve used by the tone mapping
+     * @tparam TONE_MAPPING Flag indicating weather or not apply tone mapping
+     * @tparam GAMMA_CORRECTION Flag indicating weather or not apply gamma correction
+     * @param source The HDR data
+     * @param first_row The first row of the band
+     * @param last_row The row following the last row of the band
+     * @param max_luminance The max luminance present in the image
      */
-    void simpleTM(const std::vector<float> & input_luminance, std::vector<float> & output_luminance,
+    template <TMO OPERATOR, bool TONE_MAPPING, bool GAMMA_CORRECTION>
+    void postProcessRows(const float * source, const int first_row, const int last_row,
         const float max_luminance) const {
-        // Applying the TMO
-        for(int h = 0; h < height; h++) {
-            for(int w = 0; w < width; w++) {
-                // Current index
-                int current_index = h * width + w;
+        // Extracting the first pixel of the band, so that the 8 bit writes do not force reloading the members
+        const float * hdr_pixels = source + 3 * first_row * width;
+        unsigned char * ldr_pixels = ldr_data + 3 * first_row * width;
+        const int pixels_amount = (last_row - first_row) * width;
+
+        #pragma omp simd
+        for(int i = 0; i < pixels_amount; i++) {
+            // Extracting the RGB values of the current pixel
+            const float * hdr_pixel = hdr_pixels + 3 * i;
+            float red = hdr_pixel[0];
+            float green = hdr_pixel[1];
+            float blue = hdr_pixel[2];
+
+            // Applying to the pixel the ratio between its output luminance and input luminance
+            if constexpr (TONE_MAPPING) {
+                const float current_input_luminance = computeLuminance(hdr_pixel);
+                const float TMO_coefficient = applyTMO<OPERATOR>(current_input_luminance, max_luminance)
+                                              / (current_input_luminance + 1e-6f);
+                red *= min(1.0f, TMO_coefficient * red);
+                green *= min(1.0f, TMO_coefficient * green);
+                blue *= min(1.0f, TMO_coefficient * blue);
+            }
 
-                // Applying the function
-                output_luminance[current_index] = input_luminance[current_index] / max_luminance;
+            // Encoding the channels, the encoders clamp the values to 1 (they may exceed it after post-processing)
+            unsigned char * ldr_pixel = ldr_pixels + 3 * i;
+            if constexpr (GAMMA_CORRECTION) {
+                ldr_pixel[0] = encodeGammaCorrected(red);
+                ldr_pixel[1] = encodeGammaCorrected(green);
+                ldr_pixel[2] = encodeGammaCorrected(blue);
+            }
+            else {
+                ldr_pixel[0] = encodeLinear(red);
+                ldr_pixel[1] = encodeLinear(green);
+                ldr_pixel[2] = encodeLinear(blue);
             }
         }
     }
 
     /**
-    * Function clamping the values of each RGB channel to 1
-    */
-    void applyRGBClamping() {
-        for(int h = 0; h < height; h++) {
-            for(int w = 0; w < width; w++) {
-                // Current index
-                int current_rgb_index = 3 * (h * width + w);
-
-                // Clamping the RGBs values to 1 (they may exceed it a bit after post-processing)
-                float current_red_value = hdr_data[current_rgb_index + 0];
-                hdr_data[current_rgb_index + 0] = min(1.0f, current_red_value);
-                float current_green_value = hdr_data[current_rgb_index + 1];
-                hdr_data[current_rgb_index + 1] = min(1.0f, current_green_value);
-                float current_blue_value = hdr_data[current_rgb_index + 2];
-                hdr_data[current_rgb_index + 2] = min(1.0f, current_blue_value);
-            }
-        }
+     * Function that applies the fused post-processing pipeline to the whole image, in parallel over bands of rows
+     * @tparam OPERATOR The TMO curve used by the tone mapping
+     * @tparam TONE_MAPPING Flag indicating weather or not apply tone mapping
+     * @tparam GAMMA_CORRECTION Flag indicating weather or not apply gamma correction
+     * @param source The HDR data
+     * @param max_luminance The max luminance present in the image
+     */
+    template <TMO OPERATOR, bool TONE_MAPPING, bool GAMMA_CORRECTION>
+    void postProcessBands(const float * source, const float max_luminance) const {
+        #pragma omp parallel for schedule(static)
+        for(int h = 0; h < height; h += RENDER_TILE_SIZE)
+            postProcessRows<OPERATOR, TONE_MAPPING, GAMMA_CORRECTION>(source, h, min(h + RENDER_TILE_SIZE, height),
+                max_luminance);
     }
 
     /**
-     * Function that applies gamma correction to the image
+     * Function that applies the fused post-processing pipeline to the whole image, selecting the kernel specialized
+     * on the enabled stages
+     * @tparam OPERATOR The TMO curve used by the tone mapping
+     * @param source The HDR data
+     * @param max_luminance The max luminance present in the image, 0 to skip the tone mapping
+     * @param use_gamma_correction Flag indicating weather or not apply gamma correction
      */
-    void applyGammaCorrection(){
-        // Applying the gamma correction to the image
-        for(int h = 0; h < height; h++) {
-            for(int w = 0; w < width; w++) {
-                // Current index
-                int current_rgb_index = 3 * (h * width + w);
+    template <TMO OPERATOR>
+    void postProcess(const float * source, const float max_luminance, const bool use_gamma_correction) const {
+        if(max_luminance > 0 && use_gamma_correction)
+            postProcessBands<OPERATOR, true, true>(source, max_luminance);
+        else if(max_luminance > 0)
+            postProcessBands<OPERATOR, true, false>(source, max_luminance);
+        else if(use_gamma_correction)
+            postProcessBands<OPERATOR, false, true>(source, max_luminance);
+        else
+            postProcessBands<OPERATOR, false, false>(source, max_luminance);
+    }
 
-                // Apply the gamma correction to the pixel
-                hdr_data[current_rgb_index + 0] = pow(hdr_data[current_rgb_index + 0], GAMMA_CORRECTION_FACTOR);
-                hdr_data[current_rgb_index + 1] = pow(hdr_data[current_rgb_index + 1], GAMMA_CORRECTION_FACTOR);
-                hdr_data[current_rgb_index + 2] = pow(hdr_data[current_rgb_index + 2], GAMMA_CORRECTION_FACTOR);
-            }
-        }
+    /**
+     * Function that computes the factor separating the illumination of a pixel from the albedo of its surface. The
+     * channels with a negligible albedo, like the ones of the emitters, are left untouched
+     * @param albedo The albedo of the surface
+     */
+    static glm::vec3 computeDemodulation(const glm::vec3 & albedo) {
+        return glm::mix(albedo, glm::vec3(1.0f), glm::lessThan(albedo, glm::vec3(1e-3f)));
     }
 
     /**
-     * Function that applies tone mapping to the HDR data using a TMO curve
-     *
+     * Function that estimates how much the depth varies between adjacent pixels lying on the same surface, taking
+     * along each axis the smallest of the forward and backward differences so that the silhouettes do not inflate it
+     * @param x x coordinate of the pixel
+     * @param y y coordinate of the pixel
      */
-    void applyToneMapping(){
-        // Initializing the max luminance in the scene
-        float max_luminance = 0;
-        // Initializing the array of input luminance
-        std::vector<float> input_luminance(height * width);
-        // Initializing the array of output luminance
-        std::vector<float> output_luminance(height * width);
+    [[nodiscard]] float computeDepthGradient(const int x, const int y) const {
+        const float depth = features[y * width + x].depth;
+        float gradient = 0.0f;
+
+        // Horizontal variation
+        float horizontal = INFINITY;
+        if(x > 0)
+            horizontal = abs(depth - features[y * width + x - 1].depth);
+        if(x + 1 < width)
+            horizontal = min(horizontal, abs(features[y * width + x + 1].depth - depth));
+        if(horizontal < INFINITY)
+            gradient = horizontal;
+
+        // Vertical variation
+        float vertical = INFINITY;
+        if(y > 0)
+            vertical = abs(depth - features[(y - 1) * width + x].depth);
+        if(y + 1 < height)
+            vertical = min(vertical, abs(features[(y + 1) * width + x].depth - depth));
+        if(vertical < INFINITY)
+            gradient = max(gradient, vertical);
+
+        return gradient;
+    }
 
-        // Iterating our hdr_data to compute the input luminance
-        for(int h = 0; h < height; h++){
-            for(int w = 0; w < width; w++){
-                // Constants for luminance calculation
-                constexpr float RED_LUMINANCE_COEFF = 0.2125f;
-                constexpr float GREEN_LUMINANCE_COEFF = 0.7154f;
-                constexpr float BLUE_LUMINANCE_COEFF = 0.0721f;
-
-                // Current indexes
-                const int current_index = h * width + w;
-                const int current_rgb_index = 3 * current_index;
-
-                // Extracting the RGB values of the current pixel
-                const float current_red = hdr_data[current_rgb_index + 0];
-                const float current_green = hdr_data[current_rgb_index + 1];
-                const float current_blue = hdr_data[current_rgb_index + 2];
-                // Computing the current luminance
-                const float current_luminance = RED_LUMINANCE_COEFF * current_red
-                                                + GREEN_LUMINANCE_COEFF * current_green
-                                                + BLUE_LUMINANCE_COEFF * current_blue;
-                // Updating the maximum, if necessary
-                if(current_luminance > max_luminance)
-                    max_luminance = current_luminance;
-                // Saving the current luminance
-                input_luminance[current_index] = current_luminance;
+    /**
+     * Function that denoises the HDR data with an edge-avoiding a-trous wavelet filter guided by the features. The
+     * illumination is filtered apart from the albedo, so that the texture details stay sharp. Every iteration applies
+     * a 5x5 B3 spline kernel whose taps are twice as far apart as in the previous one, each tap being weighted down
+     * by the differences of normal, depth, albedo and illumination with the filtered pixel
+     * @param iterations The amount of iterations
+     */
+    void denoise(const int iterations) {
+        const int pixels_amount = width * height;
+        if(denoised_data == nullptr)
+            denoised_data = new float[3 * pixels_amount];
+
+        // Separating the illumination from the albedo, and estimating the depth gradients
+        vector<glm::vec3> illumination(pixels_amount);
+        vector<glm::vec3> filtered_illumination(pixels_amount);
+        vector<float> depth_gradients(pixels_amount);
+        #pragma omp parallel for schedule(static)
+        for(int y = 0; y < height; y++) {
+            for(int x = 0; x < width; x++) {
+                const int i = y * width + x;
+                illumination[i] = getHDRPixel(x, y) / computeDemodulation(features[i].albedo);
+                depth_gradients[i] = computeDepthGradient(x, y);
             }
         }
 
-        // Verifying that the max luminance is not zero (full black rendering)
-        if (max_luminance == 0.0f) {
-            std::cerr << "Max luminance in scene is zero, cannot apply tone mapping." << std::endl;
-            return;
-        }
-
-        switch (TONE_MAPPING_OPERATOR) {
-            case LINEAR : {
-                simpleTM(input_luminance, output_luminance,max_luminance);
-                break;
-            }
-            case POWER: {
-                powerTM(input_luminance, output_luminance, max_luminance);
-                break;
-            }
-            case LOGARITHMIC : {
-                logarithmicTM(input_luminance, output_luminance, max_luminance);
-                break;
-            }
-            case ACES: {
-                simplifiedACES(input_luminance, output_luminance, max_luminance);
-                break;
-            }
-            case EXTENDED_REINHARD :
-            default: {
-                extendedReinhardTM(input_luminance, output_luminance, max_luminance);
-                break;
+        // Filtering the illumination, until the taps fall outside of the image
+        constexpr float KERNEL[3] = { 3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f };
+        for(int iteration = 0; iteration < iterations && (1 << iteration) < max(width, height); iteration++) {
+            const int step = 1 << iteration;
+
+            // Narrowing the illumination tolerance, since every iteration leaves less noise
+            const float color_sigma = DENOISER_COLOR_SIGMA / static_cast<float>(step);
+            const float inverse_color_variance = 1.0f / (color_sigma * color_sigma);
+            constexpr float inverse_albedo_variance = 1.0f / (DENOISER_ALBEDO_SIGMA * DENOISER_ALBEDO_SIGMA);
+
+            #pragma omp parallel for schedule(static)
+            for(int y = 0; y < height; y++) {
+                for(int x = 0; x < width; x++) {
+                    const int i = y * width + x;
+                    const PixelFeatures & center = features[i];
+                    const glm::vec3 center_illumination = illumination[i];
+
+                    // The tolerance to the illumination differences grows with the brightness of the pixel
+                    const float color_scale = inverse_color_variance
+                        / (glm::dot(center_illumination, center_illumination) + 1e-4f);
+
+                    // Accumulating the weighted taps
+                    glm::vec3 sum(0.0f);
+                    float weights = 0.0f;
+                    for(int dy = -2; dy <= 2; dy++) {
+                        const int tap_y = y + dy * step;
+                        if(tap_y < 0 || tap_y >= height)
+                            continue;
+                        for(int dx = -2; dx <= 2; dx++) {
+                            const int tap_x = x + dx * step;
+                            if(tap_x < 0 || tap_x >= width)
+                                continue;
+                            const int j = tap_y * width + tap_x;
+                            const PixelFeatures & tap = features[j];
+
+                            // Weighting the tap by the normals, zero if either pixel sees no surface
+                            float weight = KERNEL[abs(dx)] * KERNEL[abs(dy)]
+                                * pow(max(0.0f, glm::dot(center.normal, tap.normal)), DENOISER_NORMAL_EXPONENT);
+                            if(weight == 0.0f)
+                                continue;
+
+                            // Weighting the tap by the depth, tolerating the variation expected over the distance
+                            const float tap_distance = static_cast<float>(step) * sqrt(static_cast<float>(
+                                dx * dx + dy * dy));
+                            weight *= exp(-abs(center.depth - tap.depth)
+                                / (DENOISER_DEPTH_SIGMA * depth_gradients[i] * tap_distance + 1e-4f));
+
+                            // Weighting the tap by the albedo and by the illumination
+                            weight *= exp(-glm::length2(center.albedo - tap.albedo) * inverse_albedo_variance
+                                - glm::length2(center_illumination - illumination[j]) * color_scale);
+
+                            sum += weight * illumination[j];
+                            weights += weight;
+                        }
+                    }
+
+                    // Keeping the pixels without any valid tap, like the ones seeing no surface
+                    filtered_illumination[i] = weights > 0.0f ? sum / weights : center_illumination;
+                }
             }
+
+            illumination.swap(filtered_illumination);
         }
-        // Invoking a selected curve to compute the tone mapping
-        simpleTM(input_luminance, output_luminance, max_luminance);
-
-        // Applying to each HDR pixel the ratio between their output luminance and input luminance
-        for(int h = 0; h < height; h++) {
-            for(int w = 0; w < width; w++) {
-                // Current indexes
-                const int current_index = h * width + w;
-                const int current_rgb_index = 3 * current_index;
-
-                // Computing the TMO coefficient obtained by the selected curve
-                const float current_input_luminance = input_luminance[current_index];
-                const float current_output_luminance = output_luminance[current_index];
-                const float TMO_coefficient = current_output_luminance / (current_input_luminance + 1e-6f);
-
-                // Apply the TMO to the pixel
-                const float current_red_value = hdr_data[current_rgb_index + 0];
-                hdr_data[current_rgb_index + 0] *= min(1.0f, TMO_coefficient * current_red_value);
-                const float current_green_value = hdr_data[current_rgb_index + 1];
-                hdr_data[current_rgb_index + 1] *= min(1.0f, TMO_coefficient * current_green_value);
-                const float current_blue_value = hdr_data[current_rgb_index + 2];
-                hdr_data[current_rgb_index + 2] *= min(1.0f, TMO_coefficient * current_blue_value);
-            }
+
+        // Applying the albedo back to the filtered illumination
+        #pragma omp parallel for schedule(static)
+        for(int i = 0; i < pixels_amount; i++) {
+            const glm::vec3 color = illumination[i] * computeDemodulation(features[i].albedo);
+            denoised_data[3 * i + 0] = color.r;
+            denoised_data[3 * i + 1] = color.g;
+            denoised_data[3 * i + 2] = color.b;
         }
     }
     
@@ -295,12 +410,52 @@ public:
         // Initializing the HDR data
         hdr_data = new float[3 * width * height];
     }
+
+    Image(const Image &) = delete;
+    Image & operator=(const Image &) = delete;
+
+    ~Image() {
+        delete[] hdr_data;
+        delete[] ldr_data;
+        delete[] features;
+        delete[] denoised_data;
+    }
+
+    /**
+     * Function that reuses the image for a new rendering, reallocating the data only if the resolution changed
+     * @param name Name of the image
+     * @param width Width of the image
+     * @param height Height of the image
+     */
+    void reset(string name, const int width, const int height) {
+        this->name = std::move(name);
+
+        // Keeping the buffers in case the amount of pixels is unchanged
+        if(width * height == this->width * this->height) {
+            this->width = width;
+            this->height = height;
+            return;
+        }
+
+        // Reallocating the HDR data, the 8 bit data and the features being allocated when next requested
+        delete[] hdr_data;
+        delete[] ldr_data;
+        delete[] features;
+        delete[] denoised_data;
+        this->width = width;
+        this->height = height;
+        hdr_data = new float[3 * width * height];
+        ldr_data = nullptr;
+        features = nullptr;
+        denoised_data = nullptr;
+    }
     
     /**
      Writes and image to a file in ppm format
      @param path the path where to the target image
+     @return True if the image was written, false otherwise
      */
-    void writeImage(const string & path) const {
+    bool writeImage(const string & path) const {
         // Opening the file
         ofstream file;
         file.open(path, ofstream::out);
@@ -308,7 +463,7 @@ public:
         // Printing an error if the file was not opened correctly
         if (!file.is_open()) {
             std::cerr << "Error opening file: " << path << std::endl;
-            return;
+            return false;
         }
 
         file << "P3" << endl;
@@ -323,9 +478,12 @@ public:
                 int current_rgb_index = 3 * (h * width + w);
 
                 // Computing the values of each channel with range from 0 to MAX_PPM_VALUE
-                unsigned int red_value   = MAX_PPM_VALUE * hdr_data[current_rgb_index + 0];
-                unsigned int green_value = MAX_PPM_VALUE * hdr_data[current_rgb_index + 1];
-                unsigned int blue_value  = MAX_PPM_VALUE * hdr_data[current_rgb_index + 2];
+                const unsigned int red_value   = ldr_data ? ldr_data[current_rgb_index + 0] :
+                                                     encodeLinear(hdr_data[current_rgb_index + 0]);
+                const unsigned int green_value = ldr_data ? ldr_data[current_rgb_index + 1] :
+                                                     encodeLinear(hdr_data[current_rgb_index + 1]);
+                const unsigned int blue_value  = ldr_data ? ldr_data[current_rgb_index + 2] :
+                                                     encodeLinear(hdr_data[current_rgb_index + 2]);
 
                 // Inserting the values in the files
                 file << red_value << " " << green_value << " " << blue_value << " ";
@@ -333,20 +491,68 @@ public:
             file<<endl;
         }
         file.close();
+
+        // Printing an error if the image was not written completely
+        if(file.fail()) {
+            std::cerr << "Error writing file: " << path << std::endl;
+            return false;
+        }
+
+        return true;
     }
 
     /**
-    * Function that applies the post-processing pipeline to the current HDR values
+    * Function that applies the post-processing pipeline to the current HDR values, producing the 8 bit data
+    * @param configuration The configuration selecting the post-processing stages
     */
-    void applyPostProcessing() {
-        // Post-processing pipeline
-        if(USE_TONE_MAPPING)
-            applyToneMapping();
+    void applyPostProcessing(const RenderConfiguration & configuration = render_configuration) {
+        // Allocating the 8 bit data once, reused by later invocations
+        if(ldr_data == nullptr)
+            ldr_data = new unsigned char[3 * width * height];
+
+        // Denoising the HDR data, provided that the renderer wrote the features guiding the denoiser
+        const float * source = hdr_data;
+        if(configuration.use_denoiser && features) {
+            const ProfilerScope profiler_scope("denoise the image", "post", PRINT_POST_PROCESSING_EXECUTION_TIME);
+            denoise(configuration.denoiser_iterations);
+            source = denoised_data;
+        }
 
-        applyRGBClamping();
+        // Computing the max luminance in the scene
+        float max_luminance = 0;
+        if(configuration.use_tone_mapping) {
+            max_luminance = computeMaxLuminance(source);
+
+            // Verifying that the max luminance is not zero (full black rendering)
+            if (max_luminance == 0.0f)
+                std::cerr << "Max luminance in scene is zero, cannot apply tone mapping." << std::endl;
+        }
 
-        if(USE_GAMMA_CORRECTION)
-            applyGammaCorrection();
+        // Invoking the pipeline specialized on the selected curve
+        const bool use_gamma_correction = configuration.use_gamma_correction;
+        switch (configuration.tone_mapping_operator) {
+            case LINEAR : {
+                postProcess<LINEAR>(source, max_luminance, use_gamma_correction);
+                break;
+            }
+            case POWER: {
+                postProcess<POWER>(source, max_luminance, use_gamma_correction);
+                break;
+            }
+            case LOGARITHMIC : {
+                postProcess<LOGARITHMIC>(source, max_luminance, use_gamma_correction);
+                break;
+            }
+            case ACES: {
+                postProcess<ACES>(source, max_luminance, use_gamma_correction);
+                break;
+            }
+            case EXTENDED_REINHARD :
+            default: {
+                postProcess<EXTENDED_REINHARD>(source, max_luminance, use_gamma_correction);
+                break;
+            }
+        }
     }
 
     /**
@@ -366,9 +572,64 @@ public:
         hdr_data[current_rgb_index + 2] = color.b;
     }
 
+    /**
+     Get the value of one pixel
+     @param x x coordinate of the pixel - index of the column counting from left to right
+     @param y y coordinate of the pixel - index of the row counting from top to bottom
+     @return color of the pixel expressed as vec3 of RGB values
+     */
+    [[nodiscard]] glm::vec3 getHDRPixel(const int x, const int y) const {
+        const unsigned int current_rgb_index = 3 * (y * width + x);
+        return {hdr_data[current_rgb_index + 0], hdr_data[current_rgb_index + 1], hdr_data[current_rgb_index + 2]};
+    }
+
+    /**
+     * Function that allocates the features guiding the denoiser, to be written along with the pixels
+     */
+    void enableFeatures() {
+        if(features == nullptr)
+            features = new PixelFeatures[width * height];
+    }
+
+    /**
+     * Checks weather the features guiding the denoiser are allocated
+     * @return True if the features are written along with the pixels
+     */
+    [[nodiscard]] bool hasFeatures() const {
+        return features != nullptr;
+    }
+
+    /**
+     Set the features of one pixel
+     @param x x coordinate of the pixel - index of the column counting from left to right
+     @param y y coordinate of the pixel - index of the row counting from top to bottom
+     @param pixel_features The features of the surface seen through the pixel
+     */
+    void setPixelFeatures(const int x, const int y, const PixelFeatures & pixel_features) const {
+        features[y * width + x] = pixel_features;
+    }
+
+    /**
+     Get the features of one pixel
+     @param x x coordinate of the pixel - index of the column counting from left to right
+     @param y y coordinate of the pixel - index of the row counting from top to bottom
+     @return The features of the surface seen through the pixel
+     */
+    [[nodiscard]] const PixelFeatures & getPixelFeatures(const int x, const int y) const {
+        return features[y * width + x];
+    }
+
     string getName() {
         return this->name;
     }
+
+    [[nodiscard]] int getWidth() const {
+        return width;
+    }
+
+    [[nodiscard]] int getHeight() const {
+        return height;
+    }
 };
 
 #endif
@@ -43,6 +43,13 @@ public:
     // VOLUMETRIC
     float density = 0.0f; ///< Material density, used in the computation for volumetric rendering
 
+    /**
+    * Verifies if the diffuse depends on the surface point, and is therefore worth baking
+    */
+    [[nodiscard]] virtual bool isProcedural() const {
+        return false;
+    }
+
     /**
     * Getter for the material diffuse at the given surface point
     * @param surface_point  The surface point
@@ -59,6 +66,13 @@ public:
         return this->specular;
     }
 
+    /**
+    * Computes the intensity of the surface at the given interaction
+    * @tparam FEATURES The render_feature flags the kernel is specialized on
+    * @param interaction The interaction with the surface
+    * @param ray The ray that generated the interaction
+    */
+    template <unsigned int FEATURES>
     [[nodiscard]] glm::vec3 computeSurfaceIntensity (const Interaction & interaction, const Ray & ray) const {
         // Different behaviour based on the type
         switch(type) {
@@ -66,7 +80,7 @@ public:
             default :
             case VOLUMETRIC:
             case SOLID : {
-                return CookTorrance(interaction, ray);
+                return CookTorrance<FEATURES>(interaction, ray);
             }
         }
     }
@@ -0,0 +1,498 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef RENDER_CONFIGURATION_H
+#define RENDER_CONFIGURATION_H
+
+/**
+* Runtime configuration of the renderer. Every option defaults to the corresponding constant in Settings.h and can be
+* overridden by a configuration file or by the command line, without recompiling.
+*/
+struct RenderConfiguration {
+    // RAY TRACING
+    bool use_antialiasing = USE_ANTIALIASING; ///< Flag indicating weather or not use antialiasing
+    int antialiasing_subdivisions = static_cast<int>(ANTIALIASING_SUBDIVISIONS_AMOUNT); ///< Subdivisions per pixel side
+    bool use_fresnel = USE_FRESNEL; ///< Flag indicating weather or not use the Fresnel effect
+
+    // POST PROCESSING
+    bool use_gamma_correction = USE_GAMMA_CORRECTION; ///< Flag indicating weather or not apply gamma correction
+    bool use_tone_mapping = USE_TONE_MAPPING; ///< Flag indicating weather or not apply tone mapping
+    TMO tone_mapping_operator = TONE_MAPPING_OPERATOR; ///< The TMO curve used by the tone mapping
+    bool use_denoiser = USE_DENOISER; ///< Flag indicating weather or not denoise the images, guided by their features
+    int denoiser_iterations = DENOISER_ITERATIONS; ///< Iterations of the denoiser, doubling the filter footprint
+
+    // PHOTON MAPPING
+    bool use_photon_mapping = USE_PHOTON_MAPPING; ///< Flag indicating weather or not use photon mapping
+    bool use_indirect_lighting = USE_INDIRECT_LIGHTING; ///< Flag indicating weather or not use indirect lighting
+    bool use_caustic = USE_CAUSTIC; ///< Flag indicating weather or not use caustics
+
+    // CAMERA
+    bool use_depth_of_field = USE_DEPTH_OF_FIELD; ///< Flag indicating weather or not use depth of field
+    int depth_of_field_samples = DEPTH_OF_FIELD_SAMPLES_AMOUNT; ///< Amount of lens samples per ray
+
+    // MATERIALS
+    procedural_bake procedural_bake_mode = PROCEDURAL_BAKE; ///< How the procedural materials are baked
+    int procedural_bake_resolution = PROCEDURAL_BAKE_RESOLUTION; ///< Samples along the longest axis of a bake
+
+    // SDS
+    SDS sds_type = SDS_TYPE; ///< The SDS accelerating the ray intersections
+    int bricks_cache_size = BRICKS_CACHE_SIZE_MB; ///< Megabytes of bricks kept in memory by the bricked SDS
+    string bricks_directory; ///< Directory of the bricks file, empty to use the temporary directory
+
+    // BVH
+    split_method bvh_split_method = SPLIT_METHOD; ///< The strategy used to split the nodes of the BVH
+    bvh_node_layout bvh_layout = BVH_NODE_LAYOUT; ///< The layout of the linear nodes of the BVH
+    bool use_treelet_optimization = USE_TREELET_OPTIMIZATION; ///< Flag indicating weather or not optimize the BVH
+    bool use_quantized_bvh = USE_QUANTIZED_BVH; ///< Flag indicating weather or not traverse 4-wide quantized nodes
+
+    // SCENE
+    string scene_path; ///< Path of the scene file to render, empty to render the compiled-in default scene
+
+    // DISTRIBUTED RENDERING
+    int workers_amount = DISTRIBUTED_WORKERS_AMOUNT; ///< Amount of local worker processes spawned by the coordinator
+    int coordinator_port = DISTRIBUTED_COORDINATOR_PORT; ///< Port accepting the workers, 0 to pick a free one
+    string coordinator_address; ///< Address accepting the workers, empty to accept only the local ones
+    string distributed_token; ///< Secret the workers send to the coordinator, required to accept remote workers
+    string worker_address; ///< Address "host:port" of the coordinator, turning the process into a worker
+
+    // RENDER SERVER
+    string server_path; ///< Path of the local socket accepting render jobs, turning the process into a server
+
+    // CHECKPOINTS
+    string checkpoint_directory; ///< Directory receiving the checkpoints of the images, empty to disable them
+    bool resume_from_checkpoint = false; ///< Flag indicating weather or not resume from the stored checkpoints
+    int checkpoint_interval = CHECKPOINT_INTERVAL_SECONDS; ///< Seconds between two checkpoints of an image
+
+    // STATISTICS
+    string statistics_path; ///< Path of the JSON file receiving the render statistics, empty to disable it
+    string trace_path; ///< Path of the JSON file receiving the profiler timeline, empty to disable it
+
+    /**
+    * Checks weather the tiles are distributed to worker processes
+    * @return True if this process coordinates a distributed render
+    */
+    [[nodiscard]] bool isCoordinator() const {
+        return worker_address.empty() && (workers_amount > 0 || coordinator_port > 0);
+    }
+
+    /**
+    * Computes the set of render features enabled by this configuration, used to select the specialized kernel
+    * @return A bit mask of render_feature flags
+    */
+    [[nodiscard]] unsigned int getRenderFeatures() const {
+        // Initializing the features mask
+        unsigned int features = 0;
+
+        // Camera features
+        if(use_antialiasing)
+            features |= ANTIALIASING_FEATURE;
+        if(use_depth_of_field)
+            features |= DEPTH_OF_FIELD_FEATURE;
+
+        // Tracing features
+        if(use_fresnel)
+            features |= FRESNEL_FEATURE;
+
+        // Photon mapping features
+        if(use_photon_mapping && use_indirect_lighting)
+            features |= INDIRECT_LIGHTING_FEATURE;
+        if(use_photon_mapping && use_caustic)
+            features |= CAUSTIC_FEATURE;
+
+        return features;
+    }
+
+    /**
+    * Parses a boolean option value
+    * @param value The value to parse (true/false, on/off, yes/no, 1/0)
+    * @param result The parsed boolean
+    * @return True if the value was a valid boolean, false otherwise
+    */
+    static bool parseBoolean(const string & value, bool & result) {
+        if(value == "true" || value == "on" || value == "yes" || value == "1") {
+            result = true;
+            return true;
+        }
+        if(value == "false" || value == "off" || value == "no" || value == "0") {
+            result = false;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+    * Parses a TMO name
+    * @param value The name of the TMO (extended_reinhard, aces, logarithmic, power, linear)
+    * @param result The parsed TMO
+    * @return True if the value was a valid TMO name, false otherwise
+    */
+    static bool parseTMO(const string & value, TMO & result) {
+        // Table of the supported curves
+        static const map<string, TMO> operators {
+            {"extended_reinhard", EXTENDED_REINHARD},
+            {"aces", ACES},
+            {"logarithmic", LOGARITHMIC},
+            {"power", POWER},
+            {"linear", LINEAR}
+        };
+
+        // Looking for the operator
+        const auto entry = operators.find(value);
+        if(entry == operators.end())
+            return false;
+
+        result = entry->second;
+        return true;
+    }
+
+    /**
+    * Parses a procedural bake mode
+    * @param value The name of the mode (off, eager, lazy)
+    * @param result The parsed mode
+    * @return True if the value was a valid mode, false otherwise
+    */
+    static bool parseProceduralBake(const string & value, procedural_bake & result) {
+        // Table of the supported modes
+        static const map<string, procedural_bake> modes {
+            {"off", NO_BAKE},
+            {"eager", EAGER_BAKE},
+            {"lazy", LAZY_BAKE}
+        };
+
+        // Looking for the mode
+        const auto entry = modes.find(value);
+        if(entry == modes.end())
+            return false;
+
+        result = entry->second;
+        return true;
+    }
+
+    /**
+    * Parses an SDS
+    * @param value The name of the SDS (none, bvh, kd_tree, grid, bricks)
+    * @param result The parsed SDS
+    * @return True if the value was a valid SDS, false otherwise
+    */
+    static bool parseSDS(const string & value, SDS & result) {
+        // Table of the supported SDS
+        static const map<string, SDS> structures {
+            {"none", NO_SDS},
+            {"bvh", BVH_SDS},
+            {"kd_tree", KD_TREE_SDS},
+            {"grid", GRID_SDS},
+            {"bricks", BRICKED_SDS}
+        };
+
+        // Looking for the SDS
+        const auto entry = structures.find(value);
+        if(entry == structures.end())
+            return false;
+
+        result = entry->second;
+        return true;
+    }
+
+    /**
+    * Parses a BVH split method
+    * @param value The name of the method (sah, middle, equal_counts, sbvh, lbvh)
+    * @param result The parsed method
+    * @return True if the value was a valid method, false otherwise
+    */
+    static bool parseSplitMethod(const string & value, split_method & result) {
+        // Table of the supported methods
+        static const map<string, split_method> methods {
+            {"sah", SAH},
+            {"middle", MIDDLE},
+            {"equal_counts", EQUAL_COUNTS},
+            {"sbvh", SBVH},
+            {"lbvh", LBVH}
+        };
+
+        // Looking for the method
+        const auto entry = methods.find(value);
+        if(entry == methods.end())
+            return false;
+
+        result = entry->second;
+        return true;
+    }
+
+    /**
+    * Parses a BVH node layout
+    * @param value The name of the layout (depth_first, van_emde_boas, page_clusters, measured)
+    * @param result The parsed layout
+    * @return True if the value was a valid layout, false otherwise
+    */
+    static bool parseBVHLayout(const string & value, bvh_node_layout & result) {
+        // Table of the supported layouts
+        static const map<string, bvh_node_layout> layouts {
+            {"depth_first", DEPTH_FIRST_LAYOUT},
+            {"van_emde_boas", VAN_EMDE_BOAS_LAYOUT},
+            {"page_clusters", PAGE_CLUSTERS_LAYOUT},
+            {"measured", MEASURED_LAYOUT}
+        };
+
+        // Looking for the layout
+        const auto entry = layouts.find(value);
+        if(entry == layouts.end())
+            return false;
+
+        result = entry->second;
+        return true;
+    }
+
+    /**
+    * Removes the blanks surrounding a string
+    * @param text The string to trim
+    * @return The string without leading and trailing blanks
+    */
+    static string trimBlanks(const string & text) {
+        const size_t first = text.find_first_not_of(" \t\r\n");
+        if(first == string::npos)
+            return "";
+        return text.substr(first, text.find_last_not_of(" \t\r\n") - first + 1);
+    }
+
+    /**
+    * Parses an integer option value, rejecting the values followed by other characters
+    * @param value The value to parse
+    * @param result The parsed integer
+    * @return True if the whole value was a valid integer, false otherwise
+    */
+    static bool parseInteger(const string & value, int & result) {
+        istringstream value_stream(value);
+        return value_stream >> result && (value_stream >> ws).eof();
+    }
+
+    /**
+    * Sets a single option
+    * @param key The name of the option
+    * @param value The value of the option
+    * @return True if the option was recognized and its value valid, false otherwise
+    */
+    bool setOption(const string & key, const string & value) {
+        // Non negative integer options
+        if(key == "workers" || key == "coordinator_port") {
+            // Parsing the value
+            int parsed_value;
+            if(!parseInteger(value, parsed_value) || parsed_value < 0 ||
+                (key == "coordinator_port" && parsed_value > 65535))
+                return false;
+
+            // Assigning the value
+            if(key == "workers")
+                workers_amount = parsed_value;
+            else
+                coordinator_port = parsed_value;
+            return true;
+        }
+
+        // Integer options
+        if(key == "antialiasing_subdivisions" || key == "depth_of_field_samples" ||
+            key == "procedural_bake_resolution" || key == "bricks_cache_size" || key == "checkpoint_interval" ||
+            key == "denoiser_iterations") {
+            // Parsing the value
+            int parsed_value;
+            if(!parseInteger(value, parsed_value) || parsed_value < 1)
+                return false;
+
+            // Assigning the value
+            if(key == "antialiasing_subdivisions")
+                antialiasing_subdivisions = parsed_value;
+            else if(key == "depth_of_field_samples")
+                depth_of_field_samples = parsed_value;
+            else if(key == "procedural_bake_resolution")
+                procedural_bake_resolution = parsed_value;
+            else if(key == "bricks_cache_size")
+                bricks_cache_size = parsed_value;
+            else if(key == "denoiser_iterations")
+                denoiser_iterations = parsed_value;
+            else
+                checkpoint_interval = parsed_value;
+            return true;
+        }
+
+        // Path options
+        if(key == "scene_path") {
+            scene_path = value;
+            return true;
+        }
+        if(key == "statistics_path") {
+            statistics_path = value;
+            return true;
+        }
+        if(key == "trace_path") {
+            trace_path = value;
+            return true;
+        }
+        if(key == "bricks_directory") {
+            bricks_directory = value;
+            return true;
+        }
+        if(key == "checkpoint_directory") {
+            checkpoint_directory = value;
+            return true;
+        }
+        if(key == "resume") {
+            // Resuming from the checkpoints of the directory, which keeps receiving them
+            checkpoint_directory = value;
+            resume_from_checkpoint = true;
+            return true;
+        }
+        if(key == "server") {
+            server_path = value;
+            return true;
+        }
+        if(key == "worker") {
+            worker_address = value;
+            return true;
+        }
+        if(key == "coordinator_address") {
+            coordinator_address = value;
+            return true;
+        }
+        if(key == "distributed_token") {
+            distributed_token = value;
+            return true;
+        }
+
+        // TMO option
+        if(key == "tone_mapping_operator")
+            return parseTMO(value, tone_mapping_operator);
+
+        // Procedural bake option
+        if(key == "procedural_bake")
+            return parseProceduralBake(value, procedural_bake_mode);
+
+        // SDS option
+        if(key == "sds")
+            return parseSDS(value, sds_type);
+
+        // BVH split method option
+        if(key == "split_method")
+            return parseSplitMethod(value, bvh_split_method);
+
+        // BVH node layout option
+        if(key == "bvh_layout")
+            return parseBVHLayout(value, bvh_layout);
+
+        // Boolean options
+        static const map<string, bool RenderConfiguration::*> boolean_options {
+            {"antialiasing", & RenderConfiguration::use_antialiasing},
+            {"fresnel", & RenderConfiguration::use_fresnel},
+            {"gamma_correction", & RenderConfiguration::use_gamma_correction},
+            {"tone_mapping", & RenderConfiguration::use_tone_mapping},
+            {"denoiser", & RenderConfiguration::use_denoiser},
+            {"photon_mapping", & RenderConfiguration::use_photon_mapping},
+            {"indirect_lighting", & RenderConfiguration::use_indirect_lighting},
+            {"caustic", & RenderConfiguration::use_caustic},
+            {"depth_of_field", & RenderConfiguration::use_depth_of_field},
+            {"treelet_optimization", & RenderConfiguration::use_treelet_optimization},
+            {"quantized_bvh", & RenderConfiguration::use_quantized_bvh}
+        };
+
+        // Looking for the option
+        const auto entry = boolean_options.find(key);
+        if(entry == boolean_options.end())
+            return false;
+
+        return parseBoolean(value, this->*(entry->second));
+    }
+
+    /**
+    * Reads the options from a configuration file. Each line has format "key = value", "#" starts a comment. The value
+    * spans the rest of the line, blanks and "=" included, only its surrounding blanks being removed
+    * @param path The path of the configuration file
+    * @param report_errors Flag indicating weather or not report the invalid options, false when reading them again
+    * @return True if the file was read, false otherwise
+    */
+    bool readFile(const string & path, const bool report_errors = true) {
+        // Opening the file
+        ifstream file(path);
+
+        // Verifying that the file opened correctly
+        if(!file.is_open()) {
+            if(report_errors)
+                PrintError("Error while opening configuration file " + path);
+            return false;
+        }
+
+        // Reading the file line by line
+        string line;
+        while(getline(file, line)) {
+            // Removing the comments, skipping the blank lines
+            line = trimBlanks(line.substr(0, line.find('#')));
+            if(line.empty())
+                continue;
+
+            // Splitting key and value at the first assignment
+            const size_t separator = line.find('=');
+            if(separator == string::npos) {
+                if(report_errors)
+                    PrintError("Missing value in " + path + ": " + line);
+                continue;
+            }
+            const string key = trimBlanks(line.substr(0, separator));
+            const string value = trimBlanks(line.substr(separator + 1));
+
+            // Applying the option
+            if(!setOption(key, value) && report_errors)
+                PrintError("Invalid option in " + path + ": " + key + " = " + value);
+        }
+
+        return true;
+    }
+
+    /**
+    * Parses the command line. Options have format "--key=value", "--config=path" reads a configuration file.
+    * Arguments not starting with "--" are left to the caller
+    * @param argc Counter of input arguments
+    * @param argv Array of pointers to the arguments
+    * @param report_errors Flag indicating weather or not report the invalid options, false when parsing them again
+    * @param caller_options Keys of the options parsed by the caller, not reported as invalid
+    */
+    void parseCommandLine(const int argc, const char * argv[], const bool report_errors = true,
+        const vector<string> & caller_options = {}) {
+        for(int i = 1; i < argc; i++) {
+            // Extracting the current argument
+            const string argument = argv[i];
+
+            // Skipping arguments that are not options
+            if(argument.rfind("--", 0) != 0)
+                continue;
+
+            // Splitting key and value at the first assignment, reporting the options without a value
+            const size_t separator = argument.find('=');
+            if(separator == string::npos) {
+                if(report_errors)
+                    PrintError("Missing value on the command line: " + argument);
+                continue;
+            }
+            string key = argument.substr(2, separator - 2);
+            const string value = argument.substr(separator + 1);
+
+            // Accepting dashes in place of underscores
+            replace(key.begin(), key.end(), '-', '_');
+
+            // Reading the configuration file
+            if(key == "config") {
+                readFile(value, report_errors);
+                continue;
+            }
+
+            // Leaving the options of the caller to it
+            if(find(caller_options.begin(), caller_options.end(), key) != caller_options.end())
+                continue;
+
+            // Applying the option
+            if(!setOption(key, value) && report_errors)
+                PrintError("Invalid option on the command line: " + argument);
+        }
+    }
+};
+
+inline RenderConfiguration render_configuration; ///< The configuration currently used by the renderer
+
+#endif //RENDER_CONFIGURATION_H
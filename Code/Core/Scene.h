@@ -15,7 +15,7 @@ inline vector<Photon> caustic_photons; ///< A list of photons used for caustics
 inline vector<Plane *> planes; ///< A lost of all the planes in the scene
 inline vector<Camera *> cameras; ///< A list of all the cameras capturing the scene
 
-inline BVH * bvh;
+inline AccelerationStructure * sds; ///< The SDS accelerating the ray intersections
 inline KDTreeNode * indirect_photons_root;
 inline KDTreeNode * caustic_photons_root;
 
@@ -0,0 +1,231 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef RENDER_SERVER_H
+#define RENDER_SERVER_H
+
+/**
+* Payload of a render job, followed by the path of the output image. The messages use the framing of the distributed
+* render protocol, in the native byte order
+*/
+struct RenderJob {
+    float camera_transform[16]; ///< Transform of the camera capturing the image, in column major order
+    int32_t width; ///< Width of the image
+    int32_t height; ///< Height of the image
+    float fov; ///< Field of view of the camera
+    float focal_distance; ///< Focal distance of the camera, used by depth of field
+    float aperture; ///< Aperture of the camera, used by depth of field
+    int32_t antialiasing_subdivisions; ///< Subdivisions per pixel side, below 2 to disable antialiasing
+    int32_t depth_of_field_samples; ///< Lens samples per ray, below 1 to disable depth of field
+};
+
+/**
+* Header of the payload of a streamed tile, followed by the RGB values of the tile pixels in row major order
+*/
+struct JobTileHeader {
+    RenderTile tile; ///< The pixels of the image covered by the tile
+};
+
+// Largest side of the image of a render job
+constexpr int32_t RENDER_JOB_MAX_RESOLUTION = 1 << 14;
+
+/**
+* Function that opens the local socket accepting the render jobs, replacing a stale socket file
+* @param path The path of the socket
+* @return The listening socket, -1 if it could not be opened
+*/
+inline int openServerSocket(const string & path) {
+    // Verifying that the path fits the socket address
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if(path.size() >= sizeof(address.sun_path))
+        return -1;
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    // Binding the socket, after removing the file left by a previous server
+    const int listening_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listening_socket < 0)
+        return -1;
+    unlink(path.c_str());
+    if(bind(listening_socket, reinterpret_cast<const sockaddr *>(& address), sizeof(sockaddr_un)) != 0
+        || listen(listening_socket, SOMAXCONN) != 0) {
+        close(listening_socket);
+        return -1;
+    }
+
+    return listening_socket;
+}
+
+/**
+* Function that renders a job on the resident scene, streaming its tiles to the client as they are rendered
+* @param client The socket of the client
+* @param job The job to render
+* @param output_path The path of the output image
+* @return The error that made the job fail, empty if the job succeeded
+*/
+inline string renderJob(const int client, const RenderJob & job, const string & output_path) {
+    // Verifying the job
+    if(job.width < 1 || job.height < 1 || job.width > RENDER_JOB_MAX_RESOLUTION
+        || job.height > RENDER_JOB_MAX_RESOLUTION)
+        return "Invalid resolution";
+    if(!(job.fov > 0.0f && job.fov < 180.0f))
+        return "Invalid field of view";
+    const filesystem::path output_directory = filesystem::path(output_path).parent_path();
+    if(output_path.empty() || (!output_directory.empty() && !filesystem::is_directory(output_directory)))
+        return "Invalid output path";
+
+    // Configuring the samples of the job, the kernels reading them from the global configuration
+    const RenderConfiguration server_configuration = render_configuration;
+    render_configuration.use_antialiasing = job.antialiasing_subdivisions > 1;
+    if(render_configuration.use_antialiasing)
+        render_configuration.antialiasing_subdivisions = job.antialiasing_subdivisions;
+    render_configuration.use_depth_of_field = job.depth_of_field_samples > 0;
+    if(render_configuration.use_depth_of_field)
+        render_configuration.depth_of_field_samples = job.depth_of_field_samples;
+    render_configuration.checkpoint_directory.clear();
+
+    // Creating the camera of the job
+    glm::mat4 transform;
+    memcpy(& transform, job.camera_transform, sizeof(job.camera_transform));
+    const Camera camera(transform, filesystem::path(output_path).stem().string(), glm::vec2(job.width, job.height),
+        job.fov, job.focal_distance, job.aperture);
+    Image image(camera.getName(), job.width, job.height);
+
+    // Streaming the tiles from a dedicated thread, so that a slow client does not stall the rendering threads
+    mutex queue_mutex;
+    condition_variable queue_condition;
+    deque<vector<char>> queued_messages;
+    bool is_render_done = false;
+    thread sender([&] {
+        bool client_connected = true;
+        unique_lock lock(queue_mutex);
+        while(true) {
+            queue_condition.wait(lock, [&] { return !queued_messages.empty() || is_render_done; });
+            if(queued_messages.empty())
+                return;
+            const vector<char> message = std::move(queued_messages.front());
+            queued_messages.pop_front();
+            lock.unlock();
+
+            // Sending the tile, the render completing anyway if the client disconnected
+            if(client_connected)
+                client_connected = sendTileMessage(client, JOB_TILE_MESSAGE, message.data(), message.size());
+            lock.lock();
+        }
+    });
+
+    // Rendering the image, queuing each tile once its pixels are final
+    const RenderKernel render_kernel = selectRenderKernel(render_configuration);
+    const uint64_t samples_seed = SampleGenerator::computeImageSeed(0, 0);
+    renderImage(render_kernel, & camera, & image, samples_seed, [&](const RenderTile & tile) {
+        // Gathering the pixels of the tile
+        const JobTileHeader header { .tile = tile };
+        vector<char> message(sizeof(JobTileHeader)
+            + 3 * sizeof(float) * (tile.x_end - tile.x_start) * (tile.y_end - tile.y_start));
+        memcpy(message.data(), & header, sizeof(JobTileHeader));
+        auto pixels = reinterpret_cast<float *>(message.data() + sizeof(JobTileHeader));
+        for(int y = tile.y_start; y < tile.y_end; y++) {
+            for(int x = tile.x_start; x < tile.x_end; x++) {
+                const glm::vec3 color = image.getHDRPixel(x, y);
+                * pixels++ = color.r;
+                * pixels++ = color.g;
+                * pixels++ = color.b;
+            }
+        }
+
+        // Queuing the tile
+        {
+            lock_guard lock(queue_mutex);
+            queued_messages.push_back(std::move(message));
+        }
+        queue_condition.notify_one();
+    });
+    render_configuration = server_configuration;
+
+    // Waiting for the queued tiles to be sent
+    {
+        lock_guard lock(queue_mutex);
+        is_render_done = true;
+    }
+    queue_condition.notify_one();
+    sender.join();
+
+    // Writing the image
+    image.applyPostProcessing(render_configuration);
+    if(!image.writeImage(output_path))
+        return "Cannot write the image";
+
+    return "";
+}
+
+/**
+* Runs the process as a render server. The scene is prepared once and kept resident along with its SDS, textures and
+* photon maps, then the jobs received over a local socket are rendered one at a time, so that each new viewpoint only
+* pays for the tracing. Each job is answered by its tiles as they are rendered, followed by a completion message
+* @param path The path of the local socket
+* @param argc Counter of the command line arguments
+* @param argv The command line arguments
+* @param prepare_scene Function preparing the scene of a frame, given its number and the command line
+* @return The exit code of the process
+*/
+inline int runRenderServer(const string & path, const int argc, const char * argv[],
+    const function<void (int, int, const char * [])> & prepare_scene) {
+    // Ignoring the signals raised by writing to a client that disconnected
+    signal(SIGPIPE, SIG_IGN);
+
+    // Opening the socket
+    const int listening_socket = openServerSocket(path);
+    if(listening_socket < 0) {
+        PrintError("Cannot open the render server socket " + path);
+        return EXIT_FAILURE;
+    }
+
+    // Preparing the resident scene
+    prepare_scene(0, argc, argv);
+    cout << "Render server listening on " << path << endl;
+
+    // Serving the clients one at a time, until one of them shuts the server down
+    bool running = true;
+    while(running) {
+        const int client = accept(listening_socket, nullptr, nullptr);
+        if(client < 0) {
+            if(errno == EINTR)
+                continue;
+            PrintError("Cannot accept a render server client");
+            break;
+        }
+
+        // Rendering the jobs of the client until it disconnects
+        tile_message type;
+        vector<char> payload;
+        while(receiveTileMessage(client, type, payload)) {
+            if(type == SHUTDOWN_MESSAGE) {
+                running = false;
+                break;
+            }
+
+            // Rendering the job, rejecting the malformed ones
+            string error = "Invalid message";
+            if(type == RENDER_JOB_MESSAGE && payload.size() >= sizeof(RenderJob)) {
+                RenderJob job {};
+                memcpy(& job, payload.data(), sizeof(RenderJob));
+                const ProfilerScope profiler_scope("render job", "render", PRINT_RAYTRACING_EXECUTION_TIME);
+                error = renderJob(client, job, string(payload.begin() + sizeof(RenderJob), payload.end()));
+            }
+
+            if(!sendTileMessage(client, JOB_DONE_MESSAGE, error.data(), error.size()))
+                break;
+        }
+        close(client);
+    }
+
+    // Releasing the scene and the socket
+    ResetScene();
+    close(listening_socket);
+    unlink(path.c_str());
+
+    return EXIT_SUCCESS;
+}
+
+#endif //RENDER_SERVER_H
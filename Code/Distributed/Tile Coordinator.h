@@ -0,0 +1,500 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef TILE_COORDINATOR_H
+#define TILE_COORDINATOR_H
+
+#include "Tile Protocol.h"
+
+/**
+* Coordinator of a distributed render. It listens for workers on a TCP port, spawning the requested amount of local
+* workers. The port is bound to the loopback address unless a coordinator address is given, which lets the workers
+* started on other machines connect and requires a distributed token. Every worker authenticates with the token before
+* being configured, the local workers receiving it through their environment. The images are split in tiles handed to
+* the workers, each keeping a few requests in flight. The tiles of a worker whose connection fails or that misses the
+* timeout, which starts once the worker prepared the scene of the frame, are handed to the other workers, the dead
+* local workers being respawned. The tiles failing too many times, or all of them when no worker is left or none was
+* available within the idle timeout, are rendered by the coordinator itself
+*/
+class TileCoordinator {
+    /**
+    * A worker connected to the coordinator
+    */
+    struct WorkerConnection {
+        int socket; ///< The socket connected to the worker
+        deque<pair<int, chrono::steady_clock::time_point>> requests; ///< The tiles in flight and their request time
+        int prepared_frame; ///< The last frame whose scene the worker prepared, -1 if none
+    };
+
+    int listening_socket = -1; ///< The socket accepting the workers
+    int port = 0; ///< The port accepting the workers
+    string local_address; ///< Address "host:port" the local workers connect to
+    string token; ///< Secret the workers send before being configured
+    vector<WorkerConnection> workers; ///< The connected workers
+    vector<char> configuration_payload; ///< The options forwarded to the workers, separated by null characters
+
+    string executable_path; ///< The executable spawning the local workers
+    vector<string> workers_environment; ///< The environment of the local workers
+    vector<pid_t> local_workers; ///< The processes of the local workers still running
+    int respawns_left = DISTRIBUTED_WORKER_RESPAWNS; ///< Amount of local workers that can still be respawned
+    bool has_local_workers; ///< Flag indicating if the coordinator spawns local workers
+    chrono::steady_clock::time_point idle_since; ///< Last time a worker was available, or the image started
+    bool is_idle = false; ///< Flag indicating if no worker became available within the idle timeout
+
+    /**
+    * Function that generates a random token, authenticating the workers when none is configured
+    * @return The token, made of 32 hexadecimal digits
+    */
+    static string generateToken() {
+        random_device device;
+        ostringstream token_stream;
+        for(int i = 0; i < 4; i++)
+            token_stream << hex << setw(8) << setfill('0') << device();
+        return token_stream.str();
+    }
+
+    /**
+    * Function that opens the socket accepting the workers
+    * @param host The address accepting the workers
+    * @param requested_port The port accepting the workers, 0 to pick a free one
+    * @return True if the socket is listening, false otherwise
+    */
+    bool openListeningSocket(const string & host, const int requested_port) {
+        // Resolving the address
+        addrinfo hints {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+        addrinfo * addresses = nullptr;
+        if(getaddrinfo(host.c_str(), to_string(requested_port).c_str(), & hints, & addresses) != 0)
+            return false;
+
+        // Binding the first address accepting the socket, the IPv6 ones accepting the IPv4 connections too
+        sockaddr_storage address {};
+        socklen_t address_size = sizeof(address);
+        for(const addrinfo * current = addresses; current && listening_socket < 0; current = current->ai_next) {
+            listening_socket = socket(current->ai_family, current->ai_socktype, current->ai_protocol);
+            if(listening_socket < 0)
+                continue;
+            constexpr int enabled = 1, disabled = 0;
+            setsockopt(listening_socket, SOL_SOCKET, SO_REUSEADDR, & enabled, sizeof(enabled));
+            if(current->ai_family == AF_INET6)
+                setsockopt(listening_socket, IPPROTO_IPV6, IPV6_V6ONLY, & disabled, sizeof(disabled));
+            if(bind(listening_socket, current->ai_addr, current->ai_addrlen) != 0
+                || listen(listening_socket, SOMAXCONN) != 0
+                || getsockname(listening_socket, reinterpret_cast<sockaddr *>(& address), & address_size) != 0) {
+                close(listening_socket);
+                listening_socket = -1;
+            }
+        }
+        freeaddrinfo(addresses);
+        if(listening_socket < 0)
+            return false;
+
+        // Computing the address the local workers connect to, the loopback address standing for the wildcard one
+        char host_buffer[INET6_ADDRSTRLEN];
+        if(address.ss_family == AF_INET6) {
+            auto & ipv6_address = reinterpret_cast<sockaddr_in6 &>(address);
+            if(IN6_IS_ADDR_UNSPECIFIED(& ipv6_address.sin6_addr))
+                ipv6_address.sin6_addr = in6addr_loopback;
+            inet_ntop(AF_INET6, & ipv6_address.sin6_addr, host_buffer, sizeof(host_buffer));
+            port = ntohs(ipv6_address.sin6_port);
+        }
+        else {
+            auto & ipv4_address = reinterpret_cast<sockaddr_in &>(address);
+            if(ipv4_address.sin_addr.s_addr == htonl(INADDR_ANY))
+                ipv4_address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            inet_ntop(AF_INET, & ipv4_address.sin_addr, host_buffer, sizeof(host_buffer));
+            port = ntohs(ipv4_address.sin_port);
+        }
+        local_address = string(host_buffer) + ":" + to_string(port);
+
+        return true;
+    }
+
+    /**
+    * Function that spawns a local worker connecting to the coordinator
+    */
+    void spawnWorker() {
+        // Preparing the arguments and the environment before forking, the child only executing the worker
+        const string worker_option = "--worker=" + local_address;
+        const char * arguments[] = {executable_path.c_str(), worker_option.c_str(), nullptr};
+        vector<const char *> environment;
+        for(const auto & variable : workers_environment)
+            environment.push_back(variable.c_str());
+        environment.push_back(nullptr);
+
+        const pid_t process = fork();
+        if(process == 0) {
+            execve(executable_path.c_str(), const_cast<char * const *>(arguments),
+                const_cast<char * const *>(environment.data()));
+            _exit(EXIT_FAILURE);
+        }
+
+        if(process < 0)
+            PrintError("Cannot spawn a local worker");
+        else
+            local_workers.push_back(process);
+    }
+
+    /**
+    * Function that reaps the local workers that terminated, respawning them while the budget allows it
+    */
+    void reapWorkers() {
+        erase_if(local_workers, [&](const pid_t process) {
+            if(waitpid(process, nullptr, WNOHANG) != process)
+                return false;
+
+            // Respawning the worker
+            if(respawns_left > 0) {
+                respawns_left--;
+                PrintError("A local worker terminated, respawning it");
+                spawnWorker();
+            }
+            return true;
+        });
+    }
+
+    /**
+    * Function that accepts a worker, sending it the configuration once it authenticated
+    */
+    void acceptWorker() {
+        const int socket = accept(listening_socket, nullptr, nullptr);
+        if(socket < 0)
+            return;
+        disableNagle(socket);
+
+        // Receiving the token, bounding the wait so that a silent connection cannot stall the render
+        timeval timeout { .tv_sec = DISTRIBUTED_AUTHENTICATION_TIMEOUT_SECONDS, .tv_usec = 0 };
+        setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, & timeout, sizeof(timeout));
+        tile_message type;
+        vector<char> received_token;
+        if(!receiveTileMessage(socket, type, received_token, static_cast<uint32_t>(token.size()))
+            || type != AUTHENTICATION_MESSAGE || received_token.size() != token.size()) {
+            PrintError("Rejected a worker that did not authenticate");
+            close(socket);
+            return;
+        }
+
+        // Comparing every character, so that the time taken does not reveal the length of the matching prefix
+        char difference = 0;
+        for(size_t i = 0; i < token.size(); i++)
+            difference |= static_cast<char>(received_token[i] ^ token[i]);
+        if(difference != 0) {
+            PrintError("Rejected a worker with a wrong token");
+            close(socket);
+            return;
+        }
+        timeout = {};
+        setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, & timeout, sizeof(timeout));
+
+        // Configuring the worker
+        if(!sendTileMessage(socket, CONFIGURATION_MESSAGE, configuration_payload.data(),
+            configuration_payload.size())) {
+            close(socket);
+            return;
+        }
+
+        workers.push_back({ .socket = socket, .requests = {}, .prepared_frame = -1 });
+    }
+
+    /**
+    * Function that disconnects a worker, handing its tiles back to the pending ones
+    * @param worker The worker
+    * @param pending_tiles The tiles waiting to be requested
+    * @param local_tiles The tiles to be rendered by the coordinator
+    * @param failures The amount of failures of each tile
+    */
+    static void dropWorker(WorkerConnection & worker, deque<int> & pending_tiles, vector<int> & local_tiles,
+        vector<int> & failures) {
+        for(const auto & [tile_index, request_time] : worker.requests) {
+            if(++failures[tile_index] > DISTRIBUTED_MAX_TILE_RETRIES)
+                local_tiles.push_back(tile_index);
+            else
+                pending_tiles.push_front(tile_index);
+        }
+        worker.requests.clear();
+        close(worker.socket);
+        worker.socket = -1;
+    }
+
+public:
+    /**
+    * Constructor opening the port accepting the workers and spawning the local ones
+    * @param configuration The configuration providing the amount of local workers and the port
+    * @param argc Counter of the command line arguments, forwarded to the workers
+    * @param argv The command line arguments
+    */
+    TileCoordinator(const RenderConfiguration & configuration, const int argc, const char * argv[])
+    : has_local_workers(configuration.workers_amount > 0) {
+        // Ignoring the signals raised by writing to the workers that died
+        signal(SIGPIPE, SIG_IGN);
+
+        // Forwarding the options, except the ones describing the distribution
+        for(int i = 1; i < argc; i++) {
+            const string argument = argv[i];
+            string key = argument.rfind("--", 0) == 0 ? argument.substr(2, argument.find('=') - 2) : "";
+            replace(key.begin(), key.end(), '-', '_');
+            if(key == "worker" || key == "workers" || key == "coordinator_port" || key == "coordinator_address"
+                || key == "distributed_token")
+                continue;
+            configuration_payload.insert(configuration_payload.end(), argument.begin(), argument.end());
+            configuration_payload.push_back('\0');
+        }
+
+        // Requiring the token to accept the workers of other machines, generating one for the local workers otherwise
+        const bool is_local = configuration.coordinator_address.empty();
+        token = configuration.distributed_token;
+        if(!is_local && token.empty()) {
+            PrintError("Accepting the workers on " + configuration.coordinator_address
+                + " requires a distributed token, rendering locally");
+            return;
+        }
+        if(token.empty())
+            token = generateToken();
+
+        // Opening the listening socket, on the loopback address unless an address is given
+        if(!openListeningSocket(is_local ? "127.0.0.1" : configuration.coordinator_address,
+            configuration.coordinator_port)) {
+            PrintError("Cannot open the port accepting the workers, rendering locally");
+            return;
+        }
+        PrintGenericMessage("Accepting the workers on port " + to_string(port)
+            + (is_local ? " of the loopback address, set a coordinator address to accept remote workers" : ""));
+
+        // Sharing the cores among the local workers, and the token
+        if(!has_local_workers)
+            return;
+        const int threads_per_worker = max(omp_get_num_procs() / configuration.workers_amount, 1);
+        const string token_prefix = string(DISTRIBUTED_TOKEN_VARIABLE) + "=";
+        for(char ** variable = environ; * variable; variable++)
+            if(string(* variable).rfind("OMP_NUM_THREADS=", 0) != 0 && string(* variable).rfind(token_prefix, 0) != 0)
+                workers_environment.emplace_back(* variable);
+        workers_environment.push_back("OMP_NUM_THREADS=" + to_string(threads_per_worker));
+        workers_environment.push_back(token_prefix + token);
+
+        // Spawning the local workers
+        error_code error;
+        const filesystem::path executable = filesystem::read_symlink("/proc/self/exe", error);
+        executable_path = error ? string(argv[0]) : executable.string();
+        for(int i = 0; i < configuration.workers_amount; i++)
+            spawnWorker();
+    }
+
+    TileCoordinator(const TileCoordinator &) = delete;
+    TileCoordinator & operator=(const TileCoordinator &) = delete;
+
+    /**
+    * Destructor shutting the workers down
+    */
+    ~TileCoordinator() {
+        // Shutting the connected workers down
+        for(const auto & worker : workers) {
+            sendTileMessage(worker.socket, SHUTDOWN_MESSAGE);
+            close(worker.socket);
+        }
+        if(listening_socket >= 0)
+            close(listening_socket);
+
+        // Waiting for the local workers, terminating the ones that did not connect
+        for(const pid_t process : local_workers) {
+            if(waitpid(process, nullptr, WNOHANG) == 0) {
+                this_thread::sleep_for(chrono::milliseconds(100));
+                if(waitpid(process, nullptr, WNOHANG) == 0) {
+                    kill(process, SIGKILL);
+                    waitpid(process, nullptr, 0);
+                }
+            }
+        }
+    }
+
+    /**
+    * Renders an image by distributing its tiles among the workers, checkpointing the completed tiles if the
+    * configuration requests it
+    * @param frame_number The frame the image belongs to, starting from 0
+    * @param camera_index The index of the camera capturing the image within the cameras of the frame
+    * @param render_kernel The kernel rendering the tiles left to the coordinator
+    * @param current_camera The camera capturing the image
+    * @param current_image The image storing the HDR pixels
+    */
+    void renderImage(const int frame_number, const int camera_index, const RenderKernel render_kernel,
+        const Camera * current_camera, Image * current_image) {
+        // Splitting the image in tiles
+        const vector<RenderTile> tiles = generateRenderTiles(static_cast<int>(current_camera->getWidth()),
+            static_cast<int>(current_camera->getHeight()), DISTRIBUTED_TILE_SIZE);
+
+        // Allocating the features guiding the denoiser, sent by the workers along with the pixels
+        if(render_configuration.use_denoiser)
+            current_image->enableFeatures();
+        const size_t pixel_size = 3 * sizeof(float) + (render_configuration.use_denoiser ? sizeof(PixelFeatures) : 0);
+
+        // Skipping the tiles completed before an interruption
+        const uint64_t samples_seed = SampleGenerator::computeImageSeed(frame_number, camera_index);
+        const auto checkpoint = RenderCheckpoint::open(render_configuration, current_image, tiles, samples_seed);
+        deque<int> pending_tiles;
+        for(int t = 0; t < static_cast<int>(tiles.size()); t++)
+            if(!checkpoint || !checkpoint->isTileCompleted(t))
+                pending_tiles.push_back(t);
+        vector<int> local_tiles;
+        vector<int> failures(tiles.size(), 0);
+        size_t remaining_tiles = pending_tiles.size();
+        vector<char> payload;
+
+        // Accepting the workers that connected while the scene was prepared
+        pollfd listening { .fd = listening_socket, .events = POLLIN, .revents = 0 };
+        while(listening_socket >= 0 && poll(& listening, 1, 0) > 0 && (listening.revents & POLLIN))
+            acceptWorker();
+
+        // Waiting for the workers from the start of the image, unless none became available for a previous one
+        if(!is_idle)
+            idle_since = chrono::steady_clock::now();
+
+        while(remaining_tiles > 0) {
+            // Measuring how long no worker has been connected or running locally
+            reapWorkers();
+            if(!workers.empty() || !local_workers.empty()) {
+                idle_since = chrono::steady_clock::now();
+                is_idle = false;
+            }
+            else if(!is_idle && chrono::steady_clock::now() - idle_since
+                > chrono::seconds(DISTRIBUTED_IDLE_TIMEOUT_SECONDS)) {
+                PrintError("No worker available for " + to_string(DISTRIBUTED_IDLE_TIMEOUT_SECONDS)
+                    + " seconds, rendering locally until one connects");
+                is_idle = true;
+            }
+
+            // Rendering the tiles left to the coordinator, all of them if no worker is available or expected
+            if(listening_socket < 0 || (has_local_workers && workers.empty() && local_workers.empty()) || is_idle) {
+                local_tiles.insert(local_tiles.end(), pending_tiles.begin(), pending_tiles.end());
+                pending_tiles.clear();
+            }
+            for(const int tile_index : local_tiles) {
+                renderRegion(render_kernel, current_camera, current_image, tiles[tile_index], samples_seed);
+                if(checkpoint)
+                    checkpoint->completeTile(tile_index);
+            }
+            remaining_tiles -= local_tiles.size();
+            local_tiles.clear();
+            if(remaining_tiles == 0)
+                break;
+
+            // Requesting the pending tiles to the workers
+            const auto now = chrono::steady_clock::now();
+            for(auto & worker : workers) {
+                while(worker.socket >= 0 && static_cast<int>(worker.requests.size()) < DISTRIBUTED_TILES_IN_FLIGHT
+                    && !pending_tiles.empty()) {
+                    const TileRequest request {
+                        .frame_number = frame_number,
+                        .camera_index = camera_index,
+                        .tile_index = pending_tiles.front(),
+                        .tile = tiles[pending_tiles.front()]
+                    };
+                    worker.requests.emplace_back(pending_tiles.front(), now);
+                    pending_tiles.pop_front();
+                    if(!sendTileMessage(worker.socket, TILE_REQUEST_MESSAGE, & request, sizeof(TileRequest)))
+                        dropWorker(worker, pending_tiles, local_tiles, failures);
+                }
+            }
+
+            // Waiting for new workers and for the results
+            vector<pollfd> sockets {{ .fd = listening_socket, .events = POLLIN, .revents = 0 }};
+            for(const auto & worker : workers)
+                sockets.push_back({ .fd = worker.socket, .events = POLLIN, .revents = 0 });
+            if(poll(sockets.data(), sockets.size(), 1000) < 0 && errno != EINTR) {
+                PrintError("Cannot wait for the workers");
+                break;
+            }
+
+            // Collecting the results
+            for(size_t i = 0; i < workers.size(); i++) {
+                WorkerConnection & worker = workers[i];
+                if(worker.socket < 0 || sockets[i + 1].revents == 0)
+                    continue;
+
+                // Receiving the message, dropping the worker if the connection failed
+                tile_message type;
+                if(!receiveTileMessage(worker.socket, type, payload)) {
+                    PrintError("Lost the connection with a worker");
+                    dropWorker(worker, pending_tiles, local_tiles, failures);
+                    continue;
+                }
+
+                // Case in which the worker prepared the scene, timing its requests from now on
+                if(type == WORKER_READY_MESSAGE && payload.size() == sizeof(int32_t)) {
+                    memcpy(& worker.prepared_frame, payload.data(), sizeof(int32_t));
+                    for(auto & [tile_index, request_time] : worker.requests)
+                        request_time = chrono::steady_clock::now();
+                    continue;
+                }
+
+                // Verifying that the message is a tile result
+                if(type != TILE_RESULT_MESSAGE || payload.size() < sizeof(TileResultHeader)) {
+                    PrintError("Received an invalid message from a worker");
+                    dropWorker(worker, pending_tiles, local_tiles, failures);
+                    continue;
+                }
+
+                // Matching the result with its request, dropping the worker if the result is invalid
+                TileResultHeader result {};
+                memcpy(& result, payload.data(), sizeof(TileResultHeader));
+                const auto request = find_if(worker.requests.begin(), worker.requests.end(),
+                    [&](const pair<int, chrono::steady_clock::time_point> & entry) {
+                        return entry.first == result.tile_index;
+                    });
+                if(request == worker.requests.end() || payload.size() != sizeof(TileResultHeader) + pixel_size
+                    * (tiles[result.tile_index].x_end - tiles[result.tile_index].x_start)
+                    * (tiles[result.tile_index].y_end - tiles[result.tile_index].y_start)) {
+                    PrintError("Received an invalid tile from a worker");
+                    dropWorker(worker, pending_tiles, local_tiles, failures);
+                    continue;
+                }
+                const RenderTile & tile = tiles[result.tile_index];
+
+                // Storing the pixels of the tile
+                const auto pixels = reinterpret_cast<const float *>(payload.data() + sizeof(TileResultHeader));
+                int pixel = 0;
+                for(int y = tile.y_start; y < tile.y_end; y++)
+                    for(int x = tile.x_start; x < tile.x_end; x++, pixel++)
+                        current_image->setHDRPixel(x, y, {pixels[3 * pixel], pixels[3 * pixel + 1],
+                            pixels[3 * pixel + 2]});
+                if(render_configuration.use_denoiser) {
+                    auto features = reinterpret_cast<const char *>(pixels + 3 * pixel);
+                    for(int y = tile.y_start; y < tile.y_end; y++) {
+                        for(int x = tile.x_start; x < tile.x_end; x++, features += sizeof(PixelFeatures)) {
+                            PixelFeatures pixel_features;
+                            memcpy(& pixel_features, features, sizeof(PixelFeatures));
+                            current_image->setPixelFeatures(x, y, pixel_features);
+                        }
+                    }
+                }
+                worker.requests.erase(request);
+                remaining_tiles--;
+                if(checkpoint)
+                    checkpoint->completeTile(result.tile_index);
+            }
+
+            // Dropping the workers whose oldest request timed out, the ones preparing the scene being given longer
+            for(auto & worker : workers) {
+                const chrono::seconds timeout(worker.prepared_frame == frame_number ? DISTRIBUTED_TILE_TIMEOUT_SECONDS
+                    : DISTRIBUTED_PREPARATION_TIMEOUT_SECONDS);
+                if(worker.socket >= 0 && !worker.requests.empty()
+                    && chrono::steady_clock::now() - worker.requests.front().second > timeout) {
+                    PrintError("A worker timed out");
+                    dropWorker(worker, pending_tiles, local_tiles, failures);
+                }
+            }
+            erase_if(workers, [](const WorkerConnection & worker) { return worker.socket < 0; });
+
+            // Accepting the new workers
+            if(sockets[0].revents & POLLIN)
+                acceptWorker();
+        }
+
+        // Recording the completed image
+        if(checkpoint)
+            checkpoint->finish();
+    }
+};
+
+#endif //TILE_COORDINATOR_H
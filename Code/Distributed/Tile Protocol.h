@@ -0,0 +1,130 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef TILE_PROTOCOL_H
+#define TILE_PROTOCOL_H
+
+/**
+* Header preceding the payload of every message exchanged between the coordinator and the workers. The messages are
+* exchanged in the native byte order, so the machines taking part in a render must share it
+*/
+struct TileMessageHeader {
+    tile_message type; ///< The type of the message
+    uint32_t payload_size; ///< Bytes of payload following the header
+};
+
+/**
+* Payload of a tile request
+*/
+struct TileRequest {
+    int32_t frame_number; ///< The frame the tile belongs to, starting from 0
+    int32_t camera_index; ///< Index of the camera capturing the image within the cameras of the frame
+    int32_t tile_index; ///< Index of the tile within the image, sent back with the result
+    RenderTile tile; ///< The pixels to render
+};
+
+/**
+* Header of the payload of a tile result, followed by the RGB values of the tile pixels in row major order, then by
+* their PixelFeatures if the denoiser is enabled
+*/
+struct TileResultHeader {
+    int32_t tile_index; ///< Index of the tile within the image
+};
+
+// Maximum size of a payload, larger ones being considered corrupted
+constexpr uint32_t TILE_MESSAGE_MAX_PAYLOAD = 1u << 28;
+
+/**
+* Function that sends a buffer over a socket, retrying until all of it is sent
+* @param socket The socket
+* @param data The buffer
+* @param size The size of the buffer
+* @return True if the whole buffer was sent, false if the connection failed
+*/
+inline bool sendBytes(const int socket, const void * data, size_t size) {
+    auto current = static_cast<const char *>(data);
+    while(size > 0) {
+        const ssize_t sent = send(socket, current, size, 0);
+        if(sent < 0 && errno == EINTR)
+            continue;
+        if(sent <= 0)
+            return false;
+        current += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+/**
+* Function that receives a buffer from a socket, waiting until all of it is received
+* @param socket The socket
+* @param data The buffer
+* @param size The size of the buffer
+* @return True if the whole buffer was received, false if the connection failed or was closed
+*/
+inline bool receiveBytes(const int socket, void * data, size_t size) {
+    auto current = static_cast<char *>(data);
+    while(size > 0) {
+        const ssize_t received = recv(socket, current, size, 0);
+        if(received < 0 && errno == EINTR)
+            continue;
+        if(received <= 0)
+            return false;
+        current += received;
+        size -= received;
+    }
+    return true;
+}
+
+/**
+* Function that sends a message
+* @param socket The socket
+* @param type The type of the message
+* @param payload The payload of the message
+* @param payload_size The size of the payload
+* @return True if the message was sent, false if the connection failed
+*/
+inline bool sendTileMessage(const int socket, const tile_message type, const void * payload = nullptr,
+    const size_t payload_size = 0) {
+    // Rejecting the payloads that the receiver would consider corrupted
+    if(payload_size > TILE_MESSAGE_MAX_PAYLOAD) {
+        PrintError("Cannot send a message of " + to_string(payload_size) + " bytes");
+        return false;
+    }
+
+    // Sending the header, then the payload
+    const TileMessageHeader header { .type = type, .payload_size = static_cast<uint32_t>(payload_size) };
+    return sendBytes(socket, & header, sizeof(TileMessageHeader))
+        && (payload_size == 0 || sendBytes(socket, payload, payload_size));
+}
+
+/**
+* Function that receives a message
+* @param socket The socket
+* @param type The type of the received message
+* @param payload The payload of the received message
+* @param max_payload_size The largest payload accepted, the larger ones being considered corrupted
+* @return True if a message was received, false if the connection failed or the message was corrupted
+*/
+inline bool receiveTileMessage(const int socket, tile_message & type, vector<char> & payload,
+    const uint32_t max_payload_size = TILE_MESSAGE_MAX_PAYLOAD) {
+    TileMessageHeader header {};
+    if(!receiveBytes(socket, & header, sizeof(TileMessageHeader)) || header.payload_size > max_payload_size)
+        return false;
+
+    type = header.type;
+    payload.resize(header.payload_size);
+    return receiveBytes(socket, payload.data(), payload.size());
+}
+
+/**
+* Function that disables the batching of the small writes on a socket, the tile requests being latency bound
+* @param socket The socket
+*/
+inline void disableNagle(const int socket) {
+    constexpr int enabled = 1;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, & enabled, sizeof(enabled));
+}
+
+#endif //TILE_PROTOCOL_H
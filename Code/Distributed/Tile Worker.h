@@ -0,0 +1,183 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef TILE_WORKER_H
+#define TILE_WORKER_H
+
+#include "Tile Protocol.h"
+
+/**
+* Function that connects to the coordinator of a distributed render, retrying while it starts
+* @param address The address of the coordinator, with format "host:port"
+* @return The socket connected to the coordinator, -1 if the connection failed
+*/
+inline int connectToCoordinator(const string & address) {
+    // Resolving the address
+    const size_t separator = address.rfind(':');
+    if(separator == string::npos)
+        return -1;
+    const string host = address.substr(0, separator);
+    const string service = address.substr(separator + 1);
+    addrinfo hints {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo * addresses = nullptr;
+    if(getaddrinfo(host.c_str(), service.c_str(), & hints, & addresses) != 0)
+        return -1;
+
+    // Connecting to the first address accepting the connection
+    int coordinator = -1;
+    for(int attempt = 0; attempt < DISTRIBUTED_CONNECTION_ATTEMPTS && coordinator < 0; attempt++) {
+        for(const addrinfo * current = addresses; current && coordinator < 0; current = current->ai_next) {
+            coordinator = socket(current->ai_family, current->ai_socktype, current->ai_protocol);
+            if(coordinator >= 0 && connect(coordinator, current->ai_addr, current->ai_addrlen) != 0) {
+                close(coordinator);
+                coordinator = -1;
+            }
+        }
+
+        // Waiting before the next attempt
+        if(coordinator < 0)
+            this_thread::sleep_for(chrono::milliseconds(100));
+    }
+    freeaddrinfo(addresses);
+
+    if(coordinator >= 0)
+        disableNagle(coordinator);
+    return coordinator;
+}
+
+/**
+* Runs the process as a worker of a distributed render. The worker applies the options forwarded by the coordinator,
+* then renders the requested tiles until the coordinator shuts it down, preparing the scene of a frame the first
+* time one of its tiles is requested
+* @param address The address of the coordinator, with format "host:port"
+* @param argc Counter of the command line arguments of the worker, taking precedence over the forwarded options
+* @param argv The command line arguments of the worker
+* @param prepare_frame Function preparing the scene of a frame, given its number and the command line
+* @return The exit code of the process
+*/
+inline int runTileWorker(const string & address, const int argc, const char * argv[],
+    const function<void (int, int, const char * [])> & prepare_frame) {
+    // Ignoring the signals raised by writing to a coordinator that terminated
+    signal(SIGPIPE, SIG_IGN);
+
+    // Connecting to the coordinator
+    const int coordinator = connectToCoordinator(address);
+    if(coordinator < 0) {
+        PrintError("Cannot connect to the coordinator " + address);
+        return EXIT_FAILURE;
+    }
+
+    // Authenticating with the token given by the coordinator that spawned the worker, or by the options
+    const char * spawning_token = getenv(DISTRIBUTED_TOKEN_VARIABLE);
+    const string token = spawning_token ? spawning_token : render_configuration.distributed_token;
+    if(!sendTileMessage(coordinator, AUTHENTICATION_MESSAGE, token.data(), token.size())) {
+        PrintError("Cannot authenticate with the coordinator " + address);
+        close(coordinator);
+        return EXIT_FAILURE;
+    }
+
+    // Receiving the forwarded options
+    tile_message type;
+    vector<char> payload;
+    if(!receiveTileMessage(coordinator, type, payload) || type != CONFIGURATION_MESSAGE) {
+        PrintError("Cannot receive the configuration from the coordinator " + address);
+        close(coordinator);
+        return EXIT_FAILURE;
+    }
+
+    // Building the command line, the own arguments following the forwarded ones
+    vector<string> options {argv[0]};
+    for(size_t start = 0; start < payload.size();) {
+        const size_t end = find(payload.begin() + static_cast<long>(start), payload.end(), '\0') - payload.begin();
+        options.emplace_back(payload.data() + start, end - start);
+        start = end + 1;
+    }
+    for(int i = 1; i < argc; i++)
+        options.emplace_back(argv[i]);
+    vector<const char *> arguments;
+    for(const auto & option : options)
+        arguments.push_back(option.c_str());
+    const int arguments_amount = static_cast<int>(arguments.size());
+    render_configuration.parseCommandLine(arguments_amount, arguments.data());
+
+    // Rendering the requested tiles
+    int current_frame = -1;
+    map<int, unique_ptr<Image>> images;
+    while(receiveTileMessage(coordinator, type, payload) && type == TILE_REQUEST_MESSAGE
+        && payload.size() == sizeof(TileRequest)) {
+        TileRequest request {};
+        memcpy(& request, payload.data(), sizeof(TileRequest));
+
+        // Preparing the scene the first time a tile of the frame is requested
+        if(request.frame_number != current_frame) {
+            if(current_frame >= 0)
+                ResetScene();
+            prepare_frame(request.frame_number, arguments_amount, arguments.data());
+            current_frame = request.frame_number;
+            images.clear();
+
+            // Reporting that the scene is ready, the coordinator timing the requests from now on
+            const int32_t prepared_frame = current_frame;
+            if(!sendTileMessage(coordinator, WORKER_READY_MESSAGE, & prepared_frame, sizeof(int32_t)))
+                break;
+        }
+
+        // Verifying that the tile lies within the image of an existing camera
+        if(request.camera_index < 0 || request.camera_index >= static_cast<int>(cameras.size())) {
+            PrintError("The coordinator requested a tile of a missing camera");
+            break;
+        }
+        const Camera * camera = cameras[request.camera_index];
+        const int camera_width = static_cast<int>(camera->getWidth());
+        const int camera_height = static_cast<int>(camera->getHeight());
+        const RenderTile & tile = request.tile;
+        if(tile.x_start < 0 || tile.y_start < 0 || tile.x_end > camera_width || tile.y_end > camera_height
+            || tile.x_start >= tile.x_end || tile.y_start >= tile.y_end) {
+            PrintError("The coordinator requested a tile outside of the image");
+            break;
+        }
+
+        // Rendering the tile
+        auto & image = images[request.camera_index];
+        if(!image)
+            image = make_unique<Image>(camera->getName(), camera_width, camera_height);
+        renderRegion(selectRenderKernel(render_configuration), camera, image.get(), tile,
+            SampleGenerator::computeImageSeed(request.frame_number, request.camera_index));
+
+        // Sending the pixels back, followed by their features if the denoiser needs them
+        const TileResultHeader header { .tile_index = request.tile_index };
+        const size_t tile_pixels = static_cast<size_t>(tile.x_end - tile.x_start) * (tile.y_end - tile.y_start);
+        vector<char> result(sizeof(TileResultHeader) + 3 * sizeof(float) * tile_pixels
+            + (image->hasFeatures() ? sizeof(PixelFeatures) * tile_pixels : 0));
+        memcpy(result.data(), & header, sizeof(TileResultHeader));
+        auto pixels = reinterpret_cast<float *>(result.data() + sizeof(TileResultHeader));
+        for(int y = tile.y_start; y < tile.y_end; y++) {
+            for(int x = tile.x_start; x < tile.x_end; x++) {
+                const glm::vec3 color = image->getHDRPixel(x, y);
+                * pixels++ = color.r;
+                * pixels++ = color.g;
+                * pixels++ = color.b;
+            }
+        }
+        if(image->hasFeatures()) {
+            auto features = reinterpret_cast<char *>(pixels);
+            for(int y = tile.y_start; y < tile.y_end; y++)
+                for(int x = tile.x_start; x < tile.x_end; x++, features += sizeof(PixelFeatures))
+                    memcpy(features, & image->getPixelFeatures(x, y), sizeof(PixelFeatures));
+        }
+        if(!sendTileMessage(coordinator, TILE_RESULT_MESSAGE, result.data(), result.size()))
+            break;
+    }
+
+    // Releasing the scene
+    if(current_frame >= 0)
+        ResetScene();
+    close(coordinator);
+
+    return EXIT_SUCCESS;
+}
+
+#endif //TILE_WORKER_H
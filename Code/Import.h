@@ -20,10 +20,42 @@
 #include <functional>
 #include <algorithm>
 #include <map>
+#include <set>
 #include <omp.h>
 #include <random>
 #include <queue>
 #include <limits>
+#include <array>
+#include <utility>
+#include <mutex>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <bit>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <numeric>
+#include <cassert>
+
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <csignal>
+#include <poll.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
 
 // GLM
 #include "glm/glm.hpp"
@@ -48,6 +80,13 @@
 #include "Auxiliary/Random.h"
 #include "Auxiliary/Math.h"
 
+// Runtime configuration
+#include "Core/Render Configuration.h"
+
+// Statistics
+#include "Auxiliary/Statistics.h"
+#include "Auxiliary/Profiler.h"
+
 // Colors
 #include "Static Data/Colors.h"
 
@@ -58,6 +97,7 @@
 #include "Core/Core Structs.h"
 #include "Core/Entity.h"
 #include "Core/Scene.h"
+#include "Texture/Baked Volume.h"
 #include "Core/Material.h"
 #include "Core/Camera.h"
 
@@ -70,12 +110,14 @@
 
 // Image Processing
 #include "Core/Image.h"
+#include "Core/Frame Writer.h"
 
 // Texture
+#include "Texture/Texture Cache.h"
 #include "Texture/Texture.h"
 
 // SDS
-#include "SDS/BVH.h"
+#include "SDS/SDS Factory.h"
 #include "Photon Mapping/Photon KDTree.h"
 
 // Primitives implementation
@@ -85,6 +127,7 @@
 #include "Primitives/Disk.h"
 #include "Primitives/Cone.h"
 #include "Primitives/Sphere.h"
+#include "Primitives/Heightfield.h"
 
 // Lights
 #include "Lights/Light.h"
@@ -101,6 +144,14 @@
 
 // Tracing
 #include "Tracing/Tracer.h"
+#include "Tracing/Render Checkpoint.h"
+#include "Tracing/Renderer.h"
+
+// Distributed rendering
+#include "Distributed/Tile Protocol.h"
+#include "Distributed/Tile Coordinator.h"
+#include "Distributed/Tile Worker.h"
+#include "Distributed/Render Server.h"
 
 // Bounding Box
 #include "Bounds/Bounding Box 3D.h"
@@ -127,5 +178,6 @@
 #include "Scenes/Photon Mapping Scene.h"
 #include "Scenes/Default Scene.h"
 #include "Scenes/USI Competition Scene.h"
+#include "Scenes/Scene Loader.h"
 
 #endif //IMPORT_H
\ No newline at end of file
@@ -22,7 +22,7 @@ public:
         // Generating the samples
         for(int i = 0; i < AREA_LIGHT_SAMPLES_AMOUNT; i++) {
             // Generating a random coordinate on a disk
-            const glm::vec2 random_coordinates = glm::diskRand(disk_radius);
+            const glm::vec2 random_coordinates = scene_generator.getDiskSample(disk_radius);
 
             // Generating the transform of the samples
             glm::mat4 sample_transform = translate(transform,glm::vec3(random_coordinates.x, 0, random_coordinates.y));
@@ -32,11 +32,14 @@ protected:
         const float distance = glm::distance(light_ray.origin, surface_point + epsilon * (-light_ray.direction));
 
         // Computing the closest intersection
-        Interaction tentative_hit = bvh->intersectNoTransparentWithinDistance(light_ray, distance);
+        countStatistic(SHADOW_RAYS);
+        Interaction tentative_hit = sds->intersectNoTransparentWithinDistance(light_ray, distance);
 
         // Verifying if there was a hit
-        if(tentative_hit.hit && tentative_hit.distance <= distance)
+        if(tentative_hit.hit && tentative_hit.distance <= distance) {
+            countStatistic(OCCLUDED_SHADOW_RAYS);
             return true;
+        }
 
         // Case with no occlusion
         return false;
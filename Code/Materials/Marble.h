@@ -12,27 +12,19 @@ public:
     glm::vec3 filling_color; ///< Color of the filling area in the marble surface
 
     /**
-    * Getter for the material specular at the given surface point
+    * The marble veins vary with the surface point
+    */
+    [[nodiscard]] bool isProcedural() const override {
+        return true;
+    }
+
+    /**
+    * Getter for the material diffuse at the given surface point
     * @param surface_point  The surface point
     */
     [[nodiscard]] glm::vec3 getDiffuse(const glm::vec3 surface_point) const override {
-        // Initializing values
-        float noise = 0.0f;
-        float amplitude = 1.0f;
-        float frequency = 1.0f;
-        float octaves = 6;
-
         // Combining multiple octaves of Perlin noise
-        // TODO: implement this in Perlin noise header
-        for (int i = 0; i < octaves; i++) {
-            noise += amplitude * PerlinNoise::getInstance()->Noise(
-                frequency * surface_point.x,
-                frequency * surface_point.y,
-                frequency * surface_point.z);
-
-            amplitude *= 0.5f;
-            frequency *= 2.0f;
-        }
+        const float noise = PerlinNoise::getInstance()->FractalNoise(surface_point, FractalNoiseParameters {});
 
         // Functions coefficients
         constexpr float veins_scale = 0.01;
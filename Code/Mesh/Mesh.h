@@ -555,6 +555,69 @@ protected:
         }
     }
 
+    /**
+    * Builds the faces of a procedural grid whose vertices are stored row by row, each vertex being shared by the quads
+    * touching it. The faces are written in parallel into a preallocated buffer, so the vertices buffers must not be
+    * resized afterwards. The corners of the quad at row r and column c are numbered 0 (r, c), 1 (r, c + 1),
+    * 2 (r + 1, c) and 3 (r + 1, c + 1)
+    * @param rows Amount of rows of vertices
+    * @param columns Amount of columns of vertices
+    * @param wrap_columns Flag indicating weather or not the last column is stitched to the first one
+    * @param triangles The corners of the two triangles of each quad
+    * @param smooth_shading Flag indicating weather or not the faces use smooth shading
+    * @param store_indexes Flag indicating weather or not store the indexes used by elaborateFacesAndVertices
+    */
+    void buildGridFaces(const int rows, const int columns, const bool wrap_columns, const int (& triangles)[2][3],
+        const bool smooth_shading, const bool store_indexes = false) {
+        // Computing the amount of quads
+        const int quads_per_row = wrap_columns ? columns : columns - 1;
+        const int quads_amount = max(rows - 1, 0) * max(quads_per_row, 0);
+
+        // Allocating the faces
+        Object current_object {};
+        current_object.faces.resize(2 * quads_amount);
+
+        #pragma omp parallel for
+        for(int row = 0; row < rows - 1; row++) {
+            for(int column = 0; column < quads_per_row; column++) {
+                // Computing the indexes of the quad corners
+                const unsigned int next_column = (column + 1) % columns;
+                const unsigned int corners [4] {
+                    static_cast<unsigned int>(row * columns + column),
+                    static_cast<unsigned int>(row * columns) + next_column,
+                    static_cast<unsigned int>((row + 1) * columns + column),
+                    static_cast<unsigned int>((row + 1) * columns) + next_column
+                };
+
+                // Filling the two faces of the quad
+                for(int triangle = 0; triangle < 2; triangle++) {
+                    Face & face = current_object.faces[2 * (row * quads_per_row + column) + triangle];
+                    face.smoothing = smooth_shading;
+
+                    for(int i = 0; i < 3; i++) {
+                        const unsigned int vertex_index = corners[triangles[triangle][i]];
+                        face.vertices[i].coordinates = & this->vertices_coordinates[vertex_index];
+                        if(!this->vertices_normals.empty())
+                            face.vertices[i].normal = this->vertices_normals[vertex_index];
+                        if(!this->vertices_uv_coordinates.empty())
+                            face.vertices[i].uv_coordinates = & this->vertices_uv_coordinates[vertex_index];
+
+                        // Storing the indexes
+                        if(store_indexes) {
+                            face.vertices_indexes.push_back(vertex_index);
+                            face.normals_indexes.push_back(vertex_index);
+                            face.uv_indexes.push_back(vertex_index);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Pushing the object
+        this->primitives_amount += 2 * quads_amount;
+        this->objects.push_back(std::move(current_object));
+    }
+
 public:
     struct Face {
         Vertex vertices [3]; ///< Vector of vertices
@@ -598,6 +661,8 @@ public:
     string obj_path; ///< The mesh path in file system
     string mtl_path; ///< The mesh mtl path in the file system
 
+    bool is_geometry_released = false; ///< Flag indicating weather or not the geometry was released
+
     /**
     * Constructor used by children classes that procedurally generates the mesh geometry
     */
@@ -626,8 +691,8 @@ public:
     displacement(displacement),
     obj_path(obj_path? obj_path : ""),
     mtl_path(mtl_path ? mtl_path : ""){
-        // Clock time at the beginning of OBJ parsing
-        clock_t current_time = clock();
+        // Measuring the OBJ parsing time
+        const ProfilerScope profiler_scope("parse " + this->obj_path, "io", PRINT_OBJ_PARSING_TIME);
 
         if(PRINT_OBJ_PARSING_TIME)
             PrintStartingProcess("parsing of " + this->obj_path);
@@ -642,11 +707,21 @@ public:
 
         if(PRINT_PRIMITIVES_AMOUNT)
             PrintGenericMessage("There are " + to_string(primitives_amount) + " primitives within " + this->obj_path);
+    }
 
-        // Printing useful data regarding OBJ parsing time
-        current_time = clock() - current_time;
-        if(PRINT_OBJ_PARSING_TIME)
-            PrintExecutionTime(current_time, "parse " + this->obj_path);
+    /**
+    * Releases the objects and the vertices of the mesh, once no triangle references them anymore. The materials are
+    * kept, since the triangles copied out of the mesh still point to them
+    */
+    void releaseGeometry() {
+        objects = {};
+        vertices_coordinates = {};
+        vertices_normals = {};
+        vertices_uv_coordinates = {};
+        vertices_tangents = {};
+        vertices_bitangents = {};
+        adjacency_faces = {};
+        is_geometry_released = true;
     }
 };
 
@@ -10,108 +10,63 @@ class PerlinTerrainMesh : public Mesh {
 public:
     PerlinTerrainMesh(const float width, const float depth,
         const float noise_frequency, const float noise_amplitude, const float time) {
-        // Clock time at the beginning of terrain mesh creation
-        clock_t current_time = clock();
+        // Measuring the creation time
+        const ProfilerScope profiler_scope("create the Perlin Terrain", "build", PRINT_PERLIN_TERRAIN_CREATION_TIME);
 
         // Printing information regarding the terrain creation process
         if(PRINT_OBJ_PARSING_TIME)
             PrintStartingProcess("creation of Perlin Terrain");
 
-        // Initializing the object
-        Object current_object {};
-
-        // Creating triangles using the Perlin Noise
-        for(float i = - (width / 2); i < width / 2 ; i += noise_frequency) {
-            for(float j = - (depth / 2); j < depth / 2; j += noise_frequency) {
-                // Generating the array of x coordinates
-                const float x_coordinates [4] {
-                    i,
-                    i,
-                    i + noise_frequency,
-                    i + noise_frequency
-                };
-
-                // Generating the array of y coordinates
-                const float z_coordinates [4] {
-                    j,
-                    j + noise_frequency,
-                    j,
-                    j + noise_frequency,
-                };
-
-                // Generating the array of height values
-                float heights [4] {0,0,0,0};
-
-                // Initializing values
-                float amplitude = noise_amplitude;
-                float frequency = 1.0f;
-                const int octaves = 6;
-
-                // Combining multiple octaves of Perlin noise
-                for(int i = 0; i < 4; i++) {
-                    for (int k = 0; k < octaves; k++) {
-                        heights[i] += amplitude * PerlinNoise::getInstance()->Noise(
-                            frequency * x_coordinates[i],
-                            frequency * time,
-                            frequency * z_coordinates[i]);
-
-                        amplitude *= 0.5f;
-                        frequency *= 2.0f;
-                    }
-
-                    // Resetting amplitude and frequency
-                    amplitude = noise_amplitude;
-                    frequency = 1.0f;
+        // Computing the coordinates of the grid lines, the last line closing the last cell
+        vector<float> x_coordinates;
+        vector<float> z_coordinates;
+        for(float i = - (width / 2); i < width / 2 ; i += noise_frequency)
+            x_coordinates.push_back(i);
+        for(float j = - (depth / 2); j < depth / 2; j += noise_frequency)
+            z_coordinates.push_back(j);
+        x_coordinates.push_back(x_coordinates.empty() ? - (width / 2) : x_coordinates.back() + noise_frequency);
+        z_coordinates.push_back(z_coordinates.empty() ? - (depth / 2) : z_coordinates.back() + noise_frequency);
+
+        // Initializing the noise generator and the fractal noise parameters
+        const PerlinNoise * perlin_noise = PerlinNoise::getInstance();
+        const FractalNoiseParameters noise_parameters { .amplitude = noise_amplitude };
+
+        // Computing the height of each vertex once, in parallel over the rows and in batches along the row
+        const int rows = static_cast<int>(x_coordinates.size());
+        const int columns = static_cast<int>(z_coordinates.size());
+        this->vertices_coordinates.resize(rows * columns);
+
+        #pragma omp parallel for
+        for(int row = 0; row < rows; row++) {
+            constexpr int batch_size = 8;
+            alignas(32) float x[batch_size], y[batch_size], z[batch_size], heights[batch_size];
+
+            for(int first_column = 0; first_column < columns; first_column += batch_size) {
+                // Gathering the coordinates, the lanes past the row end being discarded
+                for(int lane = 0; lane < batch_size; lane++) {
+                    x[lane] = x_coordinates[row];
+                    y[lane] = time;
+                    z[lane] = z_coordinates[min(first_column + lane, columns - 1)];
                 }
 
-                // Storing the size of the vertices vector
-                int starting_index = vertices_coordinates.size();
-
-                // Pushing the vertices in the array
-                for(int i = 0; i < 4; i++) {
-                    this->vertices_coordinates.emplace_back(x_coordinates[i], heights[i], z_coordinates[i]);
-                }
-
-                // Creating the indexes offsets of the quad's triangles
-                constexpr int first_indexes [3] {0, 1, 2};
-                constexpr int second_indexes[3] {2, 1, 3};
-
-                // Creating the first face
-                Face first_face {};
-
-                // Creating the second face
-                Face second_face {};
-
-                // Pushing the data in the faces
-                for(int i = 0; i < 3; i++) {
-                    // Creating vertices for the first face
-                    first_face.vertices[i].coordinates = & this->vertices_coordinates[starting_index + first_indexes[i]];
-
-                    // Creating vertices for the second triangle
-                    second_face.vertices[i].coordinates = & this->vertices_coordinates[starting_index + second_indexes[i]];
-                }
-
-                // Pushing the faces
-                current_object.faces.push_back(first_face);
-                current_object.faces.push_back(second_face);
+                // Combining multiple octaves of Perlin noise
+                perlin_noise->FractalNoiseBatch<batch_size>(x, y, z, heights, noise_parameters);
 
-                // Increasing the amount of primitives generated
-                primitives_amount +=2;
+                // Storing the vertices
+                for(int lane = 0; lane < batch_size && first_column + lane < columns; lane++)
+                    this->vertices_coordinates[row * columns + first_column + lane] =
+                        glm::vec3(x[lane], heights[lane], z[lane]);
             }
         }
 
-        // Pushing the current object
-        this->objects.push_back(current_object);
+        // Creating the two triangles of each cell
+        constexpr int triangles [2][3] {{0, 1, 2}, {2, 1, 3}};
+        buildGridFaces(rows, columns, false, triangles, false);
 
         // Printing useful data regarding the terrain statistics
         if(PRINT_PRIMITIVES_AMOUNT)
             PrintGenericMessage("There are " + to_string(primitives_amount) + " primitives within the Perlin Terrain");
 
-        // Printing useful data regarding the terrain creation time
-        current_time = clock() - current_time;
-        if(PRINT_PERLIN_TERRAIN_CREATION_TIME)
-            PrintExecutionTime(current_time, "create the Perlin Terrain");
-
     }
 };
 
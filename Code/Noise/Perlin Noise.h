@@ -21,6 +21,19 @@ constexpr int permutation[] = { 151,160,137,91,90,15,
     138,236,205,93,222,114,67,29,24,72,243,141,128,195,78,66,215,61,156,180
     };
 
+/**
+* Parameters of a fractal noise, made of several octaves of Perlin noise with increasing frequency and decreasing
+* amplitude
+*/
+struct FractalNoiseParameters {
+    int octaves = 6; ///< Amount of octaves
+    float amplitude = 1.0f; ///< Amplitude of the first octave
+    float frequency = 1.0f; ///< Frequency of the first octave
+    float gain = 0.5f; ///< Multiplier applied to the amplitude at each octave
+    float lacunarity = 2.0f; ///< Multiplier applied to the frequency at each octave
+    bool turbulence = false; ///< Flag indicating weather or not use the absolute noise instead of the [0, 1] mapping
+};
+
 class PerlinNoise {
     static PerlinNoise * instance; ///< Pointer to the instance of the Singleton
 
@@ -37,46 +50,41 @@ class PerlinNoise {
     }
 
     /**
-    * Increments the given value while handling the overflows
+    * Computes the gradient value of the given hash and coordinates without branches, selecting the two gradient
+    * components through masks and flipping their sign through the two lowest bits of the hash
     */
-    static int Increment(const int value) {
-        // TODO: repeat
-        return (value + 1) & 255;
+    static float Gradient(const int hash, const float x, const float y, const float z) {
+        const int h = hash & 0xF;
+
+        // Selecting the components, hashes 12 and 14 using x in place of z
+        const float u = h < 8 ? x : y;
+        const float v = h < 4 ? y : (h == 12 || h == 14 ? x : z);
+
+        // Flipping the sign of the components
+        return bit_cast<float>(bit_cast<uint32_t>(u) ^ static_cast<uint32_t>(h & 1) << 31)
+             + bit_cast<float>(bit_cast<uint32_t>(v) ^ static_cast<uint32_t>(h & 2) << 30);
     }
 
     /**
-    * Computed the gradient value of the given hash and coordinates
+    * Rounds down to an integer through truncation, which unlike floor does not need SSE4.1 to be vectorized
     */
-    static double Gradient(const int hash, const double x, const double y, const double z) {
-        switch (hash & 0xF) {
-            case 0x0: return  x + y;
-            case 0x1: return -x + y;
-            case 0x2: return  x - y;
-            case 0x3: return -x - y;
-            case 0x4: return  x + z;
-            case 0x5: return -x + z;
-            case 0x6: return  x - z;
-            case 0x7: return -x - z;
-            case 0x8: return  y + z;
-            case 0x9: return -y + z;
-            case 0xA: return  y - z;
-            case 0xB: return -y - z;
-            case 0xC: return  y + x;
-            case 0xD: return -y + z;
-            case 0xE: return  y - x;
-            case 0xF: return -y - z;
-            default: return 0;
-        }
+    static int FloorToInt(const float value) {
+        const int truncated = static_cast<int>(value);
+        return truncated - (value < static_cast<float>(truncated));
     }
 
-    static glm::vec3 Gradient(const int hash){
-        const static glm::vec3 gradients[16] = {
-            { 1, 1, 0}, {-1, 1, 0}, { 1,-1, 0}, {-1,-1, 0},
-            { 1, 0, 1}, {-1, 0, 1}, { 1, 0,-1}, {-1, 0,-1},
-            { 0, 1, 1}, { 0,-1, 1}, { 0, 1,-1}, { 0,-1,-1},
-            { 1, 1, 0}, { 0,-1, 1}, {-1, 1, 0}, { 0,-1,-1}
-        };
-        return gradients[hash & 0xF];
+    /**
+    * Smoothstep of the interpolation weights, in single precision
+    */
+    static float FadeWeight(const float weight) {
+        return weight * weight * weight * (weight * (weight * 6.0f - 15.0f) + 10.0f);
+    }
+
+    /**
+    * Linear interpolation, in single precision
+    */
+    static float LerpWeight(const float first_value, const float second_value, const float weight) {
+        return first_value + weight * (second_value - first_value);
     }
 
 public:
@@ -86,115 +94,173 @@ public:
     */
     static PerlinNoise * getInstance();
 
+    /**
+    * Generates the signed Perlin noise, within range [-1, 1], of a batch of points. The points are processed as SIMD
+    * lanes, meant to be 4, 8 or 16 to fill the vector registers
+    * @tparam BATCH_SIZE The amount of points
+    * @param x The X coordinates of the points
+    * @param y The Y coordinates of the points
+    * @param z The Z coordinates of the points
+    * @param noise The noise of each point
+    */
+    template <int BATCH_SIZE>
+    void SignedNoiseBatch(const float * x, const float * y, const float * z, float * noise) const {
+        #pragma omp simd
+        for(int lane = 0; lane < BATCH_SIZE; lane++) {
+            // Computing the unitary coordinates of the cube
+            const int floor_x = FloorToInt(x[lane]);
+            const int floor_y = FloorToInt(y[lane]);
+            const int floor_z = FloorToInt(z[lane]);
+            const int unit_x = floor_x & 255;
+            const int unit_y = floor_y & 255;
+            const int unit_z = floor_z & 255;
+
+            // Computing the floating components of coordinates, used to extrapolate the weights
+            const float decimal_x = x[lane] - static_cast<float>(floor_x);
+            const float decimal_y = y[lane] - static_cast<float>(floor_y);
+            const float decimal_z = z[lane] - static_cast<float>(floor_z);
+
+            // Computing the weights of each axis
+            const float x_weight = FadeWeight(decimal_x);
+            const float y_weight = FadeWeight(decimal_y);
+            const float z_weight = FadeWeight(decimal_z);
+
+            // Computing the hashed valued for each vertex of the cube, the double sized table handling the overflows
+            const int hash_0 = hash[unit_x] + unit_y;
+            const int hash_1 = hash[unit_x + 1] + unit_y;
+            const int hash_00 = hash[hash_0] + unit_z;
+            const int hash_01 = hash[hash_0 + 1] + unit_z;
+            const int hash_10 = hash[hash_1] + unit_z;
+            const int hash_11 = hash[hash_1 + 1] + unit_z;
+
+            // Computing the final value using linear interpolation smoothed with precomputed weights
+            const float y1 = LerpWeight(
+                LerpWeight(Gradient(hash[hash_00], decimal_x, decimal_y, decimal_z),
+                           Gradient(hash[hash_10], decimal_x - 1, decimal_y, decimal_z), x_weight),
+                LerpWeight(Gradient(hash[hash_01], decimal_x, decimal_y - 1, decimal_z),
+                           Gradient(hash[hash_11], decimal_x - 1, decimal_y - 1, decimal_z), x_weight),
+                y_weight);
+            const float y2 = LerpWeight(
+                LerpWeight(Gradient(hash[hash_00 + 1], decimal_x, decimal_y, decimal_z - 1),
+                           Gradient(hash[hash_10 + 1], decimal_x - 1, decimal_y, decimal_z - 1), x_weight),
+                LerpWeight(Gradient(hash[hash_01 + 1], decimal_x, decimal_y - 1, decimal_z - 1),
+                           Gradient(hash[hash_11 + 1], decimal_x - 1, decimal_y - 1, decimal_z - 1), x_weight),
+                y_weight);
+
+            noise[lane] = LerpWeight(y1, y2, z_weight);
+        }
+    }
+
+    /**
+    * Generates the fractal noise of a batch of points, evaluating every octave on all the points at once
+    * @tparam BATCH_SIZE The amount of points, meant to be 4, 8 or 16
+    * @param x The X coordinates of the points
+    * @param y The Y coordinates of the points
+    * @param z The Z coordinates of the points
+    * @param noise The noise of each point
+    * @param parameters The parameters of the fractal noise
+    */
+    template <int BATCH_SIZE>
+    void FractalNoiseBatch(const float * x, const float * y, const float * z, float * noise,
+        const FractalNoiseParameters & parameters) const {
+        // Initializing the scaled coordinates and the octave noise
+        alignas(64) float octave_x[BATCH_SIZE], octave_y[BATCH_SIZE], octave_z[BATCH_SIZE];
+        alignas(64) float octave_noise[BATCH_SIZE];
+
+        // Resetting the noise
+        for(int lane = 0; lane < BATCH_SIZE; lane++)
+            noise[lane] = 0.0f;
+
+        float amplitude = parameters.amplitude;
+        float frequency = parameters.frequency;
+        for(int octave = 0; octave < parameters.octaves; octave++) {
+            // Scaling the points to the frequency of the octave
+            #pragma omp simd
+            for(int lane = 0; lane < BATCH_SIZE; lane++) {
+                octave_x[lane] = frequency * x[lane];
+                octave_y[lane] = frequency * y[lane];
+                octave_z[lane] = frequency * z[lane];
+            }
+
+            SignedNoiseBatch<BATCH_SIZE>(octave_x, octave_y, octave_z, octave_noise);
+
+            // Accumulating the octave, mapped to range [0, 1]
+            #pragma omp simd
+            for(int lane = 0; lane < BATCH_SIZE; lane++)
+                noise[lane] += amplitude * (parameters.turbulence ? abs(octave_noise[lane])
+                                                                  : (octave_noise[lane] + 1.0f) * 0.5f);
+
+            amplitude *= parameters.gain;
+            frequency *= parameters.lacunarity;
+        }
+    }
+
+    /**
+    * Generates the fractal noise of a single point, evaluating its octaves as SIMD lanes
+    * @param point The point
+    * @param parameters The parameters of the fractal noise
+    * @return The noise of the point
+    */
+    [[nodiscard]] float FractalNoise(const glm::vec3 point, const FractalNoiseParameters & parameters) const {
+        constexpr int batch_size = 8;
+        alignas(32) float octave_x[batch_size], octave_y[batch_size], octave_z[batch_size];
+        alignas(32) float octave_noise[batch_size];
+        alignas(32) float octave_amplitude[batch_size];
+
+        float noise = 0.0f;
+        float amplitude = parameters.amplitude;
+        float frequency = parameters.frequency;
+        for(int first_octave = 0; first_octave < parameters.octaves; first_octave += batch_size) {
+            // Scaling the point to the frequency of each octave, the lanes past the last octave having no weight
+            for(int lane = 0; lane < batch_size; lane++) {
+                const bool is_octave = first_octave + lane < parameters.octaves;
+                octave_x[lane] = frequency * point.x;
+                octave_y[lane] = frequency * point.y;
+                octave_z[lane] = frequency * point.z;
+                octave_amplitude[lane] = is_octave ? amplitude : 0.0f;
+
+                amplitude *= parameters.gain;
+                frequency *= parameters.lacunarity;
+            }
+
+            SignedNoiseBatch<batch_size>(octave_x, octave_y, octave_z, octave_noise);
+
+            // Accumulating the octaves, mapped to range [0, 1]
+            #pragma omp simd reduction(+:noise)
+            for(int lane = 0; lane < batch_size; lane++)
+                noise += octave_amplitude[lane] * (parameters.turbulence ? abs(octave_noise[lane])
+                                                                         : (octave_noise[lane] + 1.0f) * 0.5f);
+        }
+
+        return noise;
+    }
+
     /**
     * Generates perlin noise value within range [0, 1] for the given coordinates
     * @param x The X coordinate of the requested value
     * @param y The Y coordinates of the requested value
     * @param z The Z coordinates of the requested value
-    * @return A double representing the value of the function in point (x, y, z)
+    * @return A float representing the value of the function in point (x, y, z)
     */
-    [[nodiscard]] double Noise(const double x, const double y, const double z) const {
-        // TODO: Include repeat
-
-        // Computing the unitary coordinates of the cube
-        const int unit_x = static_cast<int>(floor(x)) & 255;
-        const int unit_y = static_cast<int>(floor(y)) & 255;
-        const int unit_z = static_cast<int>(floor(z)) & 255;
-
-        // Computing the floating components of coordinates, used to extrapolate the weights
-        const double decimal_x = x - floor(x);
-        const double decimal_y = y - floor(y);
-        const double decimal_z = z - floor(z);
-
-        // Computing the weights of each axis
-        const double x_weight = Fade(decimal_x);
-        const double y_weight = Fade(decimal_y);
-        const double z_weight = Fade(decimal_z);
-
-        // Computing the hashed valued for each vertex of the cube
-        const int dot_000 = hash[hash[hash[unit_x           ] + unit_y           ] + unit_z           ];
-        const int dot_001 = hash[hash[hash[unit_x           ] + unit_y           ] + Increment(unit_z)];
-        const int dot_010 = hash[hash[hash[unit_x           ] + Increment(unit_y)] + unit_z           ];
-        const int dot_011 = hash[hash[hash[unit_x           ] + Increment(unit_y)] + Increment(unit_z)];
-        const int dot_100 = hash[hash[hash[Increment(unit_x)] + unit_y           ] + unit_z           ];
-        const int dot_101 = hash[hash[hash[Increment(unit_x)] + unit_y           ] + Increment(unit_z)];
-        const int dot_110 = hash[hash[hash[Increment(unit_x)] + Increment(unit_y)] + unit_z           ];
-        const int dot_111 = hash[hash[hash[Increment(unit_x)] + Increment(unit_y)] + Increment(unit_z)];
-
-        // Computing the final value using linear interpolation smoothed with precomputed weights
-        double x1 = Lerp(Gradient(dot_000, decimal_x, decimal_y, decimal_z),
-                         Gradient(dot_100, decimal_x - 1, decimal_y, decimal_z),
-                         x_weight);
-
-        double x2 = Lerp(Gradient(dot_010, decimal_x, decimal_y - 1, decimal_z),
-                         Gradient(dot_110, decimal_x - 1, decimal_y - 1, decimal_z),
-                         x_weight);
-
-        const double y1 = Lerp(x1, x2, y_weight);
-
-        x1 = Lerp(Gradient(dot_001, decimal_x, decimal_y, decimal_z - 1),
-            Gradient(dot_101, decimal_x - 1, decimal_y, decimal_z - 1),
-            x_weight);
-        x2 = Lerp(Gradient(dot_011, decimal_x, decimal_y - 1, decimal_z - 1),
-            Gradient(dot_111, decimal_x - 1, decimal_y - 1, decimal_z - 1),
-            x_weight);
-
-        const double y2 = Lerp(x1, x2, y_weight);
+    [[nodiscard]] float Noise(const float x, const float y, const float z) const {
+        float noise;
+        SignedNoiseBatch<1>(& x, & y, & z, & noise);
 
         // Computing final noise value (mapping to range [0, 1])
-        return (Lerp(y1, y2, z_weight) + 1) / 2;
+        return (noise + 1) / 2;
     }
 
-    [[nodiscard]] double StringNoise(const double x, const double y, const double z) const {
-        // TODO: Include repeat
-
-        // Computing the unitary coordinates of the cube
-        const int unit_x = static_cast<int>(floor(x)) & 255;
-        const int unit_y = static_cast<int>(floor(y)) & 255;
-        const int unit_z = static_cast<int>(floor(z)) & 255;
-
-        // Computing the floating components of coordinates, used to extrapolate the weights
-        const double decimal_x = x - floor(x);
-        const double decimal_y = y - floor(y);
-        const double decimal_z = z - floor(z);
-
-        // Computing the weights of each axis
-        const double x_weight = Fade(decimal_x);
-        const double y_weight = Fade(decimal_y);
-        const double z_weight = Fade(decimal_z);
-
-        // Computing the hashed valued for each vertex of the cube
-        const int dot_000 = hash[hash[hash[unit_x           ] + unit_y           ] + unit_z           ];
-        const int dot_001 = hash[hash[hash[unit_x           ] + unit_y           ] + Increment(unit_z)];
-        const int dot_010 = hash[hash[hash[unit_x           ] + Increment(unit_y)] + unit_z           ];
-        const int dot_011 = hash[hash[hash[unit_x           ] + Increment(unit_y)] + Increment(unit_z)];
-        const int dot_100 = hash[hash[hash[Increment(unit_x)] + unit_y           ] + unit_z           ];
-        const int dot_101 = hash[hash[hash[Increment(unit_x)] + unit_y           ] + Increment(unit_z)];
-        const int dot_110 = hash[hash[hash[Increment(unit_x)] + Increment(unit_y)] + unit_z           ];
-        const int dot_111 = hash[hash[hash[Increment(unit_x)] + Increment(unit_y)] + Increment(unit_z)];
-
-        // Computing the final value using linear interpolation smoothed with precomputed weights
-        double x1 = Lerp(Gradient(dot_000, decimal_x, decimal_y, decimal_z),
-                         Gradient(dot_100, decimal_x - 1, decimal_y, decimal_z),
-                         x_weight);
-
-        double x2 = Lerp(Gradient(dot_010, decimal_x, decimal_y - 1, decimal_z),
-                         Gradient(dot_110, decimal_x - 1, decimal_y - 1, decimal_z),
-                         x_weight);
-
-        const double y1 = Lerp(x1, x2, y_weight);
-
-        x1 = Lerp(Gradient(dot_001, decimal_x, decimal_y, decimal_z - 1),
-            Gradient(dot_101, decimal_x - 1, decimal_y, decimal_z - 1),
-            x_weight);
-        x2 = Lerp(Gradient(dot_011, decimal_x, decimal_y - 1, decimal_z - 1),
-            Gradient(dot_111, decimal_x - 1, decimal_y - 1, decimal_z - 1),
-            x_weight);
-
-        const double y2 = Lerp(x1, x2, y_weight);
-
-        // Computing final noise value (mapping to range [0, 1])
-        return abs(Lerp(y1, y2, z_weight));
+    /**
+    * Generates the absolute perlin noise value, within range [0, 1], for the given coordinates
+    * @param x The X coordinate of the requested value
+    * @param y The Y coordinates of the requested value
+    * @param z The Z coordinates of the requested value
+    * @return A float representing the value of the function in point (x, y, z)
+    */
+    [[nodiscard]] float StringNoise(const float x, const float y, const float z) const {
+        float noise;
+        SignedNoiseBatch<1>(& x, & y, & z, & noise);
+        return abs(noise);
     }
 
     /**
@@ -204,49 +270,45 @@ public:
     * @param starting_amplitude The starting amplitude
     * @param starting_frequency The starting frequency
     * @param layers The amount of layers
-    * @return A double vector sized width * height containing the texture
+    * @return An array of floats sized width * height containing the texture, to be freed by the caller
     */
     [[nodiscard]] float * GenerateFractalNoiseTexture(const unsigned int width, const unsigned int height,
         const float starting_amplitude, const float starting_frequency, const unsigned int layers) const {
         // Initializing the texture
         const auto texture = new float [width * height];
 
-        // Initializing auxiliary constants
-        const float amplitude_multiplier = 0.35;
-        const float frequency_multiplier = 1.8;
-
-        // Initializing data
-        float max_noise = -INFINITY;
-
-        // Creating the texture
-        for(unsigned int i = 0; i < width; i++) {
-            for(unsigned int j = 0; j < height; j++) {
-                // Generating current point in the Perlin space
-                auto point = glm::vec3(i, j, 0) * starting_frequency;
-
-                // Resetting the amplitude
-                float amplitude = starting_amplitude;
-
-                // Computing Perlin Noise at all layers
-                for(unsigned int k = 0; k < layers; k++) {
-                    // Extracting the noise
-                    const float noise = StringNoise(point.x, point.y, point.z) * amplitude;
-
-                    // Adding the current layer to the texture
-                    texture [i + j * width] += noise;
-                    // Applying frequency multipliers to the point (increasing frequency)
-                    point *= frequency_multiplier;
-                    // Applying multiplier to the amplitude (reducing amplitude)
-                    amplitude *= amplitude_multiplier;
+        // Initializing the fractal noise parameters
+        const FractalNoiseParameters parameters {
+            .octaves = static_cast<int>(layers),
+            .amplitude = starting_amplitude,
+            .frequency = starting_frequency,
+            .gain = 0.35f,
+            .lacunarity = 1.8f,
+            .turbulence = true
+        };
+
+        // Creating the texture, a batch of texels of a row at a time
+        constexpr int batch_size = 8;
+        alignas(32) float x[batch_size], y[batch_size], z[batch_size] {};
+        alignas(32) float noise[batch_size];
+        for(unsigned int j = 0; j < height; j++) {
+            for(unsigned int i = 0; i < width; i += batch_size) {
+                // Generating current points, the ones past the row end being discarded
+                for(int lane = 0; lane < batch_size; lane++) {
+                    x[lane] = static_cast<float>(i + lane);
+                    y[lane] = static_cast<float>(j);
                 }
 
-                // Updating the max value
-                if(texture[i + j * width] > max_noise)
-                    max_noise = texture[i + j * width];
+                FractalNoiseBatch<batch_size>(x, y, z, noise, parameters);
+
+                // Storing the noise
+                for(unsigned int lane = 0; lane < batch_size && i + lane < width; lane++)
+                    texture[i + lane + j * width] = noise[lane];
             }
         }
 
         // Mapping the noise to the range [0,1]
+        const float max_noise = * max_element(texture, texture + width * height);
         for(unsigned int i = 0; i < width * height; i++)
             texture[i] /= max_noise;
 
@@ -265,8 +327,4 @@ inline PerlinNoise * PerlinNoise::getInstance()  {
     return instance;
 }
 
-inline void PerlinTest(){
-    float test_noise = PerlinNoise::getInstance()->Noise(255, 255, 255);
-}
-
 #endif //PERLIN_NOISE_H
\ No newline at end of file
@@ -62,6 +62,18 @@ inline KDTreeNode * buildKDTree(std::vector<Photon>& photons, const int depth =
     return node;
 }
 
+// Function to free the KD-Tree
+inline void deleteKDTree(const KDTreeNode * node) {
+    // Case in which the subtree is empty
+    if (node == nullptr)
+        return;
+
+    // Recursively free the subtrees, then the node
+    deleteKDTree(node->left);
+    deleteKDTree(node->right);
+    delete node;
+}
+
 // Struct for priority queue entries
 struct Neighbor {
     Photon photon;
@@ -79,6 +91,9 @@ inline void findNearestNeighbors(KDTreeNode* node, const glm::vec3& queryPoint,
                                  int n, int depth = 0) {
     if (!node) return;
 
+    // Counting the visited photon
+    countStatistic(KNN_PHOTONS_TOUCHED);
+
     // Get the current axis based on the depth
     int axis = depth % 3; // 0 = x, 1 = y, 2 = z
 
@@ -118,6 +133,9 @@ inline void findNearestNeighbors(KDTreeNode* node, const glm::vec3& queryPoint,
 
 // Function to get the nearest neighbors from the max-heap
 inline std::vector<Photon> getNearestNeighbors(KDTreeNode* root, const glm::vec3& queryPoint, int n) {
+    // Counting the query
+    countStatistic(KNN_QUERIES);
+
     std::priority_queue<Neighbor> maxHeap;
     findNearestNeighbors(root, queryPoint, maxHeap, n);
 
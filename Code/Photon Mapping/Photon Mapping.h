@@ -12,112 +12,138 @@ inline void traceIndirectPhotons() {
     }
 };
 
-inline void traceCausticsPhotons() {
-    PrintStartingProcess("tracing of caustics photons");
+/**
+* A primitive towards which the caustics photons are shot
+*/
+struct CausticTarget {
+    glm::vec3 origin; ///< The global origin of the primitive
+    float size; ///< Approximation of the size of the primitive
+};
 
-    // Storing the starting time for KD Tree building
-    clock_t current_time = clock();
+/**
+* Function that gathers the refractive and reflective primitives the caustics photons are shot towards. It is called
+* before building the SDS, which may page the primitives out of the scene
+* @return The targets of the caustics photons
+*/
+inline vector<CausticTarget> collectCausticTargets() {
+    vector<CausticTarget> targets;
 
     // Iterating all primitives looking for refractive and reflective materials
     for(const auto & primitive : primitives) {
         // Extracting e the surface material
         const Material & primitive_material = primitive->getMaterial();
+        if(primitive_material.refractivity <= 0 && primitive_material.reflectivity <= 0)
+            continue;
+
+        // Computing an approximation of the primitive size
+        const auto primitive_diagonal = primitive->getWorldSpaceBoundingBox().getDiagonal();
+        targets.push_back({
+            .origin = primitive->global_origin,
+            .size = max(primitive_diagonal.x, max(primitive_diagonal.y, primitive_diagonal.z)) / 2.0f
+        });
+    }
 
-        // If the material is either refractive or reflective, shoot photons towards primitive
-        if(primitive_material.refractivity > 0 || primitive_material.reflectivity > 0) {
-            for (auto & light : directional_lights) {
-                // Constants used to generate photons
-                constexpr int polar_increment = 10;
-                constexpr int radius_samples_amount = 10;
+    return targets;
+}
 
-                // Computing the total amount of photons emitted
-                constexpr int photons_amount = (360 / polar_increment) * radius_samples_amount;
+/**
+* Function that traces the caustics photons
+* @param targets The primitives the photons are shot towards, gathered before building the SDS
+*/
+inline void traceCausticsPhotons(const vector<CausticTarget> & targets) {
+    PrintStartingProcess("tracing of caustics photons");
 
-                // Computing starting direction of all rays
-                const glm::vec3 starting_vector = primitive->global_origin - light->global_origin;
+    // Measuring the photons tracing time
+    const ProfilerScope profiler_scope("trace the caustics photons", "build", true);
 
-                // Computing normal of the plane having origin in the primitive and normal the normalized
-                // vector going from the origin to the light source
-                const glm::vec3 normal = normalize(light->global_origin - primitive->global_origin);
+    // Iterating the refractive and reflective primitives
+    for(const auto & target : targets) {
+        for (auto & light : directional_lights) {
+            // Constants used to generate photons
+            constexpr int polar_increment = 10;
+            constexpr int radius_samples_amount = 10;
 
-                // Choosing a reference vector (x-axis or z-axis)
-                glm::vec3 reference (1.0f, 0.0f, 0.0f);
+            // Computing the total amount of photons emitted
+            constexpr int photons_amount = (360 / polar_increment) * radius_samples_amount;
 
-                // Handling the case where the normal is close to the reference
-                if (glm::abs(dot(normal, reference)) > 0.99f) {
-                    // Switch to z-axis if the normal is nearly parallel to x-axis
-                    reference = glm::vec3(0.0f, 0.0f, 1.0f);
-                }
+            // Computing starting direction of all rays
+            const glm::vec3 starting_vector = target.origin - light->global_origin;
+
+            // Computing normal of the plane having origin in the primitive and normal the normalized
+            // vector going from the origin to the light source
+            const glm::vec3 normal = normalize(light->global_origin - target.origin);
+
+            // Choosing a reference vector (x-axis or z-axis)
+            glm::vec3 reference (1.0f, 0.0f, 0.0f);
+
+            // Handling the case where the normal is close to the reference
+            if (glm::abs(dot(normal, reference)) > 0.99f) {
+                // Switch to z-axis if the normal is nearly parallel to x-axis
+                reference = glm::vec3(0.0f, 0.0f, 1.0f);
+            }
+
+            // Computing the tangent using Gram-Schmidt
+            const auto tangent = normalize(reference - dot(reference, normal) * normal);
+
+            // Computing the bitangent as the cross product of the normal and tangent
+            const auto bitangent = glm::normalize(glm::cross(normal, tangent));
+
+            // Initializing the tangent space transformation matrix
+            const glm::mat3 tangent_to_world (tangent, bitangent, normal);
 
-                // Computing the tangent using Gram-Schmidt
-                const auto tangent = normalize(reference - dot(reference, normal) * normal);
-
-                // Computing the bitangent as the cross product of the normal and tangent
-                const auto bitangent = glm::normalize(glm::cross(normal, tangent));
-
-                // Initializing the tangent space transformation matrix
-                const glm::mat3 tangent_to_world (tangent, bitangent, normal);
-
-                // Initializing the world to tangent space transformation matrix (since it is orthonormal it's just
-                // the transpose)
-                const glm::mat3 world_to_tangent = glm::transpose(tangent_to_world);
-
-                // Computing an approximation of the primitive size
-                const auto primitive_diagonal = primitive->getWorldSpaceBoundingBox().getDiagonal();
-                const float primitive_size = max(primitive_diagonal.x,
-                    max(primitive_diagonal.y, primitive_diagonal.z)) / 2.0f;
-
-                // Generating the photons
-                for(int current_radius = 1; current_radius <= radius_samples_amount; current_radius++) {
-                    for(int current_polar = 0; current_polar < 360; current_polar += polar_increment) {
-                        // Computing the radians value of current polar angle
-                        const float current_polar_radians = glm::radians(static_cast<float>(current_polar));
-
-                        // Computing the normalized value of the current radius
-                        const float current_radius_normalized = static_cast<float>(current_radius)
-                                                                    / static_cast<float>(radius_samples_amount);
-
-                        // Computing the coordinates of the current perturbance
-                        glm::vec3 current_perturbance (
-                            current_radius_normalized * glm::cos(current_polar_radians) * primitive_size * 1.25,
-                            0,
-                            current_radius_normalized * glm::sin(current_polar_radians) * primitive_size * 1.25
-                            );
-
-                        // Applying the world to tangent space transformation matrix
-                        current_perturbance = world_to_tangent * current_perturbance;
-
-                        // Computing the new direction
-                        const glm::vec3 photon_direction = normalize(starting_vector + current_perturbance);
-
-                        // Computing the photon intensity
-                        const glm::vec3 photon_intensity = light->getLightIntensity()
-                                                            / static_cast<float>(photons_amount);
-
-                        // Initializing the photon ray
-                        const Ray photon_ray{
-                            .origin = light->getGlobalOrigin() + 1e-4f * light->global_normal,
-                            .direction = photon_direction,
-                            .current_medium_refraction_index = 1.0f
-                        };
-
-                        // Initializing the photon with adjusted intensity
-                        const Photon current_photon{
-                            .ray = photon_ray,
-                            .intensity = photon_intensity
-                        };
-
-                        // Tracing the photon through the scene
-                        tracePhoton(current_photon, 0);
-                    }
+            // Initializing the world to tangent space transformation matrix (since it is orthonormal it's just
+            // the transpose)
+            const glm::mat3 world_to_tangent = glm::transpose(tangent_to_world);
+
+            const float primitive_size = target.size;
+
+            // Generating the photons
+            for(int current_radius = 1; current_radius <= radius_samples_amount; current_radius++) {
+                for(int current_polar = 0; current_polar < 360; current_polar += polar_increment) {
+                    // Computing the radians value of current polar angle
+                    const float current_polar_radians = glm::radians(static_cast<float>(current_polar));
+
+                    // Computing the normalized value of the current radius
+                    const float current_radius_normalized = static_cast<float>(current_radius)
+                                                                / static_cast<float>(radius_samples_amount);
+
+                    // Computing the coordinates of the current perturbance
+                    glm::vec3 current_perturbance (
+                        current_radius_normalized * glm::cos(current_polar_radians) * primitive_size * 1.25,
+                        0,
+                        current_radius_normalized * glm::sin(current_polar_radians) * primitive_size * 1.25
+                        );
+
+                    // Applying the world to tangent space transformation matrix
+                    current_perturbance = world_to_tangent * current_perturbance;
+
+                    // Computing the new direction
+                    const glm::vec3 photon_direction = normalize(starting_vector + current_perturbance);
+
+                    // Computing the photon intensity
+                    const glm::vec3 photon_intensity = light->getLightIntensity()
+                                                        / static_cast<float>(photons_amount);
+
+                    // Initializing the photon ray
+                    const Ray photon_ray{
+                        .origin = light->getGlobalOrigin() + 1e-4f * light->global_normal,
+                        .direction = photon_direction,
+                        .current_medium_refraction_index = 1.0f
+                    };
+
+                    // Initializing the photon with adjusted intensity
+                    const Photon current_photon{
+                        .ray = photon_ray,
+                        .intensity = photon_intensity
+                    };
+
+                    // Tracing the photon through the scene
+                    tracePhoton(current_photon, 0);
                 }
             }
         }
     }
 
-    // Printing execution time
-    PrintExecutionTime(clock() - current_time, "trace the caustics photons");
-
     // Printing the amount of caustics photons
     cout << "Amount of caustics photons : " << caustic_photons.size() << endl;
 };
@@ -0,0 +1,324 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef HEIGHTFIELD_H
+#define HEIGHTFIELD_H
+
+/**
+* Terrain made of a regular grid of heights over the local XZ plane, each cell split in two triangles. Only the heights
+* and a min/max quadtree over the cells are stored, and rays march the quadtree front to back down to the cells,
+* instead of going through a triangle per cell in the BVH
+*/
+class Heightfield : public Primitive {
+    static constexpr int MAX_LEVELS = 32; ///< Upper bound of the amount of quadtree levels
+
+    int samples_x; ///< Amount of samples along X
+    int samples_z; ///< Amount of samples along Z
+    float cell_size; ///< Distance between adjacent samples
+    glm::vec2 grid_origin; ///< Local XZ coordinates of the first sample
+
+    vector<float> heights; ///< The heights, in rows of samples_x samples along X
+    vector<glm::ivec2> levels_size; ///< Amount of nodes along X and Z at each level, level 0 being the cells
+    vector<vector<glm::vec2>> levels_bounds; ///< Min and max height of the nodes at each level, empty at level 0
+
+    /**
+    * Returns the height of a sample
+    */
+    [[nodiscard]] float getHeight(const int x, const int z) const {
+        return heights[z * samples_x + x];
+    }
+
+    /**
+    * Returns the local coordinates of a sample
+    */
+    [[nodiscard]] glm::vec3 getSamplePoint(const int x, const int z) const {
+        return {grid_origin.x + static_cast<float>(x) * cell_size, getHeight(x, z),
+                grid_origin.y + static_cast<float>(z) * cell_size};
+    }
+
+    /**
+    * Returns the min and max height of a quadtree node, computed from the corners of the cells at level 0
+    * @param level The level of the node
+    * @param x The index of the node along X
+    * @param z The index of the node along Z
+    */
+    [[nodiscard]] glm::vec2 getNodeBounds(const int level, const int x, const int z) const {
+        // Case in which the node is a cell
+        if(level == 0) {
+            const float first = getHeight(x, z), second = getHeight(x + 1, z);
+            const float third = getHeight(x, z + 1), fourth = getHeight(x + 1, z + 1);
+            return {min(min(first, second), min(third, fourth)), max(max(first, second), max(third, fourth))};
+        }
+
+        return levels_bounds[level][z * levels_size[level].x + x];
+    }
+
+    /**
+    * Builds the min/max quadtree bottom up, each node covering up to 2x2 nodes of the level below
+    */
+    void buildQuadtree() {
+        // Initializing the cells level, whose bounds are computed on the fly
+        levels_size.emplace_back(samples_x - 1, samples_z - 1);
+        levels_bounds.emplace_back();
+
+        while(levels_size.back().x > 1 || levels_size.back().y > 1) {
+            const int child_level = static_cast<int>(levels_size.size()) - 1;
+            const glm::ivec2 child_size = levels_size.back();
+            const glm::ivec2 size = (child_size + 1) / 2;
+
+            // Merging the bounds of the children
+            vector<glm::vec2> bounds(size.x * size.y, glm::vec2(INFINITY, -INFINITY));
+            for(int z = 0; z < child_size.y; z++)
+                for(int x = 0; x < child_size.x; x++) {
+                    const glm::vec2 child_bounds = getNodeBounds(child_level, x, z);
+                    glm::vec2 & node_bounds = bounds[z / 2 * size.x + x / 2];
+                    node_bounds = {min(node_bounds.x, child_bounds.x), max(node_bounds.y, child_bounds.y)};
+                }
+
+            levels_size.push_back(size);
+            levels_bounds.push_back(std::move(bounds));
+        }
+    }
+
+    /**
+    * Intersects a local ray with a triangle, using the Moller-Trumbore algorithm
+    * @return The distance along the ray, INFINITY if missed
+    */
+    static float intersectTriangle(const Ray & ray, const glm::vec3 & first, const glm::vec3 & second,
+        const glm::vec3 & third) {
+        countStatistic(TRIANGLE_TESTS);
+
+        // Computing the determinant
+        const glm::vec3 first_edge = second - first;
+        const glm::vec3 second_edge = third - first;
+        const glm::vec3 p = cross(ray.direction, second_edge);
+        const float determinant = dot(first_edge, p);
+        if(abs(determinant) < 1e-12f)
+            return INFINITY;
+
+        // Computing the barycentric coordinates
+        const float inverse_determinant = 1.0f / determinant;
+        const glm::vec3 origin_offset = ray.origin - first;
+        const float u = dot(origin_offset, p) * inverse_determinant;
+        if(u < 0.0f || u > 1.0f)
+            return INFINITY;
+        const glm::vec3 q = cross(origin_offset, first_edge);
+        const float v = dot(ray.direction, q) * inverse_determinant;
+        if(v < 0.0f || u + v > 1.0f)
+            return INFINITY;
+
+        // Verifying that the triangle is in front of the ray
+        const float lambda = dot(second_edge, q) * inverse_determinant;
+        return lambda > 1e-6f ? lambda : INFINITY;
+    }
+
+    void computeMinMaxGlobal() override {
+        // Transforming the eight corners of the local bounding box
+        for(int i = 0; i < 8; i++) {
+            const glm::vec3 corner((i & 1 ? max_local_coord : min_local_coord).x,
+                                   (i & 2 ? max_local_coord : min_local_coord).y,
+                                   (i & 4 ? max_local_coord : min_local_coord).z);
+            const glm::vec3 global_corner = transform * glm::vec4(corner, 1);
+            min_global_coord = glm::min(min_global_coord, global_corner);
+            max_global_coord = glm::max(max_global_coord, global_corner);
+        }
+    }
+
+    bool computeSurfaceUV(const glm::vec3 & global_point, glm::vec2 & uv_coordinates) const override {
+        // Projecting the local point on the grid
+        const glm::vec3 local_point = inverse_transform * glm::vec4(global_point, 1);
+        uv_coordinates = (glm::vec2(local_point.x, local_point.z) - grid_origin)
+                       / (cell_size * glm::vec2(samples_x - 1, samples_z - 1));
+        return true;
+    }
+
+public:
+    /**
+    * @param transform Transform of the heightfield
+    * @param heights The heights, in rows of samples_x samples along X, centered on the local origin
+    * @param samples_x Amount of samples along X, at least 2
+    * @param samples_z Amount of samples along Z, at least 2
+    * @param cell_size Distance between adjacent samples
+    * @param material Material of the heightfield
+    * @param albedo Pointer to the albedo texture, mapped over the whole grid
+    */
+    Heightfield(const glm::mat4 & transform, vector<float> heights, const int samples_x, const int samples_z,
+        const float cell_size, const Material * material = nullptr, const Texture * albedo = nullptr)
+    : Primitive(transform, material, albedo), samples_x(samples_x), samples_z(samples_z), cell_size(cell_size),
+    grid_origin(-0.5f * cell_size * glm::vec2(samples_x - 1, samples_z - 1)), heights(std::move(heights)) {
+        buildQuadtree();
+
+        // Computing the bounding box from the root bounds
+        const glm::vec2 root_bounds = getNodeBounds(static_cast<int>(levels_size.size()) - 1, 0, 0);
+        min_local_coord = glm::vec3(grid_origin.x, root_bounds.x, grid_origin.y);
+        max_local_coord = glm::vec3(-grid_origin.x, root_bounds.y, -grid_origin.y);
+        computeMinMaxGlobal();
+    }
+
+    /**
+    *  Function that verifies if a global ray intersects the heightfield, descending the quadtree front to back and
+    *  skipping the nodes whose height range the ray misses or that start past the closest hit
+    *  @param global_ray Ray in global coordinates
+    *  @param interaction The interaction struct
+    */
+    void Intersect(const Ray & global_ray, Interaction & interaction) override {
+        // Localizing the ray
+        const Ray local_ray = localizeRay(global_ray);
+        const glm::vec3 reciprocals = 1.0f / local_ray.direction;
+
+        // Ordering the children front to back, starting from the half the ray enters first along each axis
+        const int near_x = local_ray.direction.x < 0 ? 1 : 0;
+        const int near_z = local_ray.direction.z < 0 ? 1 : 0;
+
+        // Initializing the traversal from the root
+        glm::ivec3 stack[3 * MAX_LEVELS + 1];
+        int stack_size = 0;
+        stack[stack_size++] = glm::ivec3(levels_size.size() - 1, 0, 0);
+
+        float closest_lambda = INFINITY;
+        glm::ivec2 closest_cell (0);
+        bool closest_second_triangle = false;
+
+        while(stack_size > 0) {
+            const glm::ivec3 node = stack[--stack_size];
+            const int level = node.x;
+
+            // Computing the bounding box of the node
+            const int node_cells = 1 << level;
+            const glm::vec2 height_bounds = getNodeBounds(level, node.y, node.z);
+            const glm::vec3 node_min(grid_origin.x + static_cast<float>(node.y * node_cells) * cell_size,
+                height_bounds.x, grid_origin.y + static_cast<float>(node.z * node_cells) * cell_size);
+            const glm::vec3 node_max(
+                grid_origin.x + static_cast<float>(min((node.y + 1) * node_cells, samples_x - 1)) * cell_size,
+                height_bounds.y,
+                grid_origin.y + static_cast<float>(min((node.z + 1) * node_cells, samples_z - 1)) * cell_size);
+
+            // Intersecting the bounding box with the slab test
+            const glm::vec3 first_lambdas = (node_min - local_ray.origin) * reciprocals;
+            const glm::vec3 second_lambdas = (node_max - local_ray.origin) * reciprocals;
+            const glm::vec3 near_lambdas = glm::min(first_lambdas, second_lambdas);
+            const glm::vec3 far_lambdas = glm::max(first_lambdas, second_lambdas);
+            const float entry_lambda = max(max(near_lambdas.x, near_lambdas.y), max(near_lambdas.z, 0.0f));
+            const float exit_lambda = min(min(far_lambdas.x, far_lambdas.y), min(far_lambdas.z, closest_lambda));
+            if(entry_lambda > exit_lambda)
+                continue;
+
+            // Case in which the node is a cell, intersecting its two triangles
+            if(level == 0) {
+                const glm::vec3 first = getSamplePoint(node.y, node.z);
+                const glm::vec3 second = getSamplePoint(node.y, node.z + 1);
+                const glm::vec3 third = getSamplePoint(node.y + 1, node.z);
+                const glm::vec3 fourth = getSamplePoint(node.y + 1, node.z + 1);
+
+                if(const float lambda = intersectTriangle(local_ray, first, second, third); lambda < closest_lambda) {
+                    closest_lambda = lambda;
+                    closest_cell = glm::ivec2(node.y, node.z);
+                    closest_second_triangle = false;
+                }
+                if(const float lambda = intersectTriangle(local_ray, third, second, fourth); lambda < closest_lambda) {
+                    closest_lambda = lambda;
+                    closest_cell = glm::ivec2(node.y, node.z);
+                    closest_second_triangle = true;
+                }
+                continue;
+            }
+
+            // Pushing the existing children from back to front, so that the nearest is visited first
+            const glm::ivec2 children_size = levels_size[level - 1];
+            for(int i = 3; i >= 0; i--) {
+                const int child_x = 2 * node.y + ((i & 1) ^ near_x);
+                const int child_z = 2 * node.z + ((i >> 1) ^ near_z);
+                if(child_x < children_size.x && child_z < children_size.y)
+                    stack[stack_size++] = glm::ivec3(level - 1, child_x, child_z);
+            }
+        }
+
+        // Case in which no cell was hit
+        if(closest_lambda == INFINITY)
+            return;
+
+        // Computing the normal of the hit triangle
+        const glm::vec3 first = getSamplePoint(closest_cell.x + (closest_second_triangle ? 1 : 0), closest_cell.y);
+        const glm::vec3 second = getSamplePoint(closest_cell.x, closest_cell.y + 1);
+        const glm::vec3 third = getSamplePoint(closest_cell.x + 1, closest_cell.y + (closest_second_triangle ? 1 : 0));
+        const glm::vec3 normal = normalize(cross(second - first, third - first));
+
+        // Filling the interaction
+        countStatistic(TRIANGLE_HITS);
+        interaction.hit = true;
+        interaction.normal = normal;
+        interaction.intersection = local_ray.origin + closest_lambda * local_ray.direction;
+        interaction.uv_coordinates = (glm::vec2(interaction.intersection.x, interaction.intersection.z) - grid_origin)
+                                   / (cell_size * glm::vec2(samples_x - 1, samples_z - 1));
+        interaction.material = material;
+        interaction.primitive = this;
+
+        // De-localizing the interaction
+        delocalizeInteraction(interaction, global_ray.origin);
+    }
+
+    /**
+    * Return the tangent for this primitive with respect to the given normal, following the local X axis
+    */
+    [[nodiscard]] glm::vec3 computeTangent(const glm::vec3 normal,
+        [[maybe_unused]] const glm::vec3 surface_point) override {
+        const glm::vec3 x_axis = transform * glm::vec4(1, 0, 0, 0);
+        return normalize(x_axis - normal * dot(normal, x_axis));
+    }
+};
+
+/**
+* Builds a heightfield following the fractal Perlin noise, over the same grid used by the Perlin terrain mesh
+* @param transform The heightfield transform
+* @param material The heightfield material
+* @param width The width of the terrain
+* @param depth The depth of the terrain
+* @param noise_frequency The distance between adjacent samples
+* @param noise_amplitude The amplitude of the first octave
+* @param time The time, used as third coordinate of the noise
+*/
+inline void buildPerlinHeightfield(const glm::mat4 & transform, const Material & material, const float width,
+    const float depth, const float noise_frequency, const float noise_amplitude, const float time) {
+    // Measuring the creation time
+    const ProfilerScope profiler_scope("create the Perlin Heightfield", "build", PRINT_PERLIN_TERRAIN_CREATION_TIME);
+
+    // Computing the grid
+    const int samples_x = max(static_cast<int>(ceil(width / noise_frequency)), 1) + 1;
+    const int samples_z = max(static_cast<int>(ceil(depth / noise_frequency)), 1) + 1;
+
+    // Initializing the noise generator and the fractal noise parameters
+    const PerlinNoise * perlin_noise = PerlinNoise::getInstance();
+    const FractalNoiseParameters noise_parameters { .amplitude = noise_amplitude };
+
+    // Sampling the noise, in parallel over the rows and in batches along the row
+    vector<float> heights(samples_x * samples_z);
+
+    #pragma omp parallel for
+    for(int j = 0; j < samples_z; j++) {
+        constexpr int batch_size = 8;
+        alignas(32) float x[batch_size], y[batch_size], z[batch_size], noise[batch_size];
+
+        for(int i = 0; i < samples_x; i += batch_size) {
+            for(int lane = 0; lane < batch_size; lane++) {
+                x[lane] = - (width / 2) + static_cast<float>(i + lane) * noise_frequency;
+                y[lane] = time;
+                z[lane] = - (depth / 2) + static_cast<float>(j) * noise_frequency;
+            }
+
+            perlin_noise->FractalNoiseBatch<batch_size>(x, y, z, noise, noise_parameters);
+
+            for(int lane = 0; lane < batch_size && i + lane < samples_x; lane++)
+                heights[j * samples_x + i + lane] = noise[lane];
+        }
+    }
+
+    // The grid of the mesh starts at the corner, the heightfield being centered on its origin
+    const glm::vec3 grid_center(- (width / 2) + 0.5f * static_cast<float>(samples_x - 1) * noise_frequency, 0,
+                                - (depth / 2) + 0.5f * static_cast<float>(samples_z - 1) * noise_frequency);
+
+    primitives.push_back(new Heightfield(transform * glm::translate(glm::mat4(1), grid_center), std::move(heights),
+        samples_x, samples_z, noise_frequency, & material));
+}
+
+#endif //HEIGHTFIELD_H
@@ -72,8 +72,21 @@ protected:
         interaction.distance = distance(ray_origin, interaction.intersection);
     }
 
+    /**
+    * Computes the UV coordinates of a point lying on the surface of the primitive, or on its extension, used to
+    * estimate the texture footprint of the ray differentials
+    * @param global_point The point in global coordinates
+    * @param uv_coordinates The UV coordinates of the point
+    * @return True if the primitive has a UV parametrization, false otherwise
+    */
+    virtual bool computeSurfaceUV(const glm::vec3 & global_point, glm::vec2 & uv_coordinates) const {
+        return false;
+    }
+
 public:
 
+    virtual ~Primitive() = default;
+
     /** A function computing an intersection, which returns the structure Hit */
     virtual void Intersect(const Ray & ray, Interaction & interaction) = 0;
 
@@ -102,35 +115,83 @@ public:
     }
 
     /**
-    * Returns the diffuse coefficients at the given uv coordinates
-    * @param UV 2 sized vector containing a surface point expressed in UV coordinates
+    * Estimates the change of the UV coordinates between adjacent pixels, by intersecting the ray differentials with
+    * the tangent plane at the interaction. Skipped if the primitive is not textured or the ray has no differentials
+    * @param ray The ray that generated the interaction
+    * @param interaction The interaction, whose UV differentials are updated
     */
-    [[nodiscard]] glm::vec3 getDiffuse(const glm::vec2 & UV) const {
-        return this->albedo_texture ? this->albedo_texture->getPixel(UV) : this->material->diffuse;
+    void computeUVDifferentials(const Ray & ray, Interaction & interaction) const {
+        // Verifying that the footprint is needed and can be estimated
+        if(!ray.has_differentials || (!albedo_texture && !AO_R_M_texture))
+            return;
+
+        // Verifying that the differentials are not parallel to the tangent plane
+        const float dot_normal_dx = dot(interaction.normal, ray.dx_direction);
+        const float dot_normal_dy = dot(interaction.normal, ray.dy_direction);
+        if(abs(dot_normal_dx) < 1e-6f || abs(dot_normal_dy) < 1e-6f)
+            return;
+
+        // Intersecting the differentials with the tangent plane
+        const float plane_distance = dot(interaction.normal, interaction.intersection - ray.origin);
+        const glm::vec3 dx_point = ray.origin + plane_distance / dot_normal_dx * ray.dx_direction;
+        const glm::vec3 dy_point = ray.origin + plane_distance / dot_normal_dy * ray.dy_direction;
+
+        // Mapping the offset points in UV coordinates
+        glm::vec2 dx_uv, dy_uv;
+        if(!computeSurfaceUV(dx_point, dx_uv) || !computeSurfaceUV(dy_point, dy_uv))
+            return;
+
+        // Computing the differentials, taking the shortest way around the wrapping seams
+        interaction.uv_dx = dx_uv - interaction.uv_coordinates;
+        interaction.uv_dy = dy_uv - interaction.uv_coordinates;
+        interaction.uv_dx -= glm::round(interaction.uv_dx);
+        interaction.uv_dy -= glm::round(interaction.uv_dy);
     }
 
     /**
-    * Returns the roughness coefficients at the given UV coordinates
-    * @param UV 2 sized vector containing a surface point expressed in UV coordinates
+    * Returns the diffuse coefficients at the given interaction, filtered over the footprint of the ray. Procedural
+    * materials only vary along the surface when they are baked
+    * @param interaction The interaction with the surface
     */
-    [[nodiscard]] float getRoughness(const glm::vec2 UV) const {
-        return this->AO_R_M_texture ? this->AO_R_M_texture->getPixel(UV).r : this->material->roughness;
+    [[nodiscard]] glm::vec3 getDiffuse(const Interaction & interaction) const {
+        // Case in which the surface is textured
+        if(this->albedo_texture)
+            return this->albedo_texture->getFilteredPixel(interaction.uv_coordinates, interaction.uv_dx,
+                interaction.uv_dy);
+
+        // Case in which the procedural materials are baked, filtering the baked diffuse
+        if(!baked_volumes.empty())
+            if(const BakedVolume * baked_volume = findBakedVolume(this->material))
+                return baked_volume->lookup(interaction.intersection);
+
+        return this->material->diffuse;
     }
 
     /**
-    * Returns the roughness coefficients at the given UV coordinates
-    * @param UV 2 sized vector containing a surface point expressed in UV coordinates
+    * Returns the roughness coefficients at the given interaction, filtered over the footprint of the ray
+    * @param interaction The interaction with the surface
     */
-    [[nodiscard]] float getMetallic(const glm::vec2 UV) const {
-        return this->AO_R_M_texture ? this->AO_R_M_texture->getPixel(UV).g : this->material->roughness;
+    [[nodiscard]] float getRoughness(const Interaction & interaction) const {
+        return this->AO_R_M_texture ? this->AO_R_M_texture->getFilteredPixel(interaction.uv_coordinates,
+            interaction.uv_dx, interaction.uv_dy).r : this->material->roughness;
     }
 
     /**
-    * Returns the ambient occlusion coefficients at the given UV coordinates
-    * @param UV 2 sized vector containing a surface point expressed in UV coordinates
+    * Returns the metallic coefficients at the given interaction, filtered over the footprint of the ray
+    * @param interaction The interaction with the surface
     */
-    [[nodiscard]] float getAmbientOcclusion(const glm::vec2 UV) const {
-        return this->AO_R_M_texture ? this->AO_R_M_texture->getPixel(UV).b : 1.0f;
+    [[nodiscard]] float getMetallic(const Interaction & interaction) const {
+        return this->AO_R_M_texture ? this->AO_R_M_texture->getFilteredPixel(interaction.uv_coordinates,
+            interaction.uv_dx, interaction.uv_dy).g : this->material->roughness;
+    }
+
+    /**
+    * Returns the ambient occlusion coefficients at the given interaction, filtered over the footprint of the ray
+    * @param interaction The interaction with the surface
+    */
+    [[nodiscard]] float getAmbientOcclusion(const Interaction & interaction) const {
+        return this->AO_R_M_texture ? this->AO_R_M_texture->getFilteredPixel(interaction.uv_coordinates,
+            interaction.uv_dx, interaction.uv_dy).b : 1.0f;
     }
 
 
@@ -141,6 +202,22 @@ public:
         return {min_global_coord, max_global_coord};
     }
 
+    /**
+    * Function that splits the part of the primitive within a box with an axis aligned plane, used by the BVH spatial
+    * splits. By default the box itself is split, primitives whose shape allows tighter boxes override it
+    * @param bounding_box The box containing the part of the primitive to split, in world space
+    * @param axis The axis orthogonal to the plane
+    * @param position The position of the plane along the axis
+    * @param left_box The bounding box of the part below the plane, empty if none
+    * @param right_box The bounding box of the part above the plane, empty if none
+    */
+    virtual void splitBoundingBox(const BoundingBox3 & bounding_box, const int axis, const float position,
+        BoundingBox3 & left_box, BoundingBox3 & right_box) const {
+        left_box = right_box = bounding_box;
+        left_box.max_coordinates[axis] = min(left_box.max_coordinates[axis], position);
+        right_box.min_coordinates[axis] = max(right_box.min_coordinates[axis], position);
+    }
+
     /**
     * Returns the centroid of the primitive
     */
@@ -155,6 +232,13 @@ public:
         return * this->material;
     }
 
+    /**
+    * Returns the pointer to the material of the primitive, shared with the other primitives using it
+    */
+    [[nodiscard]] const Material * getMaterialPointer() const {
+        return this->material;
+    }
+
     /**
     * Getter of the
     */
@@ -127,6 +127,23 @@ protected:
         delocalizeInteraction(interaction, global_ray.origin);
     }
 
+    /**
+    * Computes the UV coordinates of a point, after projecting it on the sphere
+    * @param global_point The point in global coordinates
+    * @param uv_coordinates The UV coordinates of the point
+    * @return Always true, the sphere is fully parametrized
+    */
+    bool computeSurfaceUV(const glm::vec3 & global_point, glm::vec2 & uv_coordinates) const override {
+        // Converting the point in local coordinates and projecting it on the unit sphere
+        const glm::vec3 local_point = normalize(glm::vec3(inverse_transform * glm::vec4(global_point, 1)));
+
+        // Computing the UV coordinates with the same mapping used by the intersection
+        uv_coordinates = glm::vec2(atan2(local_point.y, local_point.x) / (2 * M_PI) + 0.5f,
+            acos(glm::clamp(local_point.z, -1.0f, 1.0f)) / M_PI);
+
+        return true;
+    }
+
 public:
     /**
      * The constructor of the sphere
@@ -11,6 +11,9 @@ using namespace std;
 * Class representing a triangle
 */
 class Triangle : public Primitive {
+    // The bricked SDS serializes the triangles to page them out of memory
+    friend class BrickedBVH;
+
     const Vertex * vertices;
 
     glm::vec3 triangle_cross_product; ///< Cross product used to computed barycentric coordinates
@@ -49,6 +52,9 @@ protected:
     * Computes the intersections (if any) and stores
     */
     void computeIntersection(const Ray & global_ray, Interaction & interaction) {
+        // Counting the intersection test
+        countStatistic(TRIANGLE_TESTS);
+
         // Converting the localized_ray in local coordinates
         const Ray localized_ray = localizeRay(global_ray);
 
@@ -125,6 +131,7 @@ protected:
         }
 
         // Updating the value within the provided interaction
+        countStatistic(TRIANGLE_HITS);
         interaction.hit = true;
         interaction.normal = normal;
         interaction.uv_coordinates = uv_coordinates;
@@ -136,6 +143,32 @@ protected:
         delocalizeInteraction(interaction, global_ray.origin);
     }
 
+    /**
+    * Computes the UV coordinates of a point on the plane of the triangle, extrapolating the barycentric coordinates
+    * @param global_point The point in global coordinates
+    * @param uv_coordinates The UV coordinates of the point
+    * @return True if the vertices have UV coordinates, false otherwise
+    */
+    bool computeSurfaceUV(const glm::vec3 & global_point, glm::vec2 & uv_coordinates) const override {
+        // Verifying that the vertices have UV coordinates
+        if(!this->vertices[0].uv_coordinates)
+            return false;
+
+        // Converting the point in local coordinates
+        const glm::vec3 local_point = inverse_transform * glm::vec4(global_point, 1);
+
+        // Interpolating the UV coordinates with the signed barycentric coordinates
+        uv_coordinates = glm::vec2(0.0f);
+        for(int i = 0; i < 3; i++) {
+            const glm::vec3 cross_product = cross(* vertices[(i + 1) % 3].coordinates - local_point,
+                * vertices[(i + 2) % 3].coordinates - local_point);
+            uv_coordinates += dot(triangle_cross_product, cross_product) * barycentric_coordinate_denominator
+                * * vertices[i].uv_coordinates;
+        }
+
+        return true;
+    }
+
 public:
     /**
     * Constructor that initialized the triangle without the vertices normals
@@ -202,6 +235,50 @@ public:
 
         return normalize(glm::vec3(0, tangent_y, tangent_z));
     }
+
+    /**
+    * Splits the part of the triangle within a box with an axis aligned plane, wrapping the vertices on each side of
+    * the plane and the points where the edges cross it
+    * @param bounding_box The box containing the part of the triangle to split, in world space
+    * @param axis The axis orthogonal to the plane
+    * @param position The position of the plane along the axis
+    * @param left_box The bounding box of the part below the plane, empty if none
+    * @param right_box The bounding box of the part above the plane, empty if none
+    */
+    void splitBoundingBox(const BoundingBox3 & bounding_box, const int axis, const float position,
+        BoundingBox3 & left_box, BoundingBox3 & right_box) const override {
+        // Computing the global vertices
+        glm::vec3 global_vertices [3];
+        for(int i = 0; i < 3; i++)
+            global_vertices[i] = transform * glm::vec4(* vertices[i].coordinates, 1);
+
+        // Wrapping each vertex on its side, and each edge crossing on both
+        left_box = right_box = BoundingBox3();
+        for(int i = 0; i < 3; i++) {
+            const glm::vec3 & current = global_vertices[i];
+            const glm::vec3 & next = global_vertices[(i + 1) % 3];
+
+            if(current[axis] <= position)
+                left_box = BoundingBox3::Union(left_box, current);
+            if(current[axis] >= position)
+                right_box = BoundingBox3::Union(right_box, current);
+
+            if((current[axis] < position && next[axis] > position) ||
+                (current[axis] > position && next[axis] < position)) {
+                glm::vec3 crossing = glm::mix(current, next, (position - current[axis]) / (next[axis] - current[axis]));
+                crossing[axis] = position;
+                left_box = BoundingBox3::Union(left_box, crossing);
+                right_box = BoundingBox3::Union(right_box, crossing);
+            }
+        }
+
+        // Restricting each side to the part of the box on that side
+        BoundingBox3 left_side = bounding_box, right_side = bounding_box;
+        left_side.max_coordinates[axis] = position;
+        right_side.min_coordinates[axis] = position;
+        left_box = BoundingBox3::Intersection(left_box, left_side);
+        right_box = BoundingBox3::Intersection(right_box, right_side);
+    }
 };
 
 #endif //TRIANGLE_H
@@ -0,0 +1,198 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef ACCELERATION_STRUCTURE_H
+#define ACCELERATION_STRUCTURE_H
+
+#include "../Bounds/Bounding Box 3D.h"
+#include "../Primitives/Plane.h"
+
+/**
+* Interface of the SDS used to accelerate the ray intersections in the main loop. The infinite planes are kept out of
+* the structures and intersected first, so that their closest hit bounds the traversal
+*/
+class AccelerationStructure {
+protected:
+    // Internal enum used to distinguish between traversal mode
+    enum traversal_mode {
+        FIRST_WITHIN_DISTANCE,
+        FIRST_NOT_TRANSPARENT_WITHIN_DISTANCE,
+        CLOSEST
+    };
+
+    /**
+    * Function that handles a hit found during the traversal, based on the traversal mode
+    * @param tentative_interaction The hit with a primitive
+    * @param mode The traversal mode
+    * @param closest_interaction The closest interaction found so far, updated in closest mode
+    * @param max_distance The current max distance, shrunk to the closest hit in closest mode
+    * @return True if the traversal can terminate with the given interaction
+    */
+    static bool acceptInteraction(const Interaction & tentative_interaction, const traversal_mode mode,
+        Interaction & closest_interaction, float & max_distance) {
+        switch(mode) {
+            case FIRST_NOT_TRANSPARENT_WITHIN_DISTANCE:
+                return tentative_interaction.distance < max_distance
+                    && tentative_interaction.material->transparency < 1.0f;
+            case FIRST_WITHIN_DISTANCE:
+                return tentative_interaction.distance <= max_distance;
+            case CLOSEST:
+            default: {
+                if(tentative_interaction.distance < closest_interaction.distance) {
+                    closest_interaction = tentative_interaction;
+                    max_distance = tentative_interaction.distance;
+                }
+                return false;
+            }
+        }
+    }
+
+    /**
+    * Function that intersects a range of primitives
+    * @param ray The traversing ray
+    * @param range_primitives The first primitive of the range
+    * @param primitives_amount The amount of primitives of the range
+    * @param mode The traversal mode
+    * @param closest_interaction The closest interaction found so far, set to the terminating one if any
+    * @param max_distance The current max distance, shrunk to the closest hit in closest mode
+    * @return True if the traversal can terminate with the closest interaction
+    */
+    static bool intersectPrimitives(const Ray & ray, Primitive * const * range_primitives, const int primitives_amount,
+        const traversal_mode mode, Interaction & closest_interaction, float & max_distance) {
+        // Iterating all primitives
+        for(int i = 0; i < primitives_amount; i++) {
+            // Initializing the tentative interaction with the current primitive
+            Interaction tentative_interaction {
+                .hit = false,
+                .distance = INFINITY
+            };
+
+            // Computing the intersection with the primitive
+            range_primitives[i]->Intersect(ray, tentative_interaction);
+
+            // Verifying if the hit is valid and better than the current closest hit
+            if(tentative_interaction.hit && acceptInteraction(tentative_interaction, mode,
+                closest_interaction, max_distance)) {
+                closest_interaction = tentative_interaction;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+    * Function that intersects the primitives stored within the structure
+    * @param ray The traversing ray
+    * @param mode The traversal mode
+    * @param closest_interaction The closest interaction found so far, set to the terminating one if any
+    * @param max_distance The max distance of the accepted hits
+    */
+    virtual void traverse(const Ray & ray, traversal_mode mode, Interaction & closest_interaction,
+        float max_distance) const = 0;
+
+    [[nodiscard]] Interaction traversal(const Ray & ray, const traversal_mode mode, float max_distance) const {
+        // Initializing the hit struct
+        Interaction closest_interaction {
+            .hit = false,
+            .distance = INFINITY,
+        };
+
+        // Intersecting the infinite planes first, so that the closest hit bounds the traversal
+        for(const auto & plane : planes) {
+            // Initializing the tentative interaction
+            Interaction tentative_interaction {
+                .hit = false,
+                .distance = INFINITY
+            };
+
+            // Computing the tentative interaction
+            plane->Intersect(ray, tentative_interaction);
+
+            // Updating if necessary
+            if(tentative_interaction.hit && acceptInteraction(tentative_interaction, mode, closest_interaction,
+                max_distance))
+                return tentative_interaction;
+        }
+
+        // Traversing the structure
+        traverse(ray, mode, closest_interaction, max_distance);
+
+        return closest_interaction;
+    }
+
+public:
+    virtual ~AccelerationStructure() = default;
+
+    /**
+    * Reset the structure at factory settings
+    */
+    virtual void clear() = 0;
+
+    /**
+    * Releases the resources held for the current thread, called once it does not use the interactions it received
+    */
+    virtual void releaseThreadReferences() const { }
+
+    /**
+    * Checks weather the structure copied the triangles of the scene out of memory, releasing the heap ones
+    * @return True if the meshes the triangles were built from are not referenced anymore
+    */
+    [[nodiscard]] virtual bool hasPagedOutTriangles() const {
+        return false;
+    }
+
+    /**
+    * Function that given a ray returns the closest intersection with a primitive
+    * @param ray A ray expressed in global coordinates
+    * @return Hit struct containing all the data regarding the intersection
+    */
+    [[nodiscard]] Interaction intersect(const Ray & ray) const {
+        return traversal(ray, CLOSEST, INFINITY);
+    }
+
+    /**
+    * Function that given a ray returns the first intersection within the given distance (included)
+    * @param ray A ray expressed in global coordinates
+    * @param max_distance The max distance between the ray origin and the found intersection point
+    * @return Hit struct containing all the data regarding the intersection
+    */
+    [[nodiscard]] Interaction intersectWithinDistance(const Ray & ray, const float max_distance) const {
+        return traversal(ray, FIRST_WITHIN_DISTANCE, max_distance);
+    }
+
+    /**
+    * Function that given a ray returns the first intersection with non trasparent object
+    * within the given distance (included)
+    * @param ray A ray expressed in global coordinates
+    * @param max_distance The max distance between the ray origin and the found intersection point
+    * @return Hit struct containing all the data regarding the intersection
+    */
+    [[nodiscard]] Interaction intersectNoTransparentWithinDistance(const Ray & ray, const float max_distance) const {
+        return traversal(ray, FIRST_NOT_TRANSPARENT_WITHIN_DISTANCE, max_distance);
+    }
+};
+
+/**
+* SDS-less structure testing every primitive against each ray, used as a baseline
+*/
+class PrimitivesList : public AccelerationStructure {
+    vector<Primitive *> listed_primitives; ///< The primitives of the scene
+
+protected:
+    void traverse(const Ray & ray, const traversal_mode mode, Interaction & closest_interaction,
+        float max_distance) const override {
+        intersectPrimitives(ray, listed_primitives.data(), static_cast<int>(listed_primitives.size()), mode,
+            closest_interaction, max_distance);
+    }
+
+public:
+    PrimitivesList() : listed_primitives(primitives) { }
+
+    void clear() override {
+        listed_primitives.clear();
+    }
+};
+
+#endif //ACCELERATION_STRUCTURE_H
@@ -10,11 +10,20 @@
 #include "../Auxiliary/Printing.h"
 #include "../Bounds/Bounding Box 3D.h"
 #include "../Primitives/Plane.h"
+#include "Acceleration Structure.h"
 
 /**
 * Implementation of the BVH SDS, used to accelerate the ray intersections in the main loop
 */
-class BVH {
+class BVH : public AccelerationStructure {
+    // Most primitives a leaf can hold, bounded by the width of the counters of the linear and quantized nodes
+    static constexpr int MAX_LEAF_PRIMITIVES = numeric_limits<uint16_t>::max();
+
+    // Depth at which the subtrees are collapsed in a leaf. The levels below it leave room to split the leaves holding
+    // more than MAX_LEAF_PRIMITIVES, so that no node is deeper than BVH_MAX_DEPTH
+    static constexpr int COLLAPSE_DEPTH = BVH_MAX_DEPTH - 16;
+    static_assert(COLLAPSE_DEPTH > 0, "The BVH must be deep enough to split its largest leaves");
+
     // Struct used to store information regarding a primitive
     struct BVHPrimitiveInfo {
         /**
@@ -54,6 +63,7 @@ class BVH {
         int split_axis; ///< The split axis used for separating the children (0 = x, 1 = y, 2 = z)
         int first_primitive_index; ///< The index of the first primitives within the global vector
         int primitives_amount; ///< The amount of primitives contained in this node
+        float sah_cost = 0; ///< The SAH cost of the subtree, used by the treelet optimization
     };
 
     // Struct used to represent a node in the linear BVH
@@ -61,17 +71,39 @@ class BVH {
         BoundingBox3 bounding_box; ///< The bounding box of this node
         union {
             int first_primitive_index = -2; ///< An index offset to the first primitive belonging to this leaf
-            int second_child_offset; ///< An index offset to the second child of this internal node
+            int children_pair_offset; ///< An index offset to the pair holding the children of this internal node
         };
         uint16_t primitives_amount; ///< Primitives contained in this leaf (0 if internal node)
         uint8_t split_axis; ///< Axis used to split the primitives within this node
     };
 
-    // Internal enum used to distinguish between traversal mode
-    enum traversal_mode {
-        FIRST_WITHIN_DISTANCE,
-        FIRST_NOT_TRANSPARENT_WITHIN_DISTANCE,
-        CLOSEST
+    // Struct used to store two sibling nodes of the linear BVH in one cache line, the root sharing it with no node
+    struct alignas(64) LinearBVHNodePair {
+        LinearBVHNode nodes[2]; ///< The two sibling nodes
+    };
+
+    // Struct used to represent the pairs of sibling nodes of the BVH tree, which are the units placed by the layouts
+    struct BVHNodePair {
+        const BVHNode * nodes[2]; ///< The two sibling nodes, the second one missing in the root pair
+        int children_pairs[2]; ///< Index of the pair holding the children of each node (-1 if leaf)
+    };
+
+    // Struct used to represent a node of the quantized BVH, whose four children bounds fit in one cache line
+    struct alignas(64) QuantizedBVHNode {
+        glm::vec3 origin; ///< Min coordinates of the node, origin of the quantization grid
+        int8_t exponents[3]; ///< Exponent of the power of two size of the grid cells along each axis
+        uint8_t children_amount; ///< Amount of children of this node
+        uint8_t children_min[3][4]; ///< Grid coordinates of the min corner of each child, rounded down
+        uint8_t children_max[3][4]; ///< Grid coordinates of the max corner of each child, rounded up
+        int32_t children_offset[4]; ///< Index of the child node, or of the first primitive of a leaf child
+        uint16_t primitives_amount[4]; ///< Primitives contained in each leaf child (0 if internal node)
+    };
+    static_assert(sizeof(QuantizedBVHNode) == 64, "A quantized node must fill exactly one cache line");
+
+    // Struct used to sort the primitives along the Morton curve
+    struct MortonPrimitive {
+        int primitive_info_index; ///< The index of the primitive info
+        uint32_t morton_code; ///< The Morton code of the primitive centroid within the centroids bounding box
     };
 
     /**
@@ -81,10 +113,11 @@ class BVH {
     * @param end_index The index of the first primitive not included in the node
     * @param total_nodes Number of nodes created
     * @param ordered_primitives Vector containing primitives ordered based on leaf creation order
+    * @param depth The depth of the node, a leaf being forced at COLLAPSE_DEPTH
     * @return The root node of the BVH tree
     */
     BVHNode * buildNode(vector<BVHPrimitiveInfo> & primitives_info, int start_index, int end_index,
-        int * total_nodes, vector<Primitive *> & ordered_primitives) {
+        int * total_nodes, vector<Primitive *> & ordered_primitives, const int depth = 0) {
         // Verifying that there are primitives in the scene
         if (primitives.empty())
             return nullptr;
@@ -108,8 +141,8 @@ class BVH {
         // Computing the amount of primitives in this node
         int primitives_amount = end_index - start_index;
 
-        // Case in which I reached a leaf node
-        if (primitives_amount == 1) {
+        // Case in which I reached a leaf node, or the depth limit
+        if (primitives_amount == 1 || depth >= COLLAPSE_DEPTH) {
             // Extracting the first free spot in the ordered primitives vector
             int first_primitive_index = ordered_primitives.size();
 
@@ -155,7 +188,7 @@ class BVH {
                 return current_node;
             }
 
-            switch(SPLIT_METHOD) {
+            switch(method) {
                 case MIDDLE: {
                     // Computing the middle point on the most extended axis of the centroids bounding box
                     float middle_point = (centroids_bounding_box.min_coordinates[most_extended_axis]
@@ -326,178 +359,1351 @@ class BVH {
 
             // Building the internal node by recursively calling the buildNode function
             current_node->initializeInternal(most_extended_axis,
-                buildNode(primitives_info, start_index, middle_index, total_nodes, ordered_primitives),
-                buildNode(primitives_info, middle_index, end_index, total_nodes, ordered_primitives));
+                buildNode(primitives_info, start_index, middle_index, total_nodes, ordered_primitives, depth + 1),
+                buildNode(primitives_info, middle_index, end_index, total_nodes, ordered_primitives, depth + 1));
         }
         return current_node;
     }
 
     /**
-    * Function that flattens the BVH Tree for faster traversal
-    * @param current_node The current node to be flattened (provide root to start process)
-    * @param offset Index offset used to link internal nodes with children
-    * @return The created linear node offset
+    * Function that returns the SAH bucket of a reference, based on its centroid
+    * @param reference The reference
+    * @param centroids_bounding_box The bounding box wrapping the centroids of the node
+    * @param axis The axis along which the centroids are bucketed
+    */
+    static int getObjectBucket(const BVHPrimitiveInfo & reference, const BoundingBox3 & centroids_bounding_box,
+        const int axis) {
+        const float min_centroid = centroids_bounding_box.min_coordinates[axis];
+        const float extent = centroids_bounding_box.max_coordinates[axis] - min_centroid;
+        return min(static_cast<int>(SAH_BUCKETS_AMOUNT * (reference.centroid[axis] - min_centroid) / extent),
+            SAH_BUCKETS_AMOUNT - 1);
+    }
+
+    /**
+    * Function that creates a leaf holding the given references, pushing their primitives in the ordered vector
+    * @param references The references held by the leaf
+    * @param bounding_box The bounding box wrapping the references
+    * @param ordered_primitives Vector containing primitives ordered based on leaf creation order
+    * @return The created leaf
     */
-    int flattenBVHTree(const BVHNode * current_node, int * offset) {
-        // Initializing the current linear node
-        LinearBVHNode * current_linear_node = & linear_nodes[*offset];
+    static BVHNode * buildSpatialLeaf(const vector<BVHPrimitiveInfo> & references, const BoundingBox3 & bounding_box,
+        vector<Primitive *> & ordered_primitives) {
+        // Pushing all the primitives in the ordered vector
+        const int first_primitive_index = static_cast<int>(ordered_primitives.size());
+        for(const auto & reference : references)
+            ordered_primitives.push_back(primitives[reference.primitive_index]);
+
+        // Initializing the leaf
+        const auto leaf = new BVHNode();
+        leaf->initializeLeaf(first_primitive_index, static_cast<int>(references.size()), bounding_box);
+        return leaf;
+    }
+
+    /**
+    * Function that builds a SBVH node. Besides the SAH object splits, the nodes whose object split children overlap
+    * consider spatial splits, which cut the node with a plane and clip the primitives straddling it to each side, so
+    * that long primitives do not inflate the boxes of both children. Since a straddling primitive is referenced by
+    * both children, the spatial splits stop once the references exceed the duplication budget
+    * @param references The references to the primitives within the node, each with its clipped bounding box
+    * @param total_nodes Number of nodes created
+    * @param ordered_primitives Vector containing primitives ordered based on leaf creation order
+    * @param remaining_duplications Amount of references the spatial splits can still add
+    * @param depth The depth of the node, a leaf being forced at COLLAPSE_DEPTH
+    * @return The root node of the SBVH subtree
+    */
+    BVHNode * buildSpatialNode(vector<BVHPrimitiveInfo> & references, int * total_nodes,
+        vector<Primitive *> & ordered_primitives, int & remaining_duplications, const int depth = 0) {
+        // Increasing the total amount of node created
+        (*total_nodes)++;
+
+        // Creating the bounding box that wraps the entire node, and the one wrapping the centroids
+        BoundingBox3 bounding_box, centroids_bounding_box;
+        for(const auto & reference : references) {
+            bounding_box = BoundingBox3::Union(bounding_box, reference.bounding_box);
+            centroids_bounding_box = BoundingBox3::Union(centroids_bounding_box, reference.centroid);
+        }
+
+        // Case in which I reached a leaf node, or the depth limit
+        const int primitives_amount = static_cast<int>(references.size());
+        if(primitives_amount == 1 || depth >= COLLAPSE_DEPTH)
+            return buildSpatialLeaf(references, bounding_box, ordered_primitives);
+
+        // Struct describing the best split found along the axes
+        struct SplitCandidate {
+            float cost = INFINITY; ///< SAH cost of the split
+            int axis = 0; ///< Axis of the split
+            float position = 0; ///< Position of the split plane, or last bucket of the left child for object splits
+            BoundingBox3 left_box; ///< Bounding box of the left child
+            BoundingBox3 right_box; ///< Bounding box of the right child
+            int left_count = 0; ///< Amount of references in the left child
+            int right_count = 0; ///< Amount of references in the right child
+        };
+
+        // Looking for the best object split, binning the centroids along each axis
+        SplitCandidate object_split;
+        for(int axis = 0; axis < 3; axis++) {
+            if(centroids_bounding_box.max_coordinates[axis] <= centroids_bounding_box.min_coordinates[axis])
+                continue;
+
+            // Initializing the buckets
+            int counts [SAH_BUCKETS_AMOUNT] {};
+            BoundingBox3 boxes [SAH_BUCKETS_AMOUNT];
+            for(const auto & reference : references) {
+                const int bucket = getObjectBucket(reference, centroids_bounding_box, axis);
+                counts[bucket]++;
+                boxes[bucket] = BoundingBox3::Union(boxes[bucket], reference.bounding_box);
+            }
+
+            // Sweeping the buckets from the right, storing the right side of each split
+            BoundingBox3 right_boxes [SAH_BUCKETS_AMOUNT];
+            int right_counts [SAH_BUCKETS_AMOUNT] {};
+            for(int i = SAH_BUCKETS_AMOUNT - 1; i > 0; i--) {
+                right_boxes[i - 1] = BoundingBox3::Union(i < SAH_BUCKETS_AMOUNT - 1 ? right_boxes[i] : BoundingBox3(),
+                    boxes[i]);
+                right_counts[i - 1] = (i < SAH_BUCKETS_AMOUNT - 1 ? right_counts[i] : 0) + counts[i];
+            }
+
+            // Sweeping the buckets from the left, computing the cost of each split
+            BoundingBox3 left_box;
+            int left_count = 0;
+            for(int i = 0; i < SAH_BUCKETS_AMOUNT - 1; i++) {
+                left_box = BoundingBox3::Union(left_box, boxes[i]);
+                left_count += counts[i];
+                if(left_count == 0 || right_counts[i] == 0)
+                    continue;
+
+                const float cost = .125f + (static_cast<float>(left_count) * left_box.getSurfaceArea() +
+                    static_cast<float>(right_counts[i]) * right_boxes[i].getSurfaceArea())
+                    / bounding_box.getSurfaceArea();
+                if(cost < object_split.cost)
+                    object_split = {cost, axis, static_cast<float>(i), left_box, right_boxes[i], left_count,
+                        right_counts[i]};
+            }
+        }
+
+        // Looking for the best spatial split along the most extended axis, only if the children of the object split
+        // overlap enough to be worth it
+        SplitCandidate spatial_split;
+        const int axis = bounding_box.getMaximumExtend();
+        const BoundingBox3 overlap = object_split.cost == INFINITY ? bounding_box :
+            BoundingBox3::Intersection(object_split.left_box, object_split.right_box);
+        const float overlap_area = overlap.isEmpty() ? 0 : overlap.getSurfaceArea();
+        if(remaining_duplications > 0 && overlap_area > SBVH_OVERLAP_THRESHOLD * root_surface_area &&
+            bounding_box.max_coordinates[axis] > bounding_box.min_coordinates[axis]) {
+            const float min_coordinate = bounding_box.min_coordinates[axis];
+            const float bin_width = (bounding_box.max_coordinates[axis] - min_coordinate) / SBVH_SPATIAL_BINS_AMOUNT;
+
+            // Clipping the references to the bins they span, counting them where they enter and exit
+            int entries [SBVH_SPATIAL_BINS_AMOUNT] {};
+            int exits [SBVH_SPATIAL_BINS_AMOUNT] {};
+            BoundingBox3 boxes [SBVH_SPATIAL_BINS_AMOUNT];
+            for(const auto & reference : references) {
+                const int first_bin = glm::clamp(static_cast<int>((reference.bounding_box.min_coordinates[axis]
+                    - min_coordinate) / bin_width), 0, SBVH_SPATIAL_BINS_AMOUNT - 1);
+                const int last_bin = glm::clamp(static_cast<int>((reference.bounding_box.max_coordinates[axis]
+                    - min_coordinate) / bin_width), first_bin, SBVH_SPATIAL_BINS_AMOUNT - 1);
+                entries[first_bin]++;
+                exits[last_bin]++;
+
+                // Splitting the reference at each bin boundary it spans, from the first bin
+                BoundingBox3 remaining_box = reference.bounding_box;
+                for(int bin = first_bin; bin < last_bin; bin++) {
+                    BoundingBox3 bin_box;
+                    primitives[reference.primitive_index]->splitBoundingBox(remaining_box, axis,
+                        min_coordinate + bin_width * static_cast<float>(bin + 1), bin_box, remaining_box);
+                    boxes[bin] = BoundingBox3::Union(boxes[bin], bin_box);
+                }
+                boxes[last_bin] = BoundingBox3::Union(boxes[last_bin], remaining_box);
+            }
 
-        // Assigning the bounding box
-        current_linear_node->bounding_box = current_node->bounding_box;
+            // Sweeping the bins from the right, storing the right side of each split
+            BoundingBox3 right_boxes [SBVH_SPATIAL_BINS_AMOUNT];
+            int right_counts [SBVH_SPATIAL_BINS_AMOUNT] {};
+            for(int i = SBVH_SPATIAL_BINS_AMOUNT - 1; i > 0; i--) {
+                right_boxes[i - 1] = BoundingBox3::Union(
+                    i < SBVH_SPATIAL_BINS_AMOUNT - 1 ? right_boxes[i] : BoundingBox3(), boxes[i]);
+                right_counts[i - 1] = (i < SBVH_SPATIAL_BINS_AMOUNT - 1 ? right_counts[i] : 0) + exits[i];
+            }
 
-        // Increasing the offset
-        int current_node_offset = (*offset)++;
+            // Sweeping the bins from the left, computing the cost of each split
+            BoundingBox3 left_box;
+            int left_count = 0;
+            for(int i = 0; i < SBVH_SPATIAL_BINS_AMOUNT - 1; i++) {
+                left_box = BoundingBox3::Union(left_box, boxes[i]);
+                left_count += entries[i];
+                if(left_count == 0 || right_counts[i] == 0)
+                    continue;
+
+                const float cost = .125f + (static_cast<float>(left_count) * left_box.getSurfaceArea() +
+                    static_cast<float>(right_counts[i]) * right_boxes[i].getSurfaceArea())
+                    / bounding_box.getSurfaceArea();
+                if(cost < spatial_split.cost)
+                    spatial_split = {cost, axis, min_coordinate + bin_width * static_cast<float>(i + 1),
+                        left_box, right_boxes[i], left_count, right_counts[i]};
+            }
+        }
 
-        // Case in which the current node is a leaf
+        // Discarding the spatial splits exceeding the budget or not reducing the references on either side
+        if(spatial_split.left_count + spatial_split.right_count - primitives_amount > remaining_duplications ||
+            (spatial_split.left_count >= primitives_amount && spatial_split.right_count >= primitives_amount))
+            spatial_split.cost = INFINITY;
+
+        // Case in which no split is cheaper than intersecting all the primitives
+        if(min(object_split.cost, spatial_split.cost) >= static_cast<float>(primitives_amount))
+            return buildSpatialLeaf(references, bounding_box, ordered_primitives);
+
+        // Distributing the references among the children, with a spatial split if it is the cheapest
+        vector<BVHPrimitiveInfo> left_references, right_references;
+        bool use_spatial_split = spatial_split.cost < object_split.cost;
+        if(use_spatial_split) {
+            const float position = spatial_split.position;
+            BoundingBox3 & left_box = spatial_split.left_box;
+            BoundingBox3 & right_box = spatial_split.right_box;
+            int left_count = spatial_split.left_count;
+            int right_count = spatial_split.right_count;
+
+            for(const auto & reference : references) {
+                // Case in which the reference lies on a single side
+                if(reference.bounding_box.max_coordinates[axis] <= position) {
+                    left_references.push_back(reference);
+                    continue;
+                }
+                if(reference.bounding_box.min_coordinates[axis] >= position) {
+                    right_references.push_back(reference);
+                    continue;
+                }
+
+                // Comparing the cost of splitting the reference with the one of moving it entirely to one side
+                const BoundingBox3 left_with_reference = BoundingBox3::Union(left_box, reference.bounding_box);
+                const BoundingBox3 right_with_reference = BoundingBox3::Union(right_box, reference.bounding_box);
+                const float split_cost = left_box.getSurfaceArea() * static_cast<float>(left_count)
+                                       + right_box.getSurfaceArea() * static_cast<float>(right_count);
+                const float left_cost = left_with_reference.getSurfaceArea() * static_cast<float>(left_count)
+                                      + right_box.getSurfaceArea() * static_cast<float>(right_count - 1);
+                const float right_cost = left_box.getSurfaceArea() * static_cast<float>(left_count - 1)
+                                       + right_with_reference.getSurfaceArea() * static_cast<float>(right_count);
+
+                if(left_cost < split_cost && left_cost <= right_cost) {
+                    left_references.push_back(reference);
+                    left_box = left_with_reference;
+                    right_count--;
+                }
+                else if(right_cost < split_cost) {
+                    right_references.push_back(reference);
+                    right_box = right_with_reference;
+                    left_count--;
+                }
+                // Splitting the reference, clipping it to each side
+                else {
+                    BoundingBox3 left_side, right_side;
+                    primitives[reference.primitive_index]->splitBoundingBox(reference.bounding_box, axis, position,
+                        left_side, right_side);
+
+                    // Dropping a side the primitive only touches
+                    if(!left_side.isEmpty())
+                        left_references.emplace_back(reference.primitive_index, left_side);
+                    if(!right_side.isEmpty())
+                        right_references.emplace_back(reference.primitive_index, right_side);
+                }
+            }
+
+            // Falling back to the object split if a side was left empty
+            if(left_references.empty() || right_references.empty()) {
+                use_spatial_split = false;
+                left_references.clear();
+                right_references.clear();
+            }
+            else
+                remaining_duplications -= static_cast<int>(left_references.size() + right_references.size())
+                                        - primitives_amount;
+        }
+        if(!use_spatial_split) {
+            // Case in which the centroids cannot be separated
+            if(object_split.cost == INFINITY)
+                return buildSpatialLeaf(references, bounding_box, ordered_primitives);
+
+            for(const auto & reference : references)
+                (getObjectBucket(reference, centroids_bounding_box, object_split.axis) <= object_split.position ?
+                    left_references : right_references).push_back(reference);
+        }
+
+        // Releasing the references of this node before descending
+        vector<BVHPrimitiveInfo>().swap(references);
+
+        // Building the internal node by recursively calling the buildSpatialNode function
+        const auto current_node = new BVHNode();
+        current_node->initializeInternal(use_spatial_split ? axis : object_split.axis,
+            buildSpatialNode(left_references, total_nodes, ordered_primitives, remaining_duplications, depth + 1),
+            buildSpatialNode(right_references, total_nodes, ordered_primitives, remaining_duplications, depth + 1));
+        return current_node;
+    }
+
+    /**
+    * Function that spreads the lowest 10 bits of a value, leaving two zero bits after each of them
+    * @param value The value to spread
+    * @return The spread value
+    */
+    static uint32_t spreadBits(uint32_t value) {
+        value = (value | (value << 16)) & 0b00000011000000000000000011111111;
+        value = (value | (value << 8))  & 0b00000011000000001111000000001111;
+        value = (value | (value << 4))  & 0b00000011000011000011000011000011;
+        value = (value | (value << 2))  & 0b00001001001001001001001001001001;
+        return value;
+    }
+
+    /**
+    * Function that computes the 30 bits Morton code of a point, interleaving 10 bits per axis (x being the highest)
+    * @param offset The point position within the unit cube
+    * @return The Morton code
+    */
+    static uint32_t computeMortonCode(const glm::vec3 & offset) {
+        const glm::uvec3 grid_coordinates = glm::clamp(glm::uvec3(offset * 1024.0f), 0u, 1023u);
+        return spreadBits(grid_coordinates.x) << 2 | spreadBits(grid_coordinates.y) << 1
+               | spreadBits(grid_coordinates.z);
+    }
+
+    /**
+    * Function that sorts the Morton primitives by code with a least significant digit radix sort, each pass counting
+    * and scattering contiguous chunks in parallel
+    * @param morton_primitives The primitives to sort
+    */
+    static void radixSort(vector<MortonPrimitive> & morton_primitives) {
+        constexpr int buckets_amount = 1 << LBVH_RADIX_SORT_BITS;
+        constexpr int passes_amount = (30 + LBVH_RADIX_SORT_BITS - 1) / LBVH_RADIX_SORT_BITS;
+
+        // Splitting the primitives in one chunk per thread
+        const int primitives_amount = static_cast<int>(morton_primitives.size());
+        const int chunks_amount = omp_get_max_threads();
+        const int chunk_size = (primitives_amount + chunks_amount - 1) / chunks_amount;
+        vector<array<int, buckets_amount>> chunks_offsets(chunks_amount);
+
+        vector<MortonPrimitive> temporary(morton_primitives.size());
+        for(int pass = 0; pass < passes_amount; pass++) {
+            // Alternating the input and output buffers
+            const vector<MortonPrimitive> & input = pass % 2 == 0 ? morton_primitives : temporary;
+            vector<MortonPrimitive> & output = pass % 2 == 0 ? temporary : morton_primitives;
+            const int low_bit = pass * LBVH_RADIX_SORT_BITS;
+
+            // Counting the digits of each chunk
+            #pragma omp parallel for
+            for(int chunk = 0; chunk < chunks_amount; chunk++) {
+                chunks_offsets[chunk].fill(0);
+                for(int i = chunk * chunk_size; i < min((chunk + 1) * chunk_size, primitives_amount); i++)
+                    chunks_offsets[chunk][(input[i].morton_code >> low_bit) & (buckets_amount - 1)]++;
+            }
+
+            // Computing where each chunk writes each digit, the chunks keeping their order within a digit
+            int offset = 0;
+            for(int bucket = 0; bucket < buckets_amount; bucket++)
+                for(int chunk = 0; chunk < chunks_amount; chunk++) {
+                    const int count = chunks_offsets[chunk][bucket];
+                    chunks_offsets[chunk][bucket] = offset;
+                    offset += count;
+                }
+
+            // Scattering the chunks
+            #pragma omp parallel for
+            for(int chunk = 0; chunk < chunks_amount; chunk++)
+                for(int i = chunk * chunk_size; i < min((chunk + 1) * chunk_size, primitives_amount); i++)
+                    output[chunks_offsets[chunk][(input[i].morton_code >> low_bit) & (buckets_amount - 1)]++] =
+                        input[i];
+        }
+
+        // Moving the result back in case of an odd amount of passes
+        if(passes_amount % 2 == 1)
+            morton_primitives.swap(temporary);
+    }
+
+    /**
+    * Function that emits the hierarchy of a range of primitives sorted by Morton code, splitting it where the given
+    * bit of the codes changes
+    * @param morton_primitives The first of the sorted primitives
+    * @param primitives_amount The amount of primitives
+    * @param bit_index The highest bit that can differ within the range
+    * @param total_nodes Number of nodes created
+    * @param ordered_primitives Vector of ordered primitives, preallocated
+    * @param ordered_primitives_offset The first free spot within the ordered primitives
+    * @return The root node of the hierarchy
+    */
+    BVHNode * emitLBVH(const MortonPrimitive * morton_primitives, const int primitives_amount, const int bit_index,
+        int * total_nodes, vector<Primitive *> & ordered_primitives, atomic<int> & ordered_primitives_offset) {
+        // Case in which a leaf is created, either because few primitives are left or because they share the code
+        if(bit_index == -1 || primitives_amount <= LBVH_MAX_LEAF_PRIMITIVES) {
+            (*total_nodes)++;
+
+            // Reserving the spots in the ordered primitives and filling them
+            const int first_primitive_index = ordered_primitives_offset.fetch_add(primitives_amount);
+            BoundingBox3 bounding_box;
+            for(int i = 0; i < primitives_amount; i++) {
+                const BVHPrimitiveInfo & primitive_info = primitives_info[morton_primitives[i].primitive_info_index];
+                ordered_primitives[first_primitive_index + i] = primitives[primitive_info.primitive_index];
+                bounding_box = BoundingBox3::Union(bounding_box, primitive_info.bounding_box);
+            }
+
+            const auto current_node = new BVHNode();
+            current_node->initializeLeaf(first_primitive_index, primitives_amount, bounding_box);
+            return current_node;
+        }
+
+        // Case in which every primitive lies on the same side of this bit
+        const uint32_t mask = 1u << bit_index;
+        if((morton_primitives[0].morton_code & mask) == (morton_primitives[primitives_amount - 1].morton_code & mask))
+            return emitLBVH(morton_primitives, primitives_amount, bit_index - 1, total_nodes, ordered_primitives,
+                ordered_primitives_offset);
+
+        // Finding the first primitive having the bit set
+        const int split_index = static_cast<int>(partition_point(morton_primitives,
+            morton_primitives + primitives_amount, [mask](const MortonPrimitive & morton_primitive) {
+                return (morton_primitive.morton_code & mask) == 0;
+            }) - morton_primitives);
+
+        // Creating the internal node, the bits alternating between the x, y and z axes
+        (*total_nodes)++;
+        const auto current_node = new BVHNode();
+        current_node->initializeInternal(2 - bit_index % 3,
+            emitLBVH(morton_primitives, split_index, bit_index - 1, total_nodes, ordered_primitives,
+                ordered_primitives_offset),
+            emitLBVH(morton_primitives + split_index, primitives_amount - split_index, bit_index - 1, total_nodes,
+                ordered_primitives, ordered_primitives_offset));
+        return current_node;
+    }
+
+    /**
+    * Function that joins the treelets of the LBVH with the SAH, their amount being small enough for a full sweep
+    * @param treelets_roots The roots of the treelets
+    * @param start_index The index of the first treelet included in the node
+    * @param end_index The index of the first treelet not included in the node
+    * @param total_nodes Number of nodes created
+    * @return The root node of the upper levels
+    */
+    static BVHNode * buildTreeletsSAH(vector<BVHNode *> & treelets_roots, const int start_index, const int end_index,
+        int * total_nodes) {
+        // Case in which a single treelet is left
+        if(end_index - start_index == 1)
+            return treelets_roots[start_index];
+
+        // Computing the bounding boxes wrapping the treelets and their centroids
+        BoundingBox3 bounding_box, centroids_bounding_box;
+        for(int i = start_index; i < end_index; i++) {
+            bounding_box = BoundingBox3::Union(bounding_box, treelets_roots[i]->bounding_box);
+            centroids_bounding_box = BoundingBox3::Union(centroids_bounding_box,
+                .5f * treelets_roots[i]->bounding_box.min_coordinates
+                + .5f * treelets_roots[i]->bounding_box.max_coordinates);
+        }
+        const int axis = centroids_bounding_box.getMaximumExtend();
+
+        // Function that computes the bucket of a treelet along the axis
+        const auto getBucket = [&](const BVHNode * treelet_root) {
+            const glm::vec3 centroid = .5f * treelet_root->bounding_box.min_coordinates
+                                       + .5f * treelet_root->bounding_box.max_coordinates;
+            return min(static_cast<int>(SAH_BUCKETS_AMOUNT * centroids_bounding_box.getOffset(centroid)[axis]),
+                SAH_BUCKETS_AMOUNT - 1);
+        };
+
+        // Initializing the buckets
+        int buckets_amounts[SAH_BUCKETS_AMOUNT] {};
+        BoundingBox3 buckets_boxes[SAH_BUCKETS_AMOUNT];
+        for(int i = start_index; i < end_index; i++) {
+            const int bucket = getBucket(treelets_roots[i]);
+            buckets_amounts[bucket]++;
+            buckets_boxes[bucket] = BoundingBox3::Union(buckets_boxes[bucket], treelets_roots[i]->bounding_box);
+        }
+
+        // Finding the least expensive split between the buckets
+        float min_cost = INFINITY;
+        int least_expensive_bucket_index = 0;
+        for(int i = 0; i < SAH_BUCKETS_AMOUNT - 1; i++) {
+            BoundingBox3 left_box, right_box;
+            int left_count = 0, right_count = 0;
+            for(int j = 0; j <= i; j++) {
+                left_box = BoundingBox3::Union(left_box, buckets_boxes[j]);
+                left_count += buckets_amounts[j];
+            }
+            for(int j = i + 1; j < SAH_BUCKETS_AMOUNT; j++) {
+                right_box = BoundingBox3::Union(right_box, buckets_boxes[j]);
+                right_count += buckets_amounts[j];
+            }
+
+            const float cost = .125f + (static_cast<float>(left_count) * left_box.getSurfaceArea()
+                                        + static_cast<float>(right_count) * right_box.getSurfaceArea())
+                                       / bounding_box.getSurfaceArea();
+            if(left_count > 0 && right_count > 0 && cost < min_cost) {
+                min_cost = cost;
+                least_expensive_bucket_index = i;
+            }
+        }
+
+        // Partitioning the treelets, halving them if their centroids fall in a single bucket
+        int middle_index = (start_index + end_index) / 2;
+        if(min_cost != INFINITY)
+            middle_index = static_cast<int>(partition(treelets_roots.begin() + start_index,
+                treelets_roots.begin() + end_index, [&](const BVHNode * treelet_root) {
+                    return getBucket(treelet_root) <= least_expensive_bucket_index;
+                }) - treelets_roots.begin());
+
+        (*total_nodes)++;
+        const auto current_node = new BVHNode();
+        current_node->initializeInternal(axis,
+            buildTreeletsSAH(treelets_roots, start_index, middle_index, total_nodes),
+            buildTreeletsSAH(treelets_roots, middle_index, end_index, total_nodes));
+        return current_node;
+    }
+
+    /**
+    * Function that builds the LBVH: the primitives are sorted by the Morton code of their centroid, grouped in
+    * treelets sharing the top bits of the code, which are emitted in parallel and joined with the SAH
+    * @param total_nodes Number of nodes created
+    * @param ordered_primitives Vector containing primitives ordered based on leaf creation order
+    * @return The root node of the BVH tree
+    */
+    BVHNode * buildLBVH(int * total_nodes, vector<Primitive *> & ordered_primitives) {
+        // Computing the bounding box wrapping the centroids
+        BoundingBox3 centroids_bounding_box;
+        for(const auto & primitive_info : primitives_info)
+            centroids_bounding_box = BoundingBox3::Union(centroids_bounding_box, primitive_info.centroid);
+
+        // Computing the Morton codes of the centroids
+        const int primitives_amount = static_cast<int>(primitives_info.size());
+        vector<MortonPrimitive> morton_primitives(primitives_amount);
+        #pragma omp parallel for
+        for(int i = 0; i < primitives_amount; i++)
+            morton_primitives[i] = {i,
+                computeMortonCode(centroids_bounding_box.getOffset(primitives_info[i].centroid))};
+
+        // Sorting the primitives along the Morton curve
+        radixSort(morton_primitives);
+
+        // Splitting the curve in treelets, each one gathering the primitives that share the top bits of the code
+        struct LBVHTreelet {
+            int start_index; ///< Index of the first primitive of the treelet
+            int primitives_amount; ///< Amount of primitives within the treelet
+            int total_nodes; ///< Amount of nodes created within the treelet
+        };
+        vector<LBVHTreelet> treelets;
+        constexpr int treelet_shift = 30 - LBVH_TREELET_BITS;
+        for(int start = 0, end = 1; end <= primitives_amount; end++)
+            if(end == primitives_amount || morton_primitives[start].morton_code >> treelet_shift
+                                           != morton_primitives[end].morton_code >> treelet_shift) {
+                treelets.push_back({start, end - start, 0});
+                start = end;
+            }
+
+        // Emitting the treelets in parallel, from the highest bit not shared within them
+        ordered_primitives.resize(primitives_amount);
+        atomic<int> ordered_primitives_offset = 0;
+        vector<BVHNode *> treelets_roots(treelets.size());
+        #pragma omp parallel for schedule(dynamic)
+        for(size_t i = 0; i < treelets.size(); i++)
+            treelets_roots[i] = emitLBVH(& morton_primitives[treelets[i].start_index], treelets[i].primitives_amount,
+                treelet_shift - 1, & treelets[i].total_nodes, ordered_primitives, ordered_primitives_offset);
+
+        for(const auto & treelet : treelets)
+            *total_nodes += treelet.total_nodes;
+
+        // Joining the treelets
+        return buildTreeletsSAH(treelets_roots, 0, static_cast<int>(treelets_roots.size()), total_nodes);
+    }
+
+    /**
+    * Function that appends the primitives of the leaves of a subtree to the ordered primitives, releasing its nodes
+    * @param current_node The root of the subtree, which is kept
+    * @param ordered_primitives Vector containing primitives ordered based on leaf creation order
+    */
+    void gatherSubtreePrimitives(const BVHNode * current_node, vector<Primitive *> & ordered_primitives) {
+        // Case in which the node is a leaf, copying its primitives
+        if(current_node->primitives_amount > 0) {
+            for(int i = 0; i < current_node->primitives_amount; i++) {
+                Primitive * primitive = ordered_primitives[current_node->first_primitive_index + i];
+                ordered_primitives.push_back(primitive);
+            }
+            return;
+        }
+
+        // Case in which the node is an internal node, gathering and releasing its children
+        for(const auto child : current_node->children) {
+            gatherSubtreePrimitives(child, ordered_primitives);
+            delete child;
+            total_nodes--;
+        }
+    }
+
+    /**
+    * Function that splits a leaf in halves until each leaf holds at most MAX_LEAF_PRIMITIVES, each half keeping a
+    * contiguous range of the primitives. Since the primitives amount is an int, at most 15 levels are added
+    * @param leaf The leaf to split
+    * @param ordered_primitives Vector containing primitives ordered based on leaf creation order
+    */
+    void splitLargeLeaf(BVHNode * leaf, const vector<Primitive *> & ordered_primitives) {
+        if(leaf->primitives_amount <= MAX_LEAF_PRIMITIVES)
+            return;
+
+        // Creating a leaf for each half, whose bounds are clipped to the split leaf
+        BVHNode * halves[2];
+        const int half_amount = leaf->primitives_amount / 2;
+        const int ranges[2][2] {{leaf->first_primitive_index, half_amount},
+                                {leaf->first_primitive_index + half_amount, leaf->primitives_amount - half_amount}};
+        for(int i = 0; i < 2; i++) {
+            BoundingBox3 bounding_box;
+            for(int j = ranges[i][0]; j < ranges[i][0] + ranges[i][1]; j++)
+                bounding_box = BoundingBox3::Union(bounding_box, ordered_primitives[j]->getWorldSpaceBoundingBox());
+            halves[i] = new BVHNode();
+            halves[i]->initializeLeaf(ranges[i][0], ranges[i][1],
+                BoundingBox3::Intersection(bounding_box, leaf->bounding_box));
+            splitLargeLeaf(halves[i], ordered_primitives);
+        }
+
+        total_nodes += 2;
+        leaf->initializeInternal(leaf->bounding_box.getMaximumExtend(), halves[0], halves[1]);
+    }
+
+    /**
+    * Function that bounds the tree, whatever built or restructured it: the subtrees reaching COLLAPSE_DEPTH are
+    * collapsed in a leaf, then the leaves holding more than MAX_LEAF_PRIMITIVES are split, so that the traversal
+    * stacks sized by BVH_MAX_DEPTH never overflow and the primitives amounts fit the nodes
+    * @param current_node The root of the subtree
+    * @param depth The depth of the node
+    */
+    void limitSubtree(BVHNode * current_node, const int depth) {
+        // Case in which the subtree is too deep, gathering its primitives in a new range
+        if(current_node->primitives_amount == 0 && depth >= COLLAPSE_DEPTH) {
+            const int first_primitive_index = static_cast<int>(ordered_primitives.size());
+            gatherSubtreePrimitives(current_node, ordered_primitives);
+            current_node->initializeLeaf(first_primitive_index,
+                static_cast<int>(ordered_primitives.size()) - first_primitive_index, current_node->bounding_box);
+        }
+
+        // Case in which the node is a leaf
         if(current_node->primitives_amount > 0) {
-            // Extracting data from the tree leaf
-            current_linear_node->first_primitive_index = current_node->first_primitive_index;
-            current_linear_node->primitives_amount = current_node->primitives_amount;
+            splitLargeLeaf(current_node, ordered_primitives);
+            return;
         }
-        // Case in which the current node is an internal node
+
+        limitSubtree(current_node->children[0], depth + 1);
+        limitSubtree(current_node->children[1], depth + 1);
+    }
+
+    /**
+    * Function that computes the SAH cost of a subtree, storing the cost of each of its nodes
+    * @param current_node The root of the subtree
+    * @return The SAH cost of the subtree, not normalized by its surface area
+    */
+    static float computeSAHCost(BVHNode * current_node) {
+        // Case in which the node is a leaf, testing each primitive having unit cost
+        if(current_node->primitives_amount > 0)
+            current_node->sah_cost = static_cast<float>(current_node->primitives_amount)
+                                     * current_node->bounding_box.getSurfaceArea();
+        // Case in which the node is an internal node
+        else
+            current_node->sah_cost = .125f * current_node->bounding_box.getSurfaceArea()
+                                     + computeSAHCost(current_node->children[0])
+                                     + computeSAHCost(current_node->children[1]);
+
+        return current_node->sah_cost;
+    }
+
+    /**
+    * Function that links the nodes of an optimized treelet following the best partition of each subset of its leaves
+    * @param subset The subset of leaves to link
+    * @param partitions The best partition of each subset
+    * @param costs The SAH cost of each subset
+    * @param leaves The leaves of the treelet
+    * @param internal_nodes The internal nodes of the treelet, the first being its root
+    * @param next_internal_node The index of the next internal node to reuse
+    * @return The node wrapping the subset
+    */
+    static BVHNode * linkTreelet(const int subset, const int partitions[], const float costs[],
+        BVHNode * const leaves[], BVHNode * const internal_nodes[], int & next_internal_node) {
+        // Case in which the subset is a single leaf
+        if(popcount(static_cast<unsigned>(subset)) == 1)
+            return leaves[countr_zero(static_cast<unsigned>(subset))];
+
+        // Reusing an internal node, the root of the treelet first
+        BVHNode * current_node = internal_nodes[next_internal_node++];
+        BVHNode * left_child = linkTreelet(partitions[subset], partitions, costs, leaves, internal_nodes,
+            next_internal_node);
+        BVHNode * right_child = linkTreelet(subset ^ partitions[subset], partitions, costs, leaves, internal_nodes,
+            next_internal_node);
+        current_node->initializeInternal(BoundingBox3::Union(left_child->bounding_box,
+            right_child->bounding_box).getMaximumExtend(), left_child, right_child);
+        current_node->sah_cost = costs[subset];
+        return current_node;
+    }
+
+    /**
+    * Function that restructures the treelet rooted in the given node with the topology minimizing its SAH cost,
+    * found over every partition of its leaves. The leaves keep their subtrees and the internal nodes are reused
+    * @param treelet_root The root of the treelet, which stays in place
+    */
+    static void restructureTreelet(BVHNode * treelet_root) {
+        constexpr int max_leaves = TREELET_LEAVES_AMOUNT;
+
+        // Growing the treelet, opening each time the leaf with the largest surface area
+        BVHNode * leaves[max_leaves] {treelet_root->children[0], treelet_root->children[1]};
+        BVHNode * internal_nodes[max_leaves - 1] {treelet_root};
+        int leaves_amount = 2, internal_nodes_amount = 1;
+        while(leaves_amount < max_leaves) {
+            int largest = -1;
+            for(int i = 0; i < leaves_amount; i++)
+                if(leaves[i]->primitives_amount == 0 && (largest == -1 ||
+                    leaves[i]->bounding_box.getSurfaceArea() > leaves[largest]->bounding_box.getSurfaceArea()))
+                    largest = i;
+
+            // Case in which every leaf of the treelet is a leaf of the BVH
+            if(largest == -1)
+                break;
+
+            BVHNode * opened_node = leaves[largest];
+            internal_nodes[internal_nodes_amount++] = opened_node;
+            leaves[largest] = opened_node->children[0];
+            leaves[leaves_amount++] = opened_node->children[1];
+        }
+
+        // Case in which the treelet has a single topology
+        if(leaves_amount < 3)
+            return;
+
+        // Computing the best cost of each subset of leaves, the subsets of a subset always preceding it
+        const int subsets_amount = 1 << leaves_amount;
+        float costs[1 << max_leaves];
+        int partitions[1 << max_leaves];
+        for(int subset = 1; subset < subsets_amount; subset++) {
+            // Case in which the subset is a single leaf, keeping its subtree
+            if(popcount(static_cast<unsigned>(subset)) == 1) {
+                costs[subset] = leaves[countr_zero(static_cast<unsigned>(subset))]->sah_cost;
+                continue;
+            }
+
+            // Computing the surface area of the node wrapping the subset
+            BoundingBox3 bounding_box;
+            for(int i = 0; i < leaves_amount; i++)
+                if(subset & 1 << i)
+                    bounding_box = BoundingBox3::Union(bounding_box, leaves[i]->bounding_box);
+
+            // Trying each partition once, the left side always holding the lowest leaf
+            const int lowest_leaf = subset & -subset;
+            costs[subset] = INFINITY;
+            for(int partition = (subset - 1) & subset; partition > 0; partition = (partition - 1) & subset)
+                if(partition & lowest_leaf && costs[partition] + costs[subset ^ partition] < costs[subset]) {
+                    costs[subset] = costs[partition] + costs[subset ^ partition];
+                    partitions[subset] = partition;
+                }
+            costs[subset] += .125f * bounding_box.getSurfaceArea();
+        }
+
+        // Relinking the treelet only if its cost decreases beyond the rounding errors
+        if(costs[subsets_amount - 1] >= treelet_root->sah_cost * (1.0f - 1e-6f))
+            return;
+
+        int next_internal_node = 0;
+        linkTreelet(subsets_amount - 1, partitions, costs, leaves, internal_nodes, next_internal_node);
+    }
+
+    /**
+    * Function that restructures every treelet of a subtree, bottom up
+    * @param current_node The root of the subtree
+    * @param depth The depth of the node, the subtrees below the given max depth being skipped
+    * @param max_depth The depth below which the subtrees are skipped
+    */
+    static void restructureSubtree(BVHNode * current_node, const int depth, const int max_depth) {
+        if(current_node->primitives_amount > 0 || depth == max_depth)
+            return;
+
+        restructureSubtree(current_node->children[0], depth + 1, max_depth);
+        restructureSubtree(current_node->children[1], depth + 1, max_depth);
+
+        // Updating the cost of the node, whose descendants may have been restructured
+        current_node->sah_cost = .125f * current_node->bounding_box.getSurfaceArea()
+                                 + current_node->children[0]->sah_cost + current_node->children[1]->sah_cost;
+        restructureTreelet(current_node);
+    }
+
+    /**
+    * Function that collects the nodes at the given depth, along with the leaves above it
+    * @param current_node The current node (provide root to start process)
+    * @param depth The depth of the current node
+    * @param frontier_depth The depth of the collected nodes
+    * @param frontier The collected nodes
+    */
+    static void collectFrontier(BVHNode * current_node, const int depth, const int frontier_depth,
+        vector<BVHNode *> & frontier) {
+        if(current_node->primitives_amount > 0 || depth == frontier_depth) {
+            frontier.push_back(current_node);
+            return;
+        }
+
+        collectFrontier(current_node->children[0], depth + 1, frontier_depth, frontier);
+        collectFrontier(current_node->children[1], depth + 1, frontier_depth, frontier);
+    }
+
+    /**
+    * Function that reduces the SAH cost of the tree by restructuring its treelets bottom up, in the style of TRBVH.
+    * The subtrees below a fixed depth are restructured in parallel, then the nodes above them
+    * @return The SAH cost of the tree before and after the optimization, normalized by the root surface area
+    */
+    pair<float, float> optimizeTreelets() {
+        const float root_area = root->bounding_box.getSurfaceArea();
+        const float initial_cost = computeSAHCost(root) / root_area;
+
+        for(int pass = 0; pass < TREELET_OPTIMIZATION_PASSES; pass++) {
+            // Collecting the roots of the independent subtrees, which the previous pass may have moved
+            vector<BVHNode *> frontier;
+            collectFrontier(root, 0, TREELET_PARALLEL_DEPTH, frontier);
+
+            #pragma omp parallel for schedule(dynamic)
+            for(size_t i = 0; i < frontier.size(); i++)
+                restructureSubtree(frontier[i], 0, -1);
+
+            restructureSubtree(root, 0, TREELET_PARALLEL_DEPTH);
+        }
+
+        return {initial_cost, root->sah_cost / root_area};
+    }
+
+    /**
+    * Function that collects the pairs of sibling nodes below an internal node, in depth first order
+    * @param current_node The current internal node, whose children form a new pair
+    * @param pairs The collected pairs
+    * @return The index of the pair holding the children of the node
+    */
+    static int collectNodePairs(const BVHNode * current_node, vector<BVHNodePair> & pairs) {
+        const int pair_index = static_cast<int>(pairs.size());
+        pairs.push_back({{current_node->children[0], current_node->children[1]}, {-1, -1}});
+
+        // Collecting the pairs below each internal child
+        for(int i = 0; i < 2; i++)
+            if(current_node->children[i]->primitives_amount == 0) {
+                const int children_pair = collectNodePairs(current_node->children[i], pairs);
+                pairs[pair_index].children_pairs[i] = children_pair;
+            }
+
+        return pair_index;
+    }
+
+    /**
+    * Function that computes the height of the tree of pairs below the given pair
+    * @param pairs The pairs of sibling nodes
+    * @param pair_index The index of the subtree root
+    * @return The height of the subtree, 1 for a pair of leaves
+    */
+    static int getPairsHeight(const vector<BVHNodePair> & pairs, const int pair_index) {
+        int height = 0;
+        for(const int children_pair : pairs[pair_index].children_pairs)
+            if(children_pair != -1)
+                height = max(height, getPairsHeight(pairs, children_pair));
+        return height + 1;
+    }
+
+    /**
+    * Function that collects the pairs at the given depth below a pair
+    * @param pairs The pairs of sibling nodes
+    * @param pair_index The index of the subtree root
+    * @param depth The depth of the collected pairs, relative to the subtree root
+    * @param collected_pairs The collected pairs, from left to right
+    */
+    static void collectPairsAtDepth(const vector<BVHNodePair> & pairs, const int pair_index, const int depth,
+        vector<int> & collected_pairs) {
+        if(depth == 0) {
+            collected_pairs.push_back(pair_index);
+            return;
+        }
+
+        for(const int children_pair : pairs[pair_index].children_pairs)
+            if(children_pair != -1)
+                collectPairsAtDepth(pairs, children_pair, depth - 1, collected_pairs);
+    }
+
+    /**
+    * Function that lays out the pairs in van Emde Boas order: the top half of the levels of a subtree is laid out
+    * first, followed by each subtree hanging below it, all recursively
+    * @param pairs The pairs of sibling nodes
+    * @param pair_index The index of the subtree root
+    * @param height The amount of levels of the subtree to lay out
+    * @param order The pairs in layout order
+    */
+    static void layoutVanEmdeBoas(const vector<BVHNodePair> & pairs, const int pair_index, const int height,
+        vector<int> & order) {
+        if(height == 1) {
+            order.push_back(pair_index);
+            return;
+        }
+
+        // Laying out the top half of the levels
+        const int top_height = height / 2;
+        layoutVanEmdeBoas(pairs, pair_index, top_height, order);
+
+        // Laying out the bottom subtrees one after the other
+        vector<int> bottom_roots;
+        collectPairsAtDepth(pairs, pair_index, top_height, bottom_roots);
+        for(const int bottom_root : bottom_roots)
+            layoutVanEmdeBoas(pairs, bottom_root, height - top_height, order);
+    }
+
+    /**
+    * Function that lays out the pairs in page sized clusters, each one filled breadth first from its root so that the
+    * top levels of a subtree share a page. The pairs left out of a cluster root the next clusters, depth first
+    * @param pairs The pairs of sibling nodes
+    * @return The pairs in layout order
+    */
+    static vector<int> layoutPageClusters(const vector<BVHNodePair> & pairs) {
+        constexpr int pairs_per_page = static_cast<int>(BVH_LAYOUT_PAGE_SIZE / sizeof(LinearBVHNodePair));
+
+        vector<int> order;
+        order.reserve(pairs.size());
+        vector<int> clusters_roots {0};
+        while(!clusters_roots.empty()) {
+            const int cluster_root = clusters_roots.back();
+            clusters_roots.pop_back();
+
+            // Filling the cluster breadth first
+            deque<int> frontier {cluster_root};
+            for(int placed_pairs = 0; !frontier.empty() && placed_pairs < pairs_per_page; placed_pairs++) {
+                const int pair_index = frontier.front();
+                frontier.pop_front();
+                order.push_back(pair_index);
+
+                for(const int children_pair : pairs[pair_index].children_pairs)
+                    if(children_pair != -1)
+                        frontier.push_back(children_pair);
+            }
+
+            // Queuing the pairs left out, the leftmost one being laid out next
+            clusters_roots.insert(clusters_roots.end(), frontier.rbegin(), frontier.rend());
+        }
+
+        return order;
+    }
+
+    /**
+    * Function that flattens the BVH Tree for faster traversal, the sibling nodes sharing a cache line and the pairs
+    * following the given layout. The primitives are reordered following the leaves in the same layout
+    * @param layout The layout of the pairs of sibling nodes
+    * @param leaves_primitives The primitives in the order referenced by the leaves of the tree
+    */
+    void flattenBVHTree(const bvh_node_layout layout, const vector<Primitive *> & leaves_primitives) {
+        // Collecting the pairs of sibling nodes, the first one holding the root alone
+        vector<BVHNodePair> pairs {{{root, nullptr}, {-1, -1}}};
+        if(root->primitives_amount == 0) {
+            const int children_pair = collectNodePairs(root, pairs);
+            pairs[0].children_pairs[0] = children_pair;
+        }
+
+        // Ordering the pairs, each layout starting from the root
+        vector<int> order;
+        switch(layout) {
+            case VAN_EMDE_BOAS_LAYOUT:
+                layoutVanEmdeBoas(pairs, 0, getPairsHeight(pairs, 0), order);
+                break;
+            case PAGE_CLUSTERS_LAYOUT:
+                order = layoutPageClusters(pairs);
+                break;
+            case DEPTH_FIRST_LAYOUT:
+            default:
+                order.resize(pairs.size());
+                iota(order.begin(), order.end(), 0);
+                break;
+        }
+        vector<int> positions(pairs.size());
+        for(size_t i = 0; i < order.size(); i++)
+            positions[order[i]] = static_cast<int>(i);
+
+        // Writing the pairs in layout order
+        linear_node_pairs.assign(pairs.size(), LinearBVHNodePair());
+        ordered_primitives.clear();
+        ordered_primitives.reserve(leaves_primitives.size());
+        for(size_t i = 0; i < order.size(); i++) {
+            const BVHNodePair & pair = pairs[order[i]];
+            for(int j = 0; j < 2 && pair.nodes[j] != nullptr; j++) {
+                const BVHNode * current_node = pair.nodes[j];
+                LinearBVHNode & current_linear_node = linear_node_pairs[i].nodes[j];
+                current_linear_node.bounding_box = current_node->bounding_box;
+
+                // Case in which the current node is a leaf, its primitives being appended
+                if(current_node->primitives_amount > 0) {
+                    assert(current_node->primitives_amount <= MAX_LEAF_PRIMITIVES);
+                    current_linear_node.first_primitive_index = static_cast<int>(ordered_primitives.size());
+                    current_linear_node.primitives_amount = static_cast<uint16_t>(current_node->primitives_amount);
+                    ordered_primitives.insert(ordered_primitives.end(),
+                        leaves_primitives.begin() + current_node->first_primitive_index,
+                        leaves_primitives.begin() + current_node->first_primitive_index
+                        + current_node->primitives_amount);
+                }
+                // Case in which the current node is an internal node
+                else {
+                    current_linear_node.primitives_amount = 0;
+                    current_linear_node.split_axis = current_node->split_axis;
+                    current_linear_node.children_pair_offset = positions[pair.children_pairs[j]];
+                }
+            }
+        }
+    }
+
+    /**
+    * Function that flattens the BVH Tree with each layout, keeping the one that traverses a set of incoherent rays
+    * crossing the scene the fastest
+    * @param leaves_primitives The primitives in the order referenced by the leaves of the tree
+    * @return The fastest layout
+    */
+    bvh_node_layout measureLayouts(const vector<Primitive *> & leaves_primitives) {
+        // Generating rays with random origins within the scene and random directions, as the secondary rays
+        mt19937 generator(0);
+        uniform_real_distribution<float> uniform_distribution(0.0f, 1.0f);
+        normal_distribution<float> normal_distribution;
+        vector<Ray> rays(BVH_LAYOUT_MEASURED_RAYS);
+        for(auto & ray : rays) {
+            ray.origin = glm::mix(root->bounding_box.min_coordinates, root->bounding_box.max_coordinates,
+                glm::vec3(uniform_distribution(generator), uniform_distribution(generator),
+                    uniform_distribution(generator)));
+            ray.direction = glm::normalize(glm::vec3(normal_distribution(generator), normal_distribution(generator),
+                normal_distribution(generator)));
+        }
+
+        // Timing the traversal with each layout, keeping the best of a few repetitions against the noise
+        constexpr bvh_node_layout layouts[] {DEPTH_FIRST_LAYOUT, VAN_EMDE_BOAS_LAYOUT, PAGE_CLUSTERS_LAYOUT};
+        constexpr const char * layouts_names[] {"depth first", "van Emde Boas", "page clusters"};
+        bvh_node_layout fastest_layout = DEPTH_FIRST_LAYOUT;
+        double fastest_time = INFINITY;
+        for(int i = 0; i < 3; i++) {
+            flattenBVHTree(layouts[i], leaves_primitives);
+
+            double time = INFINITY;
+            for(int repetition = 0; repetition < 3; repetition++) {
+                const double start_time = GetWallTime();
+                #pragma omp parallel for schedule(dynamic, 1024)
+                for(size_t j = 0; j < rays.size(); j++)
+                    static_cast<void>(intersect(rays[j]));
+                time = min(time, GetWallTime() - start_time);
+            }
+
+            if(PRINT_SDS_BUILDING_TIME)
+                PrintGenericMessage("The " + string(layouts_names[i]) + " layout traverses the measuring rays in "
+                    + to_string(1000 * time) + " ms");
+
+            if(time < fastest_time) {
+                fastest_time = time;
+                fastest_layout = layouts[i];
+            }
+        }
+
+        // Discarding the counters of the measuring rays
+        if(USE_RENDER_STATISTICS)
+            static_cast<void>(collectRenderStatistics());
+
+        return fastest_layout;
+    }
+
+    /**
+    * Function that decodes a quantized coordinate. The product being exact, the only rounding is the final sum
+    * @param origin The origin of the quantization grid
+    * @param grid_coordinate The quantized coordinate
+    * @param exponent The exponent of the size of the grid cells
+    * @return The decoded coordinate
+    */
+    static float dequantize(const float origin, const int grid_coordinate, const int exponent) {
+        return origin + static_cast<float>(grid_coordinate) * bit_cast<float>((exponent + 127) << 23);
+    }
+
+    /**
+    * Function that computes the smallest cells size whose 255 cells cover the given extent, once decoded
+    * @param origin The origin of the quantization grid
+    * @param max_coordinate The coordinate to be covered
+    * @return The exponent of the size of the grid cells
+    */
+    static int8_t computeQuantizationExponent(const float origin, const float max_coordinate) {
+        // Estimating the exponent, flat extents using the smallest normal cells
+        const float extent = max_coordinate - origin;
+        int exponent = extent > 0 ? static_cast<int>(ceilf(log2f(extent / 255.0f))) : -126;
+        exponent = glm::clamp(exponent, -126, 127);
+
+        // Growing the cells until the rounding of the decoding still covers the max coordinate
+        while(exponent < 127 && dequantize(origin, 255, exponent) < max_coordinate)
+            exponent++;
+
+        return static_cast<int8_t>(exponent);
+    }
+
+    /**
+    * Function that quantizes a min coordinate, rounding down so that the decoded coordinate never exceeds it
+    * @param coordinate The coordinate to quantize
+    * @param origin The origin of the quantization grid
+    * @param exponent The exponent of the size of the grid cells
+    * @return The quantized coordinate
+    */
+    static uint8_t quantizeMin(const float coordinate, const float origin, const int exponent) {
+        int grid_coordinate = glm::clamp(static_cast<int>(floorf((coordinate - origin)
+                                                                 / bit_cast<float>((exponent + 127) << 23))), 0, 255);
+        while(grid_coordinate > 0 && dequantize(origin, grid_coordinate, exponent) > coordinate)
+            grid_coordinate--;
+        return static_cast<uint8_t>(grid_coordinate);
+    }
+
+    /**
+    * Function that quantizes a max coordinate, rounding up so that the decoded coordinate is never below it
+    * @param coordinate The coordinate to quantize
+    * @param origin The origin of the quantization grid
+    * @param exponent The exponent of the size of the grid cells
+    * @return The quantized coordinate
+    */
+    static uint8_t quantizeMax(const float coordinate, const float origin, const int exponent) {
+        int grid_coordinate = glm::clamp(static_cast<int>(ceilf((coordinate - origin)
+                                                                / bit_cast<float>((exponent + 127) << 23))), 0, 255);
+        while(grid_coordinate < 255 && dequantize(origin, grid_coordinate, exponent) < coordinate)
+            grid_coordinate++;
+        return static_cast<uint8_t>(grid_coordinate);
+    }
+
+    /**
+    * Function that collapses the BVH Tree into 4-wide nodes, quantizing the children bounds relative to their parent
+    * @param current_node The current node to be collapsed (provide root to start process)
+    * @return The created quantized node offset
+    */
+    int buildQuantizedNode(const BVHNode * current_node) {
+        // Collecting up to four children, opening each time the internal child with the largest surface area
+        const BVHNode * children[4];
+        int children_amount = 0;
+        if(current_node->primitives_amount > 0)
+            children[children_amount++] = current_node;
         else {
-            // Setting primitives to 0, since current node is an internal node
-            current_linear_node->primitives_amount = 0;
-            // Extracting data from the tree leaf
-            current_linear_node->split_axis = current_node->split_axis;
-            // Flattening the left child (DFS approach)
-            flattenBVHTree(current_node->children[0], offset);
-            // Flattening the right child and storing his offset
-            current_linear_node->second_child_offset = flattenBVHTree(current_node->children[1], offset);
+            children[children_amount++] = current_node->children[0];
+            children[children_amount++] = current_node->children[1];
+
+            while(children_amount < 4) {
+                int largest = -1;
+                for(int i = 0; i < children_amount; i++)
+                    if(children[i]->primitives_amount == 0 && (largest == -1 ||
+                        children[i]->bounding_box.getSurfaceArea() > children[largest]->bounding_box.getSurfaceArea()))
+                        largest = i;
+
+                // Case in which every child is a leaf
+                if(largest == -1)
+                    break;
+
+                const BVHNode * opened_child = children[largest];
+                children[largest] = opened_child->children[0];
+                children[children_amount++] = opened_child->children[1];
+            }
+        }
+
+        // Reserving the node, its descendants following it (DFS approach)
+        const int current_node_offset = static_cast<int>(quantized_nodes.size());
+        quantized_nodes.emplace_back();
+
+        // Computing the quantization grid over the node bounding box
+        QuantizedBVHNode quantized_node {};
+        quantized_node.origin = current_node->bounding_box.min_coordinates;
+        for(int axis = 0; axis < 3; axis++)
+            quantized_node.exponents[axis] = computeQuantizationExponent(quantized_node.origin[axis],
+                current_node->bounding_box.max_coordinates[axis]);
+        quantized_node.children_amount = static_cast<uint8_t>(children_amount);
+
+        // Quantizing the children bounds conservatively and linking the children
+        for(int i = 0; i < children_amount; i++) {
+            for(int axis = 0; axis < 3; axis++) {
+                quantized_node.children_min[axis][i] = quantizeMin(children[i]->bounding_box.min_coordinates[axis],
+                    quantized_node.origin[axis], quantized_node.exponents[axis]);
+                quantized_node.children_max[axis][i] = quantizeMax(children[i]->bounding_box.max_coordinates[axis],
+                    quantized_node.origin[axis], quantized_node.exponents[axis]);
+            }
+
+            if(children[i]->primitives_amount > 0) {
+                assert(children[i]->primitives_amount <= MAX_LEAF_PRIMITIVES);
+                quantized_node.children_offset[i] = children[i]->first_primitive_index;
+                quantized_node.primitives_amount[i] = static_cast<uint16_t>(children[i]->primitives_amount);
+            }
+            else
+                quantized_node.children_offset[i] = buildQuantizedNode(children[i]);
         }
+
+        quantized_nodes[current_node_offset] = quantized_node;
         return current_node_offset;
     }
 
-    [[nodiscard]] Interaction traversal(const Ray & ray, traversal_mode mode, const float max_distance) const{
-        // Initializing the hit struct
-        Interaction closest_interaction {
-            .hit = false,
-            .distance = INFINITY,
-        };
+    /**
+    * Function that intersects the primitives of a leaf
+    * @param ray The traversing ray
+    * @param first_primitive_index The index of the first primitive of the leaf
+    * @param primitives_amount The amount of primitives of the leaf
+    * @param mode The traversal mode
+    * @param closest_interaction The closest interaction found so far, set to the terminating one if any
+    * @param max_distance The current max distance, shrunk to the closest hit in closest mode
+    * @return True if the traversal can terminate with the closest interaction
+    */
+    bool intersectLeaf(const Ray & ray, const int first_primitive_index, const int primitives_amount,
+        const traversal_mode mode, Interaction & closest_interaction, float & max_distance) const {
+        countStatistic(BVH_LEAVES_TESTED);
+        return intersectPrimitives(ray, & ordered_primitives[first_primitive_index], primitives_amount, mode,
+            closest_interaction, max_distance);
+    }
 
+    /**
+    * Function that traverses the binary linear nodes
+    * @param ray The traversing ray
+    * @param mode The traversal mode
+    * @param closest_interaction The closest interaction found so far, set to the terminating one if any
+    * @param max_distance The max distance of the accepted hits
+    */
+    void traverseLinearNodes(const Ray & ray, const traversal_mode mode, Interaction & closest_interaction,
+        float max_distance) const {
         // Initializing static variables
         const glm::vec3 reciprocals(1 / ray.direction.x, 1 / ray.direction.y, 1 / ray.direction.z);
         const int is_direction_negative[3] = {reciprocals.x < 0, reciprocals.y < 0, reciprocals.z < 0};
 
-        // Offset used
+        // A stack containing the nodes to visit along with their entry distance, each box being tested only once
+        struct NodeToVisit {
+            int index; ///< Index of the node, twice the index of its pair plus its position within the pair
+            float entry_distance; ///< Distance at which the ray enters the node's bounding box
+        };
+        NodeToVisit nodes_to_visit[BVH_MAX_DEPTH + 1];
         int to_visit_offset = 0;
-        int current_index = 0;
-        // An array used as FIFO stack containing the nodes to visit
-        int nodes_to_visit[64];
+
+        // Testing the root bounding box
+        const float root_entry = linear_node_pairs[0].nodes[0].bounding_box.IntersectEntry(ray, reciprocals,
+            is_direction_negative, max_distance);
+        countStatistic(BVH_NODE_BYTES_READ, sizeof(LinearBVHNode));
+        if(root_entry != INFINITY)
+            nodes_to_visit[to_visit_offset++] = {0, root_entry};
 
         // Iterating the BVH
-        while(true && !primitives.empty()) {
+        while(to_visit_offset > 0) {
+            // Popping the next node, skipping it if it starts past the closest hit found since it was pushed
+            const auto [current_index, entry_distance] = nodes_to_visit[--to_visit_offset];
+            if(entry_distance > max_distance)
+                continue;
+
             // Extracting the current node from the array
-            const LinearBVHNode * current_node = & linear_nodes[current_index];
+            const LinearBVHNode * current_node = & linear_node_pairs[current_index / 2].nodes[current_index % 2];
+            countStatistic(BVH_NODES_VISITED);
+
+            // Case in which the node is a leaf
+            if(current_node->primitives_amount > 0) {
+                if(intersectLeaf(ray, current_node->first_primitive_index, current_node->primitives_amount, mode,
+                    closest_interaction, max_distance))
+                    return;
+            }
+            // Case in which the node is an internal node
+            else {
+                // Testing the bounding boxes of both children, which share a cache line
+                const LinearBVHNodePair & children_pair = linear_node_pairs[current_node->children_pair_offset];
+                const int children[2] {2 * current_node->children_pair_offset,
+                                       2 * current_node->children_pair_offset + 1};
+                const float entries[2] {
+                    children_pair.nodes[0].bounding_box.IntersectEntry(ray, reciprocals, is_direction_negative,
+                        max_distance),
+                    children_pair.nodes[1].bounding_box.IntersectEntry(ray, reciprocals, is_direction_negative,
+                        max_distance)
+                };
+                countStatistic(BVH_NODE_BYTES_READ, 2 * sizeof(LinearBVHNode));
+
+                // Pushing the farthest child first, so that the nearest one is visited next
+                const int nearest = entries[1] < entries[0];
+                if(entries[1 - nearest] != INFINITY)
+                    nodes_to_visit[to_visit_offset++] = {children[1 - nearest], entries[1 - nearest]};
+                if(entries[nearest] != INFINITY)
+                    nodes_to_visit[to_visit_offset++] = {children[nearest], entries[nearest]};
+            }
+        }
+    }
 
-            // Computing the Hit struct with the bounding box
-            Interaction box_intersection = current_node->bounding_box.Intersect(ray, reciprocals, is_direction_negative);
+    /**
+    * Function that traverses the quantized nodes, decoding the children bounds on the fly
+    * @param ray The traversing ray
+    * @param mode The traversal mode
+    * @param closest_interaction The closest interaction found so far, set to the terminating one if any
+    * @param max_distance The max distance of the accepted hits
+    */
+    void traverseQuantizedNodes(const Ray & ray, const traversal_mode mode, Interaction & closest_interaction,
+        float max_distance) const {
+        // Initializing static variables
+        const glm::vec3 reciprocals(1 / ray.direction.x, 1 / ray.direction.y, 1 / ray.direction.z);
+        const int is_direction_negative[3] = {reciprocals.x < 0, reciprocals.y < 0, reciprocals.z < 0};
 
-            // Case in which the ray intersects the node's bounding box
-            // if(box_intersection.hit && box_intersection.distance <= closest_interaction.distance) {
-            if(current_node->bounding_box.DoesRayIntersect(ray, reciprocals, is_direction_negative)) {
-                // Case in which the node is a leaf
-                if(current_node->primitives_amount > 0) {
-                    // Iterating all primitives
-                    for(int i = 0; i < current_node->primitives_amount; i++) {
-                        // Initializing the tentative interaction with the current primitive
-                        Interaction tentative_interaction {
-                            .hit = false,
-                            .distance = INFINITY
-                        };
+        // A stack containing the children to visit along with their entry distance, leaves included
+        struct ChildToVisit {
+            int offset; ///< Index of the node, or of the first primitive of a leaf
+            int primitives_amount; ///< Primitives contained in the leaf (0 if internal node)
+            float entry_distance; ///< Distance at which the ray enters the child's bounding box
+        };
+        // Each popped node pushes at most 4 children, and a quantized node is never deeper than the binary nodes it
+        // collapses, so the stack holds at most 3 pending children per level of the BVH
+        ChildToVisit children_to_visit[3 * BVH_MAX_DEPTH + 1];
+        int to_visit_offset = 0;
 
-                        // Computing the intersection with the primitive
-                        primitives[current_node->first_primitive_index + i]->Intersect(ray, tentative_interaction);
-
-                        // Verifying if the hit is valid and better than the current closest hit
-                        if(tentative_interaction.hit) {
-                            switch(mode) {
-                                case FIRST_NOT_TRANSPARENT_WITHIN_DISTANCE: {
-                                    if(tentative_interaction.distance < max_distance
-                                        && tentative_interaction.material->transparency < 1.0f)
-                                        return tentative_interaction;
-                                    break;
-                                }
-                                case FIRST_WITHIN_DISTANCE: {
-                                    if(tentative_interaction.distance <= max_distance)
-                                        return tentative_interaction;
-                                    break;
-                                }
-                                case CLOSEST:
-                                default: {
-                                    if(tentative_interaction.distance < closest_interaction.distance)
-                                        closest_interaction = tentative_interaction;
-                                    break;
-                                }
-                            }
-                        }
-                    }
+        // Starting from the root, whose children bounds cover the scene
+        children_to_visit[to_visit_offset++] = {0, 0, 0.0f};
 
-                    // Verifying if stack is empty
-                    if (to_visit_offset == 0)
-                        break;
+        // Iterating the BVH
+        while(to_visit_offset > 0) {
+            // Popping the next child, skipping it if it starts past the closest hit found since it was pushed
+            const ChildToVisit current_child = children_to_visit[--to_visit_offset];
+            if(current_child.entry_distance > max_distance)
+                continue;
+
+            // Case in which the child is a leaf
+            if(current_child.primitives_amount > 0) {
+                if(intersectLeaf(ray, current_child.offset, current_child.primitives_amount, mode,
+                    closest_interaction, max_distance))
+                    return;
+                continue;
+            }
 
-                    // Popping current node from the stack
-                    current_index = nodes_to_visit[--to_visit_offset];
-                }
-                // Case in which the node is an internal node
-                else {
-                    // Case in which the ray will intersect the second child first
-                    if(is_direction_negative[current_node->split_axis]) {
-                        // Pushing the first child in the stack
-                        nodes_to_visit[to_visit_offset++] = current_index + 1;
-                        // Setting next node to iterate to be the second one
-                        current_index = current_node->second_child_offset;
-                    }
-                    // Case in which the ray will intersect the first child first
-                    else {
-                        // Pushing second child in the stack
-                        nodes_to_visit[to_visit_offset++] = current_node->second_child_offset;
-                        // Setting the next node to iterate to be the first child
-                        current_index = current_index + 1;
-                    }
+            // Extracting the current node from the array
+            const QuantizedBVHNode & current_node = quantized_nodes[current_child.offset];
+            countStatistic(BVH_NODES_VISITED);
+            countStatistic(BVH_NODE_BYTES_READ, sizeof(QuantizedBVHNode));
+
+            // Testing the decoded bounding boxes of the children, sorting the hit ones from the farthest
+            ChildToVisit hit_children[4];
+            int hit_children_amount = 0;
+            for(int i = 0; i < current_node.children_amount; i++) {
+                glm::vec3 min_coordinates, max_coordinates;
+                for(int axis = 0; axis < 3; axis++) {
+                    min_coordinates[axis] = dequantize(current_node.origin[axis],
+                        current_node.children_min[axis][i], current_node.exponents[axis]);
+                    max_coordinates[axis] = dequantize(current_node.origin[axis],
+                        current_node.children_max[axis][i], current_node.exponents[axis]);
                 }
+                const float entry = BoundingBox3(min_coordinates, max_coordinates).IntersectEntry(ray, reciprocals,
+                    is_direction_negative, max_distance);
+                if(entry == INFINITY)
+                    continue;
+
+                int position = hit_children_amount++;
+                for(; position > 0 && hit_children[position - 1].entry_distance < entry; position--)
+                    hit_children[position] = hit_children[position - 1];
+                hit_children[position] = {current_node.children_offset[i], current_node.primitives_amount[i], entry};
             }
-            // Case in which the ray does not intersect the node's bounding box
-            else {
-                // Case in which stack is empty
-                if (to_visit_offset == 0)
-                    break;
-                // Popping current node from the stack
-                current_index = nodes_to_visit[--to_visit_offset];
-            }
-        }
-
-        for(auto & plane : planes) {
-            // Initializing the tentative interaction
-            Interaction tentative_interaction {
-                .hit = false,
-                .distance = INFINITY
-            };
 
-            // Computing the tentative interaction
-            plane->Intersect(ray, tentative_interaction);
-
-            // Updating if necessary
-            if(tentative_interaction.hit && tentative_interaction.distance <= closest_interaction.distance)
-                closest_interaction = tentative_interaction;
+            // Pushing the farthest children first, so that the nearest one is visited next
+            for(int i = 0; i < hit_children_amount; i++)
+                children_to_visit[to_visit_offset++] = hit_children[i];
         }
+    }
 
-        return closest_interaction;
+    void traverse(const Ray & ray, const traversal_mode mode, Interaction & closest_interaction,
+        const float max_distance) const override {
+        // Traversing the nodes in the built layout
+        if(!quantized_nodes.empty())
+            traverseQuantizedNodes(ray, mode, closest_interaction, max_distance);
+        else if(!ordered_primitives.empty() && !linear_node_pairs.empty())
+            traverseLinearNodes(ray, mode, closest_interaction, max_distance);
     }
 
     vector<BVHPrimitiveInfo> primitives_info; ///< Vector of primitive info, used to create the BVH
-    vector<Primitive *> ordered_primitives;
+    vector<Primitive *> ordered_primitives; ///< The primitives in leaves order, spatial splits referencing some twice
+    split_method method = SPLIT_METHOD; ///< The strategy used to split the nodes
+    float root_surface_area = 0; ///< Surface area of the scene bounding box
     int total_nodes = 0;
     BVHNode * root = nullptr;
-    LinearBVHNode * linear_nodes = nullptr;
+    vector<LinearBVHNodePair> linear_node_pairs; ///< The linear nodes, in pairs of siblings placed by the layout
+    vector<QuantizedBVHNode> quantized_nodes; ///< The 4-wide quantized nodes, replacing the linear ones if built
 
 public:
 
     /**
-    * Default constructor
+    * Constructor building the BVH over the primitives of the scene, which are left in their order
+    * @param configuration The configuration selecting the split method and the nodes layout
     */
-    BVH() {
+    explicit BVH(const RenderConfiguration & configuration = render_configuration)
+    : method(configuration.bvh_split_method) {
         // Verifying that there are primitives in the scene
         if(primitives.size() == 0) {
             PrintError("There are not primitives in the scene, cannot build BVH");
@@ -505,8 +1711,8 @@ public:
         }
 
 
-        // Clock time at the beginning of the BVH construction
-        clock_t current_time = clock();
+        // Measuring the BVH construction time
+        const ProfilerScope profiler_scope("build the BVH", "build", PRINT_SDS_BUILDING_TIME);
 
         // Initializing the primitives info
         primitives_info.reserve(primitives.size());
@@ -520,24 +1726,57 @@ public:
             cout << "Starting construction of the BVH..." << endl;
 
         // Building the BVH
-        root = buildNode(primitives_info, 0,
-            primitives.size(), & total_nodes, ordered_primitives);
-
-        // Swapping the global primitives for the ordered primitives
-        primitives.swap(ordered_primitives);
+        if(method == SBVH) {
+            // Computing the scene surface area, against which the overlap of the children is measured
+            BoundingBox3 scene_bounding_box;
+            for(const auto & primitive_info : primitives_info)
+                scene_bounding_box = BoundingBox3::Union(scene_bounding_box, primitive_info.bounding_box);
+            root_surface_area = scene_bounding_box.getSurfaceArea();
+
+            // Building the SBVH, the spatial splits adding up to a fraction of the primitives as references
+            int remaining_duplications = static_cast<int>(SBVH_DUPLICATION_BUDGET
+                                                          * static_cast<float>(primitives.size()));
+            root = buildSpatialNode(primitives_info, & total_nodes, ordered_primitives, remaining_duplications);
+
+            if(PRINT_SDS_BUILDING_TIME)
+                PrintGenericMessage("The SBVH references " + to_string(ordered_primitives.size()) + " primitives for "
+                    + to_string(primitives.size()) + " primitives in the scene");
+        }
+        else if(method == LBVH)
+            root = buildLBVH(& total_nodes, ordered_primitives);
+        else
+            root = buildNode(primitives_info, 0,
+                primitives.size(), & total_nodes, ordered_primitives);
+
+        // Restructuring the treelets of the BVH to reduce its SAH cost
+        if(configuration.use_treelet_optimization) {
+            const ProfilerScope optimization_scope("optimize the BVH treelets", "build", PRINT_SDS_BUILDING_TIME);
+            const auto [initial_cost, optimized_cost] = optimizeTreelets();
+
+            if(PRINT_SDS_BUILDING_TIME)
+                PrintGenericMessage("The treelet optimization reduced the SAH cost of the BVH from "
+                    + to_string(initial_cost) + " to " + to_string(optimized_cost));
+        }
 
-        // Flattening the BVH
-        int flattening_offset = 0;
-        linear_nodes = new LinearBVHNode[total_nodes];
-        flattenBVHTree(root, & flattening_offset);
+        // Bounding the depth of the tree and the primitives of its leaves
+        limitSubtree(root, 0);
 
-        // Computing the execution time
-        current_time = clock() - current_time;
+        // Collapsing the BVH into quantized 4-wide nodes
+        if(configuration.use_quantized_bvh) {
+            buildQuantizedNode(root);
 
-        // Printing the execution time
-        if(PRINT_SDS_BUILDING_TIME)
-            cout << "It took " << ((float)current_time)/CLOCKS_PER_SEC<< " seconds (" <<
-                (float)current_time / CLOCKS_PER_SEC / 60 << " minutes) to build the BVH"<< endl << endl;
+            if(PRINT_SDS_BUILDING_TIME)
+                PrintGenericMessage("The quantized BVH takes " + to_string(quantized_nodes.size()
+                    * sizeof(QuantizedBVHNode) / 1024) + " KB against the " + to_string(total_nodes
+                    * sizeof(LinearBVHNode) / 1024) + " KB of the linear nodes");
+        }
+        // Flattening the BVH in the requested layout, or in the one traversing the scene the fastest
+        else {
+            const vector<Primitive *> leaves_primitives = std::move(ordered_primitives);
+            const bvh_node_layout layout = configuration.bvh_layout == MEASURED_LAYOUT ?
+                measureLayouts(leaves_primitives) : configuration.bvh_layout;
+            flattenBVHTree(layout, leaves_primitives);
+        }
 
 
         // TODO: Tree deconstruction
@@ -546,44 +1785,14 @@ public:
     /**
     * Reset the BVH at factory settings
     */
-    void clear() {
+    void clear() override {
         this->primitives_info.clear();
         this->ordered_primitives.clear();
         this->total_nodes = 0;
         this->root = nullptr;
-        this->linear_nodes = nullptr;
+        this->linear_node_pairs.clear();
+        this->quantized_nodes.clear();
     }
-
-    /**
-    * Function that given a ray returns the closest intersection with a primitive
-    * @param ray A ray expressed in global coordinates
-    * @return Hit struct containing all the data regarding the intersection
-    */
-    [[nodiscard]] Interaction intersect(const Ray & ray) const {
-        return traversal(ray, CLOSEST, INFINITY);
-    }
-
-    /**
-    * Function that given a ray returns the first intersection within the given distance (included)
-    * @param ray A ray expressed in global coordinates
-    * @param max_distance The max distance between the ray origin and the found intersection point
-    * @return Hit struct containing all the data regarding the intersection
-    */
-    [[nodiscard]] Interaction intersectWithinDistance(const Ray & ray, const float max_distance) const {
-        return traversal(ray, FIRST_WITHIN_DISTANCE, max_distance);
-    }
-
-    /**
-    * Function that given a ray returns the first intersection with non trasparent object
-    * within the given distance (included)
-    * @param ray A ray expressed in global coordinates
-    * @param max_distance The max distance between the ray origin and the found intersection point
-    * @return Hit struct containing all the data regarding the intersection
-    */
-    [[nodiscard]] Interaction intersectNoTransparentWithinDistance(const Ray & ray, const float max_distance) const {
-        return traversal(ray, FIRST_NOT_TRANSPARENT_WITHIN_DISTANCE, max_distance);
-    }
-
 };
 
 #endif //BVH_H
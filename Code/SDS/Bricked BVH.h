@@ -0,0 +1,799 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef BRICKED_BVH_H
+#define BRICKED_BVH_H
+
+#include "../Bounds/Bounding Box 3D.h"
+#include "../Primitives/Triangle.h"
+#include "Acceleration Structure.h"
+
+/**
+* Out-of-core SDS partitioning the scene into spatial bricks, each with its own BVH. The nodes and the triangles of the
+* bricks are written to a memory-mapped file one brick at a time, the heap triangles of each brick being released as
+* soon as it is written, and a brick is paged in the first time the traversal of the top level BVH reaches it. The paged
+* in bricks are kept in a cache bounded in size, which evicts the least recently used ones. Each thread holds the bricks
+* it touched until it releases its references, so that the primitives of the interactions it received stay alive while
+* they are shaded. The held bricks stay in the cache and count against its capacity, only the others being evicted
+*/
+class BrickedBVH : public AccelerationStructure {
+    /**
+    * A node of the BVHs, both of the top level one, whose leaves are the bricks, and of the ones within the bricks
+    */
+    struct BrickNode {
+        BoundingBox3 bounding_box; ///< The bounding box of the node
+        int offset; ///< Index of the second child, or of the first primitive (brick leaf) or brick (top level leaf)
+        int primitives_amount; ///< Amount of primitives (brick leaf) or 1 (top level leaf), 0 for internal nodes
+    };
+
+    /**
+    * The appearance of the serialized triangles, shared by the triangles of a mesh
+    */
+    struct TriangleAppearance {
+        const Material * material; ///< The material of the triangle
+        const Texture * albedo_texture; ///< Pointer to the albedo texture
+        const Texture * normal_map; ///< Pointer to the normal map
+        const Texture * AO_R_M_texture; ///< Pointer to the ambient occlusion/roughness/metal
+
+        bool operator==(const TriangleAppearance &) const = default;
+    };
+
+    /**
+    * A primitive as stored in the bricks file. Triangles are stored with the data needed to rebuild them, while the
+    * other primitives stay in memory. The record holds no pointer, the shared data being referenced by its index within
+    * the tables of the structure
+    */
+    struct BrickRecord {
+        int resident_index; ///< Index of the primitive within the resident primitives, -1 for a serialized triangle
+        int appearance_index; ///< Index of the appearance of the triangle
+        int transform_index; ///< Index of the transform of the triangle
+        glm::vec3 coordinates[3]; ///< Coordinates of the vertices in object space
+        glm::vec2 uv_coordinates[3]; ///< Coordinates of the vertices in UV space
+        glm::vec3 normals[3]; ///< Normals of the vertices in object space
+        glm::vec3 tangents[3]; ///< Tangents of the vertices in object space
+        glm::vec3 bitangents[3]; ///< Bitangents of the vertices in object space
+        bool has_uv_coordinates; ///< Flag indicating if the vertices have UV coordinates
+        bool smooth_shading; ///< Flag indicating if the triangle uses smooth shading
+    };
+
+    /**
+    * The location of a brick within the bricks file
+    */
+    struct BrickInfo {
+        size_t file_offset; ///< Offset of the nodes of the brick, aligned to the page size
+        size_t records_offset; ///< Offset of the primitives of the brick
+        size_t file_size; ///< Bytes of the file spanned by the brick
+        int nodes_amount; ///< Amount of nodes of the brick BVH
+        int records_amount; ///< Amount of primitives of the brick
+        size_t resident_size; ///< Bytes taken by the brick once paged in
+    };
+
+    /**
+    * A brick paged in memory
+    */
+    struct ResidentBrick {
+        vector<BrickNode> nodes; ///< The nodes of the brick BVH
+        vector<glm::vec3> coordinates; ///< Coordinates of the vertices of the triangles
+        vector<glm::vec2> uv_coordinates; ///< UV coordinates of the vertices of the triangles
+        vector<Vertex> vertices; ///< The vertices of the triangles, 3 per triangle
+        vector<Triangle> triangles; ///< The triangles rebuilt from the file
+        vector<Primitive *> brick_primitives; ///< The primitives of the brick, in the order of the leaves
+    };
+
+    /**
+    * An entry of the bricks cache
+    */
+    struct CacheEntry {
+        shared_future<shared_ptr<const ResidentBrick>> brick; ///< The brick, ready once its paging in completed
+        list<int>::iterator position; ///< Position of the brick in the usage list
+        int holders; ///< Amount of threads holding the brick, which is not evicted while held
+    };
+
+    /**
+    * A brick held by a thread
+    */
+    struct HeldBrick {
+        uint64_t structure_id; ///< Identifier of the structure owning the brick
+        int brick_index; ///< Index of the brick within its structure
+        shared_ptr<const ResidentBrick> brick; ///< The brick
+    };
+
+    /**
+    * A primitive being partitioned during the construction
+    */
+    struct BuildPrimitive {
+        int index; ///< Index of the primitive within the global vector, or of its record within the brick
+        BoundingBox3 bounding_box; ///< Bounding box of the primitive
+        glm::vec3 centroid; ///< Centroid of the bounding box
+        int resident_index = -1; ///< Index of the primitive within the resident primitives, -1 for a triangle
+        int appearance_index = -1; ///< Index of the appearance of the triangle
+        int transform_index = -1; ///< Index of the transform of the triangle
+    };
+
+    inline static atomic<uint64_t> structures_amount = 0; ///< Amount of built structures, used as identifiers
+    inline static thread_local vector<HeldBrick> held_bricks; ///< The bricks held by the current thread
+
+    const uint64_t structure_id = structures_amount++; ///< Identifier of the structure, tagging its held bricks
+
+    vector<BrickNode> top_nodes; ///< Nodes of the top level BVH, in depth first order
+    vector<BrickInfo> bricks; ///< The bricks stored within the file
+    vector<glm::mat4> transforms; ///< The transforms of the serialized triangles
+    vector<TriangleAppearance> appearances; ///< The appearances of the serialized triangles
+    vector<Primitive *> resident_primitives; ///< The primitives kept in memory, not being triangles
+
+    int file_descriptor = -1; ///< Descriptor of the bricks file
+    const char * mapped_file = nullptr; ///< The bricks file mapped in memory
+    size_t mapped_size = 0; ///< Size of the mapping
+
+    mutable mutex cache_mutex; ///< Mutex protecting cached bricks, usage list and cached size
+    mutable unordered_map<int, CacheEntry> cached_bricks; ///< The bricks in memory or being paged in, by index
+    mutable list<int> usage; ///< Indexes of the cached bricks, from the most to the least recently used
+    mutable size_t cached_size = 0; ///< Bytes taken by the cached bricks, the held ones included
+    size_t capacity; ///< Maximum amount of bytes taken by the cached bricks
+
+    /**
+    * Function that computes the bounding boxes of a range of build primitives and of their centroids
+    * @param build_primitives The build primitives
+    * @param start The first primitive of the range
+    * @param end The primitive following the range
+    * @return The bounding box of the primitives and the one of their centroids
+    */
+    static pair<BoundingBox3, BoundingBox3> computeBounds(const vector<BuildPrimitive> & build_primitives,
+        const int start, const int end) {
+        BoundingBox3 bounding_box, centroids_box;
+        for(int i = start; i < end; i++) {
+            bounding_box = BoundingBox3::Union(bounding_box, build_primitives[i].bounding_box);
+            centroids_box = BoundingBox3::Union(centroids_box, build_primitives[i].centroid);
+        }
+        return {bounding_box, centroids_box};
+    }
+
+    /**
+    * Function that builds the top level BVH, splitting the primitives at the median centroid until they fit a brick
+    * @param build_primitives The primitives of the scene, reordered so that each brick holds a contiguous range
+    * @param start The first primitive of the node
+    * @param end The primitive following the node
+    * @param bricks_ranges The ranges of primitives of the created bricks
+    * @return The index of the created node
+    */
+    int partitionBricks(vector<BuildPrimitive> & build_primitives, const int start, const int end,
+        vector<pair<int, int>> & bricks_ranges) {
+        // Creating the node
+        const auto [bounding_box, centroids_box] = computeBounds(build_primitives, start, end);
+        const int node_index = static_cast<int>(top_nodes.size());
+        top_nodes.push_back({ .bounding_box = bounding_box, .offset = 0, .primitives_amount = 0 });
+
+        // Case in which the primitives fit a brick
+        if(end - start <= BRICK_MAX_PRIMITIVES) {
+            top_nodes[node_index].offset = static_cast<int>(bricks_ranges.size());
+            top_nodes[node_index].primitives_amount = 1;
+            bricks_ranges.emplace_back(start, end);
+            return node_index;
+        }
+
+        // Splitting at the median centroid along the most extended axis
+        const int axis = centroids_box.getMaximumExtend();
+        const int middle = (start + end) / 2;
+        nth_element(build_primitives.begin() + start, build_primitives.begin() + middle,
+            build_primitives.begin() + end, [axis](const BuildPrimitive & first, const BuildPrimitive & second) {
+                return first.centroid[axis] < second.centroid[axis];
+            });
+
+        // Building the children, the first one following the node
+        partitionBricks(build_primitives, start, middle, bricks_ranges);
+        top_nodes[node_index].offset = partitionBricks(build_primitives, middle, end, bricks_ranges);
+
+        return node_index;
+    }
+
+    /**
+    * Function that builds the BVH of a brick with the SAH
+    * @param build_primitives The primitives of the brick, indexed by record
+    * @param start The first primitive of the node
+    * @param end The primitive following the node
+    * @param nodes The nodes of the brick BVH, in depth first order
+    * @param ordered_records The indexes of the records, in the order of the leaves
+    * @param depth The depth of the node, a leaf being forced at BVH_MAX_DEPTH
+    * @return The index of the created node
+    */
+    static int buildBrickNode(vector<BuildPrimitive> & build_primitives, const int start, const int end,
+        vector<BrickNode> & nodes, vector<int> & ordered_records, const int depth = 0) {
+        // Creating the node
+        const auto [bounding_box, centroids_box] = computeBounds(build_primitives, start, end);
+        const int node_index = static_cast<int>(nodes.size());
+        nodes.push_back({ .bounding_box = bounding_box, .offset = 0, .primitives_amount = 0 });
+
+        // Function that turns the node into a leaf
+        const auto createLeaf = [&] {
+            nodes[node_index].offset = static_cast<int>(ordered_records.size());
+            nodes[node_index].primitives_amount = end - start;
+            for(int i = start; i < end; i++)
+                ordered_records.push_back(build_primitives[i].index);
+            return node_index;
+        };
+
+        const int primitives_amount = end - start;
+        if(primitives_amount == 1 || depth >= BVH_MAX_DEPTH)
+            return createLeaf();
+
+        // Case in which the centroids coincide, splitting in the middle unless they fit a leaf
+        const int axis = centroids_box.getMaximumExtend();
+        int middle = (start + end) / 2;
+        if(centroids_box.max_coordinates[axis] == centroids_box.min_coordinates[axis]) {
+            if(primitives_amount <= BRICK_LEAF_PRIMITIVES)
+                return createLeaf();
+        }
+        // Case in which the SAH is used
+        else {
+            // Function that computes the bucket containing a centroid
+            const auto getBucket = [&](const glm::vec3 & centroid) {
+                return min(static_cast<int>(SAH_BUCKETS_AMOUNT * centroids_box.getOffset(centroid)[axis]),
+                    SAH_BUCKETS_AMOUNT - 1);
+            };
+
+            // Filling the buckets
+            int buckets_amounts[SAH_BUCKETS_AMOUNT] {};
+            BoundingBox3 buckets_boxes[SAH_BUCKETS_AMOUNT];
+            for(int i = start; i < end; i++) {
+                const int bucket = getBucket(build_primitives[i].centroid);
+                buckets_amounts[bucket]++;
+                buckets_boxes[bucket] = BoundingBox3::Union(buckets_boxes[bucket], build_primitives[i].bounding_box);
+            }
+
+            // Sweeping the buckets from the right, storing the area weighted amount of each right side
+            float right_costs[SAH_BUCKETS_AMOUNT];
+            BoundingBox3 right_box;
+            int right_amount = 0;
+            for(int i = SAH_BUCKETS_AMOUNT - 1; i > 0; i--) {
+                right_box = BoundingBox3::Union(right_box, buckets_boxes[i]);
+                right_amount += buckets_amounts[i];
+                right_costs[i] = static_cast<float>(right_amount) * right_box.getSurfaceArea();
+            }
+
+            // Sweeping the buckets from the left, looking for the cheapest split
+            BoundingBox3 left_box;
+            int left_amount = 0;
+            float min_cost = INFINITY;
+            int split_bucket = 0;
+            for(int i = 0; i < SAH_BUCKETS_AMOUNT - 1; i++) {
+                left_box = BoundingBox3::Union(left_box, buckets_boxes[i]);
+                left_amount += buckets_amounts[i];
+                const float cost = .125f + (static_cast<float>(left_amount) * left_box.getSurfaceArea()
+                                            + right_costs[i + 1]) / bounding_box.getSurfaceArea();
+                if(left_amount > 0 && left_amount < primitives_amount && cost < min_cost) {
+                    min_cost = cost;
+                    split_bucket = i;
+                }
+            }
+
+            // Creating a leaf if intersecting all the primitives is cheaper than splitting them
+            if(primitives_amount <= BRICK_LEAF_PRIMITIVES && min_cost >= static_cast<float>(primitives_amount))
+                return createLeaf();
+
+            // Partitioning the primitives around the split
+            middle = static_cast<int>(std::partition(build_primitives.begin() + start, build_primitives.begin() + end,
+                [&](const BuildPrimitive & primitive) {
+                    return getBucket(primitive.centroid) <= split_bucket;
+                }) - build_primitives.begin());
+        }
+
+        // Building the children, the first one following the node
+        buildBrickNode(build_primitives, start, middle, nodes, ordered_records, depth + 1);
+        nodes[node_index].offset = buildBrickNode(build_primitives, middle, end, nodes, ordered_records, depth + 1);
+
+        return node_index;
+    }
+
+    /**
+    * Function that returns the index of an entry of a shared table, appending it if missing. The table is searched from
+    * its end, since consecutive primitives mostly belong to the same mesh
+    * @param table The table
+    * @param entry The entry
+    * @return The index of the entry within the table
+    */
+    template <typename T>
+    static int registerEntry(vector<T> & table, const T & entry) {
+        const auto position = find(table.rbegin(), table.rend(), entry);
+        if(position != table.rend())
+            return static_cast<int>(table.rend() - position) - 1;
+
+        table.push_back(entry);
+        return static_cast<int>(table.size()) - 1;
+    }
+
+    /**
+    * Function that registers the data of a primitive within the shared tables, so that its record can be filled while
+    * other bricks are serialized concurrently
+    * @param primitive The primitive
+    * @param build_primitive The build primitive receiving the indexes within the tables
+    */
+    void registerPrimitive(Primitive * primitive, BuildPrimitive & build_primitive) {
+        // Case in which the primitive is not a triangle, keeping it in memory
+        const auto triangle = dynamic_cast<Triangle *>(primitive);
+        if(triangle == nullptr) {
+            build_primitive.resident_index = static_cast<int>(resident_primitives.size());
+            resident_primitives.push_back(primitive);
+            return;
+        }
+
+        // Sharing the transform and the appearance with the previous triangles of the same mesh
+        build_primitive.transform_index = registerEntry(transforms, triangle->transform);
+        build_primitive.appearance_index = registerEntry(appearances, TriangleAppearance {
+            .material = triangle->material,
+            .albedo_texture = triangle->albedo_texture,
+            .normal_map = triangle->normal_map,
+            .AO_R_M_texture = triangle->AO_R_M_texture
+        });
+    }
+
+    /**
+    * Function that fills the record of a primitive, serializing it if it is a triangle
+    * @param build_primitive The registered primitive
+    * @param record The record to fill
+    */
+    static void fillRecord(const BuildPrimitive & build_primitive, BrickRecord & record) {
+        record = BrickRecord {};
+        record.resident_index = build_primitive.resident_index;
+        record.appearance_index = build_primitive.appearance_index;
+        record.transform_index = build_primitive.transform_index;
+
+        // Case in which the primitive is kept in memory
+        if(record.resident_index >= 0)
+            return;
+
+        // Copying the vertices
+        const auto triangle = static_cast<const Triangle *>(primitives[build_primitive.index]);
+        for(int i = 0; i < 3; i++) {
+            const Vertex & vertex = triangle->vertices[i];
+            record.coordinates[i] = * vertex.coordinates;
+            record.uv_coordinates[i] = vertex.uv_coordinates ? * vertex.uv_coordinates : glm::vec2(0.0f);
+            record.normals[i] = vertex.normal;
+            record.tangents[i] = vertex.tangent;
+            record.bitangents[i] = vertex.bitangent;
+        }
+        record.has_uv_coordinates = triangle->vertices[0].uv_coordinates != nullptr;
+        record.smooth_shading = triangle->smooth_shading;
+    }
+
+    /**
+    * Function that pages a brick in, rebuilding its triangles from the file
+    * @param brick_index The index of the brick
+    * @return The paged in brick
+    */
+    [[nodiscard]] shared_ptr<const ResidentBrick> pageIn(const int brick_index) const {
+        countStatistic(BRICK_PAGE_INS);
+        const BrickInfo & info = bricks[brick_index];
+        const auto nodes = reinterpret_cast<const BrickNode *>(mapped_file + info.file_offset);
+        const auto records = reinterpret_cast<const BrickRecord *>(mapped_file + info.records_offset);
+
+        // Copying the nodes
+        const auto brick = make_shared<ResidentBrick>();
+        brick->nodes.assign(nodes, nodes + info.nodes_amount);
+
+        // Reserving the vertices upfront, since the triangles point to them
+        const int triangles_amount = static_cast<int>(count_if(records, records + info.records_amount,
+            [](const BrickRecord & record) { return record.resident_index < 0; }));
+        brick->coordinates.reserve(3 * triangles_amount);
+        brick->uv_coordinates.reserve(3 * triangles_amount);
+        brick->vertices.reserve(3 * triangles_amount);
+        brick->triangles.reserve(triangles_amount);
+        brick->brick_primitives.reserve(info.records_amount);
+
+        // Rebuilding the primitives
+        for(int i = 0; i < info.records_amount; i++) {
+            const BrickRecord & record = records[i];
+
+            // Case in which the primitive stayed in memory
+            if(record.resident_index >= 0) {
+                brick->brick_primitives.push_back(resident_primitives[record.resident_index]);
+                continue;
+            }
+
+            // Rebuilding the vertices
+            const size_t first_vertex = brick->vertices.size();
+            for(int j = 0; j < 3; j++) {
+                brick->coordinates.push_back(record.coordinates[j]);
+                brick->uv_coordinates.push_back(record.uv_coordinates[j]);
+                brick->vertices.push_back(Vertex {
+                    .coordinates = & brick->coordinates.back(),
+                    .uv_coordinates = record.has_uv_coordinates ? & brick->uv_coordinates.back() : nullptr,
+                    .normal = record.normals[j],
+                    .tangent = record.tangents[j],
+                    .bitangent = record.bitangents[j]
+                });
+            }
+
+            // Rebuilding the triangle
+            const TriangleAppearance & appearance = appearances[record.appearance_index];
+            brick->triangles.emplace_back(transforms[record.transform_index], & brick->vertices[first_vertex],
+                record.smooth_shading, appearance.material, appearance.albedo_texture, appearance.normal_map,
+                appearance.AO_R_M_texture);
+            brick->brick_primitives.push_back(& brick->triangles.back());
+        }
+
+        // Releasing the pages of the mapping, the brick being copied
+        madvise(const_cast<char *>(mapped_file + info.file_offset), info.file_size, MADV_DONTNEED);
+
+        return brick;
+    }
+
+    /**
+    * Evicts the least recently used bricks until the capacity is respected. The held bricks, including the ones still
+    * being paged in, are skipped, so that every brick in memory is counted by the cache and paged in only once. Must be
+    * called while holding the cache mutex
+    */
+    void evict() const {
+        auto current = usage.end();
+        while(cached_size > capacity && current != usage.begin()) {
+            --current;
+
+            // Skipping the held bricks
+            const auto entry = cached_bricks.find(* current);
+            if(entry->second.holders > 0)
+                continue;
+
+            // Removing the brick
+            cached_size -= bricks[* current].resident_size;
+            cached_bricks.erase(entry);
+            current = usage.erase(current);
+        }
+    }
+
+    /**
+    * Function that returns a brick, paging it in if it is not cached, and holds it for the current thread
+    * @param brick_index The index of the brick
+    * @return The brick, alive until the thread releases its references
+    */
+    [[nodiscard]] const ResidentBrick * acquireBrick(const int brick_index) const {
+        // Case in which the thread already holds the brick
+        for(const auto & held_brick : held_bricks)
+            if(held_brick.structure_id == structure_id && held_brick.brick_index == brick_index)
+                return held_brick.brick.get();
+
+        promise<shared_ptr<const ResidentBrick>> paging_in;
+        shared_future<shared_ptr<const ResidentBrick>> cached_brick;
+        {
+            lock_guard lock(cache_mutex);
+
+            // Case in which the brick is cached or being paged in
+            if(const auto entry = cached_bricks.find(brick_index); entry != cached_bricks.end()) {
+                usage.splice(usage.begin(), usage, entry->second.position);
+                entry->second.holders++;
+                cached_brick = entry->second.brick;
+            }
+            // Case in which the brick is missing, registering it so that concurrent requests wait for it
+            else {
+                usage.push_front(brick_index);
+                cached_bricks.emplace(brick_index, CacheEntry {
+                    .brick = paging_in.get_future().share(),
+                    .position = usage.begin(),
+                    .holders = 1
+                });
+                cached_size += bricks[brick_index].resident_size;
+                evict();
+            }
+        }
+
+        // Waiting outside the lock in case the brick is still being paged in, or paging it in
+        shared_ptr<const ResidentBrick> brick;
+        if(cached_brick.valid())
+            brick = cached_brick.get();
+        else {
+            brick = pageIn(brick_index);
+            paging_in.set_value(brick);
+        }
+
+        // Holding the brick
+        held_bricks.push_back({ .structure_id = structure_id, .brick_index = brick_index, .brick = brick });
+        return brick.get();
+    }
+
+    /**
+    * Function that traverses the BVH of a brick
+    * @param ray The traversing ray
+    * @param reciprocals The ray direction reciprocals
+    * @param is_direction_negative An array indicating weather or not the ray reciprocals are negative
+    * @param brick The brick
+    * @param mode The traversal mode
+    * @param closest_interaction The closest interaction found so far, set to the terminating one if any
+    * @param max_distance The current max distance, shrunk to the closest hit in closest mode
+    * @return True if the traversal can terminate with the closest interaction
+    */
+    static bool traverseBrick(const Ray & ray, const glm::vec3 & reciprocals, const int is_direction_negative[3],
+        const ResidentBrick & brick, const traversal_mode mode, Interaction & closest_interaction,
+        float & max_distance) {
+        // A stack containing the nodes to visit along with their entry distance
+        struct NodeToVisit {
+            int index; ///< Index of the node
+            float entry_distance; ///< Distance at which the ray enters the node's bounding box
+        };
+        NodeToVisit nodes_to_visit[BVH_MAX_DEPTH + 1];
+        int to_visit_offset = 0;
+        nodes_to_visit[to_visit_offset++] = {0, 0.0f};
+
+        // Iterating the BVH
+        while(to_visit_offset > 0) {
+            // Popping the next node, skipping it if it starts past the closest hit found since it was pushed
+            const auto [current_index, entry_distance] = nodes_to_visit[--to_visit_offset];
+            if(entry_distance > max_distance)
+                continue;
+
+            const BrickNode & current_node = brick.nodes[current_index];
+            countStatistic(BVH_NODES_VISITED);
+
+            // Case in which the node is a leaf
+            if(current_node.primitives_amount > 0) {
+                countStatistic(BVH_LEAVES_TESTED);
+                if(intersectPrimitives(ray, brick.brick_primitives.data() + current_node.offset,
+                    current_node.primitives_amount, mode, closest_interaction, max_distance))
+                    return true;
+                continue;
+            }
+
+            // Testing the bounding boxes of both children
+            const int children[2] {current_index + 1, current_node.offset};
+            const float entries[2] {
+                brick.nodes[children[0]].bounding_box.IntersectEntry(ray, reciprocals, is_direction_negative,
+                    max_distance),
+                brick.nodes[children[1]].bounding_box.IntersectEntry(ray, reciprocals, is_direction_negative,
+                    max_distance)
+            };
+            countStatistic(BVH_NODE_BYTES_READ, 2 * sizeof(BrickNode));
+
+            // Pushing the farthest child first, so that the nearest one is visited next
+            const int nearest = entries[1] < entries[0];
+            if(entries[1 - nearest] != INFINITY)
+                nodes_to_visit[to_visit_offset++] = {children[1 - nearest], entries[1 - nearest]};
+            if(entries[nearest] != INFINITY)
+                nodes_to_visit[to_visit_offset++] = {children[nearest], entries[nearest]};
+        }
+
+        return false;
+    }
+
+protected:
+    void traverse(const Ray & ray, const traversal_mode mode, Interaction & closest_interaction,
+        float max_distance) const override {
+        // Case in which there are no bricks to traverse
+        if(top_nodes.empty())
+            return;
+
+        // Initializing static variables
+        const glm::vec3 reciprocals(1 / ray.direction.x, 1 / ray.direction.y, 1 / ray.direction.z);
+        const int is_direction_negative[3] = {reciprocals.x < 0, reciprocals.y < 0, reciprocals.z < 0};
+
+        // A stack containing the nodes to visit along with their entry distance
+        struct NodeToVisit {
+            int index; ///< Index of the node
+            float entry_distance; ///< Distance at which the ray enters the node's bounding box
+        };
+        NodeToVisit nodes_to_visit[BVH_MAX_DEPTH + 1];
+        int to_visit_offset = 0;
+
+        // Testing the root bounding box
+        const float root_entry = top_nodes[0].bounding_box.IntersectEntry(ray, reciprocals, is_direction_negative,
+            max_distance);
+        if(root_entry != INFINITY)
+            nodes_to_visit[to_visit_offset++] = {0, root_entry};
+
+        // Iterating the top level BVH
+        while(to_visit_offset > 0) {
+            // Popping the next node, skipping it if it starts past the closest hit found since it was pushed
+            const auto [current_index, entry_distance] = nodes_to_visit[--to_visit_offset];
+            if(entry_distance > max_distance)
+                continue;
+
+            const BrickNode & current_node = top_nodes[current_index];
+            countStatistic(BVH_NODES_VISITED);
+
+            // Case in which the node is a brick, paging it in if needed
+            if(current_node.primitives_amount > 0) {
+                if(traverseBrick(ray, reciprocals, is_direction_negative, * acquireBrick(current_node.offset), mode,
+                    closest_interaction, max_distance))
+                    return;
+                continue;
+            }
+
+            // Testing the bounding boxes of both children
+            const int children[2] {current_index + 1, current_node.offset};
+            const float entries[2] {
+                top_nodes[children[0]].bounding_box.IntersectEntry(ray, reciprocals, is_direction_negative,
+                    max_distance),
+                top_nodes[children[1]].bounding_box.IntersectEntry(ray, reciprocals, is_direction_negative,
+                    max_distance)
+            };
+            countStatistic(BVH_NODE_BYTES_READ, 2 * sizeof(BrickNode));
+
+            // Pushing the farthest child first, so that the nearest one is visited next
+            const int nearest = entries[1] < entries[0];
+            if(entries[1 - nearest] != INFINITY)
+                nodes_to_visit[to_visit_offset++] = {children[1 - nearest], entries[1 - nearest]};
+            if(entries[nearest] != INFINITY)
+                nodes_to_visit[to_visit_offset++] = {children[nearest], entries[nearest]};
+        }
+    }
+
+public:
+    /**
+    * Constructor partitioning the primitives of the scene into bricks and writing them to the bricks file. The
+    * serialized triangles are removed from the primitives of the scene and released once the whole file is written and
+    * mapped. If the file cannot be written the scene is left untouched and the structure is left empty, not paging
+    * out any triangle
+    * @param configuration The configuration providing the cache size and the directory of the bricks file
+    */
+    explicit BrickedBVH(const RenderConfiguration & configuration = render_configuration)
+    : capacity(static_cast<size_t>(configuration.bricks_cache_size) * 1024 * 1024) {
+        // Verifying that there are primitives in the scene
+        if(primitives.empty()) {
+            PrintError("There are not primitives in the scene, cannot build the bricked BVH");
+            return;
+        }
+
+        // Measuring the bricks construction time
+        const ProfilerScope profiler_scope("build the bricked BVH", "build", PRINT_SDS_BUILDING_TIME);
+
+        // Creating the bricks file, removed as soon as it is closed
+        const filesystem::path directory = configuration.bricks_directory.empty() ?
+            filesystem::temp_directory_path() : filesystem::path(configuration.bricks_directory);
+        const filesystem::path file_path = directory / ("bricks_" + to_string(getpid()) + "_"
+            + to_string(structure_id) + ".bin");
+        file_descriptor = open(file_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if(file_descriptor < 0) {
+            PrintError("Cannot create the bricks file " + file_path.string());
+            return;
+        }
+        unlink(file_path.c_str());
+
+        // Partitioning the primitives into bricks, registering the data they share
+        vector<BuildPrimitive> build_primitives(primitives.size());
+        for(size_t i = 0; i < primitives.size(); i++) {
+            const BoundingBox3 bounding_box = primitives[i]->getWorldSpaceBoundingBox();
+            build_primitives[i] = {
+                .index = static_cast<int>(i),
+                .bounding_box = bounding_box,
+                .centroid = 0.5f * (bounding_box.min_coordinates + bounding_box.max_coordinates)
+            };
+            registerPrimitive(primitives[i], build_primitives[i]);
+        }
+        vector<pair<int, int>> bricks_ranges;
+        partitionBricks(build_primitives, 0, static_cast<int>(build_primitives.size()), bricks_ranges);
+
+        // Laying out the bricks, each starting on a page and spanning the most nodes its BVH may have
+        const size_t page_size = sysconf(_SC_PAGESIZE);
+        bricks.resize(bricks_ranges.size());
+        for(size_t i = 0; i < bricks.size(); i++) {
+            const auto [start, end] = bricks_ranges[i];
+            bricks[i].file_offset = mapped_size;
+            bricks[i].records_offset = mapped_size + (2 * (end - start) - 1) * sizeof(BrickNode);
+            bricks[i].records_amount = end - start;
+            bricks[i].file_size = (bricks[i].records_offset + (end - start) * sizeof(BrickRecord)
+                                   - bricks[i].file_offset + page_size - 1) / page_size * page_size;
+            mapped_size += bricks[i].file_size;
+        }
+        if(ftruncate(file_descriptor, static_cast<off_t>(mapped_size)) != 0) {
+            PrintError("Cannot allocate the bricks file " + file_path.string());
+            clear();
+            return;
+        }
+
+        // Building and writing the bricks, serializing the primitives of each brick only while it is written
+        bool is_file_written = true;
+        #pragma omp parallel for schedule(dynamic)
+        for(int i = 0; i < static_cast<int>(bricks.size()); i++) {
+            const auto [start, end] = bricks_ranges[i];
+
+            // Building the BVH of the brick over its records
+            vector<BuildPrimitive> brick_primitives(build_primitives.begin() + start, build_primitives.begin() + end);
+            for(int j = 0; j < end - start; j++)
+                brick_primitives[j].index = j;
+            vector<BrickNode> nodes;
+            vector<int> ordered_records;
+            buildBrickNode(brick_primitives, 0, end - start, nodes, ordered_records);
+            bricks[i].nodes_amount = static_cast<int>(nodes.size());
+
+            // Serializing the primitives in the order of the leaves
+            vector<BrickRecord> brick_records(end - start);
+            for(int j = 0; j < end - start; j++)
+                fillRecord(build_primitives[start + ordered_records[j]], brick_records[j]);
+
+            // Computing the size of the brick once paged in
+            const size_t triangles_amount = count_if(brick_records.begin(), brick_records.end(),
+                [](const BrickRecord & record) { return record.resident_index < 0; });
+            bricks[i].resident_size = sizeof(ResidentBrick) + nodes.size() * sizeof(BrickNode)
+                + triangles_amount * (sizeof(Triangle) + 3 * (sizeof(Vertex) + sizeof(glm::vec3) + sizeof(glm::vec2)))
+                + brick_records.size() * sizeof(Primitive *);
+
+            // Writing the brick
+            const auto nodes_bytes = static_cast<ssize_t>(nodes.size() * sizeof(BrickNode));
+            const auto records_bytes = static_cast<ssize_t>(brick_records.size() * sizeof(BrickRecord));
+            if(pwrite(file_descriptor, nodes.data(), nodes_bytes, static_cast<off_t>(bricks[i].file_offset))
+                != nodes_bytes || pwrite(file_descriptor, brick_records.data(), records_bytes,
+                static_cast<off_t>(bricks[i].records_offset)) != records_bytes) {
+                #pragma omp atomic write
+                is_file_written = false;
+            }
+        }
+
+        // Mapping the file, keeping the triangles of the scene if any brick could not be written
+        void * mapping = is_file_written ?
+            mmap(nullptr, mapped_size, PROT_READ, MAP_SHARED, file_descriptor, 0) : MAP_FAILED;
+        if(mapping == MAP_FAILED) {
+            PrintError("Cannot write and map the bricks file " + file_path.string());
+            clear();
+            return;
+        }
+        mapped_file = static_cast<const char *>(mapping);
+
+        // Releasing the serialized triangles, which are paged in from the file from now on
+        for(const auto & build_primitive : build_primitives) {
+            if(build_primitive.resident_index >= 0)
+                continue;
+            delete static_cast<Triangle *>(primitives[build_primitive.index]);
+            primitives[build_primitive.index] = nullptr;
+        }
+        erase(primitives, nullptr);
+
+        if(PRINT_SDS_BUILDING_TIME)
+            PrintGenericMessage("The bricked BVH has " + to_string(bricks.size()) + " bricks, written to a "
+                + to_string(mapped_size / (1024 * 1024)) + " MB file");
+    }
+
+    ~BrickedBVH() override {
+        BrickedBVH::clear();
+    }
+
+    [[nodiscard]] bool hasPagedOutTriangles() const override {
+        return mapped_file != nullptr;
+    }
+
+    /**
+    * Releases the bricks held by the current thread, which must not use the interactions it received anymore
+    */
+    void releaseThreadReferences() const override {
+        lock_guard lock(cache_mutex);
+        erase_if(held_bricks, [this](const HeldBrick & held_brick) {
+            if(held_brick.structure_id != structure_id)
+                return false;
+
+            // Letting the cache evict the brick once no thread holds it
+            if(const auto entry = cached_bricks.find(held_brick.brick_index); entry != cached_bricks.end())
+                entry->second.holders--;
+            return true;
+        });
+
+        // Evicting the bricks exceeding the capacity while they were held
+        evict();
+    }
+
+    /**
+    * Reset the bricked BVH at factory settings, closing the bricks file
+    */
+    void clear() override {
+        // Emptying the cache
+        releaseThreadReferences();
+        {
+            lock_guard lock(cache_mutex);
+            cached_bricks.clear();
+            usage.clear();
+            cached_size = 0;
+        }
+
+        // Closing the file
+        if(mapped_file)
+            munmap(const_cast<char *>(mapped_file), mapped_size);
+        if(file_descriptor >= 0)
+            close(file_descriptor);
+        mapped_file = nullptr;
+        mapped_size = 0;
+        file_descriptor = -1;
+
+        top_nodes.clear();
+        bricks.clear();
+        transforms.clear();
+        appearances.clear();
+        resident_primitives.clear();
+    }
+};
+
+#endif //BRICKED_BVH_H
@@ -0,0 +1,289 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef KD_TREE_H
+#define KD_TREE_H
+
+#include "../Bounds/Bounding Box 3D.h"
+#include "Acceleration Structure.h"
+
+/**
+* Implementation of a KD tree SDS built with the SAH, whose split planes are chosen among the bounds of the primitives.
+* The primitives straddling a plane are referenced by both sides, and the traversal visits the leaves front to back
+* with a short stack, stopping as soon as the closest hit precedes the next leaf
+*/
+class KDTree : public AccelerationStructure {
+    // Struct used to represent a node in 8 bytes
+    struct KDNode {
+        /**
+        * Function that initializes leaves
+        */
+        void initializeLeaf(const int first_index, const int amount) {
+            first_primitive_index = first_index;
+            flags = static_cast<uint32_t>(amount) << 2 | 3;
+        }
+        /**
+        * Function that initializes an internal node, whose below child directly follows it
+        */
+        void initializeInternal(const int axis, const int above_child_index, const float position) {
+            split_position = position;
+            flags = static_cast<uint32_t>(above_child_index) << 2 | static_cast<uint32_t>(axis);
+        }
+        [[nodiscard]] bool isLeaf() const { return (flags & 3) == 3; }
+        [[nodiscard]] int getSplitAxis() const { return static_cast<int>(flags & 3); }
+        [[nodiscard]] int getPrimitivesAmount() const { return static_cast<int>(flags >> 2); }
+        [[nodiscard]] int getAboveChild() const { return static_cast<int>(flags >> 2); }
+
+        union {
+            float split_position; ///< Position of the split plane of this internal node
+            int first_primitive_index; ///< Index of the first primitive of this leaf within the leaves primitives
+        };
+        uint32_t flags; ///< Split axis in the two lowest bits (3 if leaf), the primitives amount or above child after
+    };
+
+    // Struct used to represent the start or the end of a primitive bounding box along an axis
+    struct BoundEdge {
+        float position; ///< Position of the edge along the axis
+        int primitive_index; ///< Index of the primitive
+        bool is_start; ///< Flag indicating weather the edge starts or ends the bounding box
+    };
+
+    vector<KDNode> nodes; ///< The nodes in depth first order
+    vector<Primitive *> leaves_primitives; ///< The primitives of each leaf, one after the other
+    BoundingBox3 bounding_box; ///< The bounding box of the scene
+    int max_depth = 0; ///< Depth past which leaves are forced
+
+    /**
+    * Function that builds a node, recursively
+    * @param node_bounding_box The bounding box of the node
+    * @param primitives_boxes The bounding boxes of the primitives
+    * @param primitive_indexes The indexes of the primitives overlapping the node
+    * @param depth The remaining depth
+    * @param edges Buffers of the edges along each axis, shared by the whole build
+    * @param bad_refines Amount of splits above this node that did not lower the SAH cost
+    */
+    void buildNode(const BoundingBox3 & node_bounding_box, const vector<BoundingBox3> & primitives_boxes,
+        const vector<int> & primitive_indexes, const int depth, vector<BoundEdge> (& edges)[3], int bad_refines) {
+        const int node_index = static_cast<int>(nodes.size());
+        nodes.emplace_back();
+        const int primitives_amount = static_cast<int>(primitive_indexes.size());
+
+        // Function that creates a leaf with every primitive of the node
+        const auto createLeaf = [&] {
+            nodes[node_index].initializeLeaf(static_cast<int>(leaves_primitives.size()), primitives_amount);
+            for(const int primitive_index : primitive_indexes)
+                leaves_primitives.push_back(primitives[primitive_index]);
+        };
+
+        // Case in which the node is small or deep enough to be a leaf
+        if(primitives_amount <= KD_TREE_MAX_LEAF_PRIMITIVES || depth == 0) {
+            createLeaf();
+            return;
+        }
+
+        // Initializing the split search
+        const glm::vec3 extent = node_bounding_box.max_coordinates - node_bounding_box.min_coordinates;
+        const float inverse_surface_area = 1.0f / node_bounding_box.getSurfaceArea();
+        const float leaf_cost = KD_TREE_INTERSECTION_COST * static_cast<float>(primitives_amount);
+        float best_cost = INFINITY;
+        int best_axis = -1, best_edge = -1;
+
+        // Trying the edges along the longest axis first, then along the others if none falls within the node
+        int axis = node_bounding_box.getMaximumExtend();
+        for(int retries = 0; retries < 3 && best_axis == -1; retries++, axis = (axis + 1) % 3) {
+            // Sorting the edges of the primitives, the starts preceding the ends at the same position
+            for(int i = 0; i < primitives_amount; i++) {
+                const BoundingBox3 & primitive_box = primitives_boxes[primitive_indexes[i]];
+                edges[axis][2 * i] = {primitive_box.min_coordinates[axis], primitive_indexes[i], true};
+                edges[axis][2 * i + 1] = {primitive_box.max_coordinates[axis], primitive_indexes[i], false};
+            }
+            sort(edges[axis].begin(), edges[axis].begin() + 2 * primitives_amount,
+                [](const BoundEdge & first, const BoundEdge & second) {
+                    return first.position < second.position
+                        || (first.position == second.position && first.is_start && !second.is_start);
+                });
+
+            // Sweeping the edges, computing the cost of splitting at each of them
+            const int other_axes[2] {(axis + 1) % 3, (axis + 2) % 3};
+            int below_amount = 0, above_amount = primitives_amount;
+            for(int i = 0; i < 2 * primitives_amount; i++) {
+                if(!edges[axis][i].is_start)
+                    above_amount--;
+
+                const float position = edges[axis][i].position;
+                if(position > node_bounding_box.min_coordinates[axis] &&
+                    position < node_bounding_box.max_coordinates[axis]) {
+                    // Computing the surface area of both sides
+                    const float face_area = extent[other_axes[0]] * extent[other_axes[1]];
+                    const float perimeter = extent[other_axes[0]] + extent[other_axes[1]];
+                    const float below_area = 2 * (face_area
+                                                  + (position - node_bounding_box.min_coordinates[axis]) * perimeter);
+                    const float above_area = 2 * (face_area
+                                                  + (node_bounding_box.max_coordinates[axis] - position) * perimeter);
+
+                    // Computing the cost, rewarding the splits cutting off empty space
+                    const float empty_bonus = below_amount == 0 || above_amount == 0 ? KD_TREE_EMPTY_BONUS : 0.0f;
+                    const float cost = KD_TREE_TRAVERSAL_COST + KD_TREE_INTERSECTION_COST * (1 - empty_bonus)
+                                       * inverse_surface_area * (below_area * static_cast<float>(below_amount)
+                                                                 + above_area * static_cast<float>(above_amount));
+
+                    if(cost < best_cost) {
+                        best_cost = cost;
+                        best_axis = axis;
+                        best_edge = i;
+                    }
+                }
+
+                if(edges[axis][i].is_start)
+                    below_amount++;
+            }
+        }
+
+        // Creating a leaf if no split is worth it, tolerating a few bad splits in the hope of better ones below
+        if(best_cost > leaf_cost)
+            bad_refines++;
+        if((best_cost > 4 * leaf_cost && primitives_amount < 16) || best_axis == -1 || bad_refines == 3) {
+            createLeaf();
+            return;
+        }
+
+        // Classifying the primitives with respect to the split, the straddling ones going to both sides
+        vector<int> below_indexes, above_indexes;
+        for(int i = 0; i < best_edge; i++)
+            if(edges[best_axis][i].is_start)
+                below_indexes.push_back(edges[best_axis][i].primitive_index);
+        for(int i = best_edge + 1; i < 2 * primitives_amount; i++)
+            if(!edges[best_axis][i].is_start)
+                above_indexes.push_back(edges[best_axis][i].primitive_index);
+
+        // Building the children, the below one directly following this node
+        const float split_position = edges[best_axis][best_edge].position;
+        BoundingBox3 below_box = node_bounding_box, above_box = node_bounding_box;
+        below_box.max_coordinates[best_axis] = above_box.min_coordinates[best_axis] = split_position;
+
+        buildNode(below_box, primitives_boxes, below_indexes, depth - 1, edges, bad_refines);
+        nodes[node_index].initializeInternal(best_axis, static_cast<int>(nodes.size()), split_position);
+        buildNode(above_box, primitives_boxes, above_indexes, depth - 1, edges, bad_refines);
+    }
+
+protected:
+    void traverse(const Ray & ray, const traversal_mode mode, Interaction & closest_interaction,
+        float max_distance) const override {
+        // Case in which there is no tree to traverse
+        if(nodes.empty())
+            return;
+
+        // Initializing static variables
+        const glm::vec3 reciprocals(1 / ray.direction.x, 1 / ray.direction.y, 1 / ray.direction.z);
+        const int is_direction_negative[3] = {reciprocals.x < 0, reciprocals.y < 0, reciprocals.z < 0};
+
+        // Clipping the ray to the scene
+        float min_distance, exit_distance;
+        if(!bounding_box.IntersectRange(ray, reciprocals, is_direction_negative, min_distance, exit_distance))
+            return;
+
+        // A short stack containing the far children to visit along with the range of the ray within them
+        struct NodeToVisit {
+            int index; ///< Index of the node
+            float min_distance; ///< Distance at which the ray enters the node
+            float max_distance; ///< Distance at which the ray exits the node
+        };
+        NodeToVisit nodes_to_visit[64];
+        int to_visit_offset = 0;
+
+        // Iterating the tree, until the closest hit precedes the next node
+        int current_index = 0;
+        while(min_distance <= max_distance) {
+            const KDNode & current_node = nodes[current_index];
+
+            // Case in which the node is an internal node
+            if(!current_node.isLeaf()) {
+                // Computing the distance of the split plane
+                const int axis = current_node.getSplitAxis();
+                const float plane_distance = (current_node.split_position - ray.origin[axis]) * reciprocals[axis];
+
+                // Ordering the children along the ray
+                const bool is_below_first = ray.origin[axis] < current_node.split_position ||
+                    (ray.origin[axis] == current_node.split_position && ray.direction[axis] <= 0);
+                const int first_child = is_below_first ? current_index + 1 : current_node.getAboveChild();
+                const int second_child = is_below_first ? current_node.getAboveChild() : current_index + 1;
+
+                // Visiting only the children crossed by the ray within the node
+                if(plane_distance > exit_distance || plane_distance <= 0)
+                    current_index = first_child;
+                else if(plane_distance < min_distance)
+                    current_index = second_child;
+                else {
+                    nodes_to_visit[to_visit_offset++] = {second_child, plane_distance, exit_distance};
+                    current_index = first_child;
+                    exit_distance = plane_distance;
+                }
+            }
+            // Case in which the node is a leaf
+            else {
+                if(intersectPrimitives(ray, leaves_primitives.data() + current_node.first_primitive_index,
+                    current_node.getPrimitivesAmount(), mode, closest_interaction, max_distance))
+                    return;
+
+                // Popping the next node
+                if(to_visit_offset == 0)
+                    return;
+                to_visit_offset--;
+                current_index = nodes_to_visit[to_visit_offset].index;
+                min_distance = nodes_to_visit[to_visit_offset].min_distance;
+                exit_distance = nodes_to_visit[to_visit_offset].max_distance;
+            }
+        }
+    }
+
+public:
+    /**
+    * Constructor building the KD tree over the primitives of the scene
+    */
+    KDTree() {
+        // Verifying that there are primitives in the scene
+        if(primitives.empty()) {
+            PrintError("There are not primitives in the scene, cannot build the KD tree");
+            return;
+        }
+
+        // Measuring the KD tree construction time
+        const ProfilerScope profiler_scope("build the SAH KD tree", "build", PRINT_SDS_BUILDING_TIME);
+
+        // Computing the bounding boxes of the primitives and of the scene
+        vector<BoundingBox3> primitives_boxes(primitives.size());
+        vector<int> primitive_indexes(primitives.size());
+        for(size_t i = 0; i < primitives.size(); i++) {
+            primitives_boxes[i] = primitives[i]->getWorldSpaceBoundingBox();
+            primitive_indexes[i] = static_cast<int>(i);
+            bounding_box = BoundingBox3::Union(bounding_box, primitives_boxes[i]);
+        }
+
+        // Bounding the depth, so that the stack of the traversal cannot overflow
+        max_depth = KD_TREE_MAX_DEPTH > 0 ? KD_TREE_MAX_DEPTH :
+            static_cast<int>(roundf(8 + 1.3f * log2f(static_cast<float>(primitives.size()))));
+        max_depth = min(max_depth, 63);
+
+        // Building the tree
+        vector<BoundEdge> edges[3];
+        for(auto & axis_edges : edges)
+            axis_edges.resize(2 * primitives.size());
+        buildNode(bounding_box, primitives_boxes, primitive_indexes, max_depth, edges, 0);
+
+        if(PRINT_SDS_BUILDING_TIME)
+            PrintGenericMessage("The KD tree has " + to_string(nodes.size()) + " nodes referencing "
+                + to_string(leaves_primitives.size()) + " primitives");
+    }
+
+    /**
+    * Reset the KD tree at factory settings
+    */
+    void clear() override {
+        nodes.clear();
+        leaves_primitives.clear();
+        bounding_box = BoundingBox3();
+    }
+};
+
+#endif //KD_TREE_H
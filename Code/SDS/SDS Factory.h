@@ -0,0 +1,43 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef SDS_FACTORY_H
+#define SDS_FACTORY_H
+
+#include "Acceleration Structure.h"
+#include "BVH.h"
+#include "KD Tree.h"
+#include "Uniform Grid.h"
+#include "Bricked BVH.h"
+
+/**
+* Function that builds the SDS selected by the configuration over the primitives of the scene
+* @param configuration The configuration selecting the SDS and its options
+* @return The built SDS, the BVH standing in for the SDS not implemented and for the bricked BVH that failed
+*/
+inline AccelerationStructure * buildSDS(const RenderConfiguration & configuration = render_configuration) {
+    switch(configuration.sds_type) {
+        case NO_SDS:
+            return new PrimitivesList();
+        case KD_TREE_SDS:
+            return new KDTree();
+        case GRID_SDS:
+            return new UniformGrid();
+        case BRICKED_SDS: {
+            // Keeping the triangles in memory if the bricks could not be written
+            const auto bricked_bvh = new BrickedBVH(configuration);
+            if(bricked_bvh->hasPagedOutTriangles() || primitives.empty())
+                return bricked_bvh;
+            delete bricked_bvh;
+            PrintError("Paging the triangles out failed, building the BVH in memory instead");
+            return new BVH(configuration);
+        }
+        case BVH_SDS:
+        case BASIC_BOXING:
+        default:
+            return new BVH(configuration);
+    }
+}
+
+#endif //SDS_FACTORY_H
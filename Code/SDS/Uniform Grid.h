@@ -0,0 +1,191 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef UNIFORM_GRID_H
+#define UNIFORM_GRID_H
+
+#include "../Bounds/Bounding Box 3D.h"
+#include "Acceleration Structure.h"
+
+/**
+* Implementation of a uniform grid SDS, whose voxels reference every primitive overlapping them. The traversal steps
+* through the voxels crossed by the ray with a 3D-DDA, stopping as soon as the closest hit precedes the next voxel
+*/
+class UniformGrid : public AccelerationStructure {
+    BoundingBox3 bounding_box; ///< The bounding box of the scene
+    glm::ivec3 voxels_amount {0}; ///< Amount of voxels along each axis
+    glm::vec3 voxel_size {0}; ///< Size of a voxel along each axis
+    glm::vec3 inverse_voxel_size {0}; ///< Reciprocal of the voxel size, 0 along the flat axes
+    vector<int> voxels_offsets; ///< Index of the first primitive of each voxel, followed by the total amount
+    vector<Primitive *> voxels_primitives; ///< The primitives of each voxel, one after the other
+
+    /**
+    * Function that computes the voxel containing a point, clamped to the grid
+    * @param point The point in global coordinates
+    * @return The integer coordinates of the voxel
+    */
+    [[nodiscard]] glm::ivec3 getVoxel(const glm::vec3 & point) const {
+        return glm::clamp(glm::ivec3((point - bounding_box.min_coordinates) * inverse_voxel_size), glm::ivec3(0),
+            voxels_amount - 1);
+    }
+
+    /**
+    * Function that computes the index of a voxel
+    * @param voxel The integer coordinates of the voxel
+    * @return The index of the voxel, with X varying the fastest
+    */
+    [[nodiscard]] int getVoxelIndex(const glm::ivec3 & voxel) const {
+        return (voxel.z * voxels_amount.y + voxel.y) * voxels_amount.x + voxel.x;
+    }
+
+protected:
+    void traverse(const Ray & ray, const traversal_mode mode, Interaction & closest_interaction,
+        float max_distance) const override {
+        // Case in which there is no grid to traverse
+        if(voxels_offsets.empty())
+            return;
+
+        // Initializing static variables
+        const glm::vec3 reciprocals(1 / ray.direction.x, 1 / ray.direction.y, 1 / ray.direction.z);
+        const int is_direction_negative[3] = {reciprocals.x < 0, reciprocals.y < 0, reciprocals.z < 0};
+
+        // Clipping the ray to the scene
+        float entry_distance, exit_distance;
+        if(!bounding_box.IntersectRange(ray, reciprocals, is_direction_negative, entry_distance, exit_distance)
+            || entry_distance > max_distance)
+            return;
+
+        // Finding the first voxel and the distance of the next voxel boundary along each axis
+        const glm::vec3 entry_point = ray.origin + entry_distance * ray.direction;
+        glm::ivec3 voxel = getVoxel(entry_point);
+        glm::vec3 next_crossing, crossing_delta;
+        glm::ivec3 step, out_of_grid;
+        for(int axis = 0; axis < 3; axis++) {
+            // Case in which the ray never leaves the voxels layer along this axis, the grid exit bounding it
+            if(ray.direction[axis] == 0 || voxels_amount[axis] == 1) {
+                next_crossing[axis] = INFINITY;
+                crossing_delta[axis] = INFINITY;
+                step[axis] = 0;
+                out_of_grid[axis] = -1;
+                continue;
+            }
+
+            const bool is_positive = ray.direction[axis] > 0;
+            const float boundary = bounding_box.min_coordinates[axis]
+                                   + static_cast<float>(voxel[axis] + is_positive) * voxel_size[axis];
+            next_crossing[axis] = entry_distance + (boundary - entry_point[axis]) * reciprocals[axis];
+            crossing_delta[axis] = voxel_size[axis] * abs(reciprocals[axis]);
+            step[axis] = is_positive ? 1 : -1;
+            out_of_grid[axis] = is_positive ? voxels_amount[axis] : -1;
+        }
+
+        // Walking through the voxels
+        while(true) {
+            // Intersecting the primitives of the voxel
+            const int voxel_index = getVoxelIndex(voxel);
+            if(intersectPrimitives(ray, voxels_primitives.data() + voxels_offsets[voxel_index],
+                voxels_offsets[voxel_index + 1] - voxels_offsets[voxel_index], mode, closest_interaction,
+                max_distance))
+                return;
+
+            // Finding the axis of the nearest voxel boundary
+            int axis = next_crossing.x < next_crossing.y ? 0 : 1;
+            if(next_crossing.z < next_crossing[axis])
+                axis = 2;
+
+            // Stopping once the closest hit precedes the next voxel or the ray leaves the grid
+            if(next_crossing[axis] > max_distance || next_crossing[axis] > exit_distance)
+                return;
+
+            // Stepping to the next voxel
+            voxel[axis] += step[axis];
+            if(voxel[axis] == out_of_grid[axis])
+                return;
+            next_crossing[axis] += crossing_delta[axis];
+        }
+    }
+
+public:
+    /**
+    * Constructor building the grid over the primitives of the scene
+    */
+    UniformGrid() {
+        // Verifying that there are primitives in the scene
+        if(primitives.empty()) {
+            PrintError("There are not primitives in the scene, cannot build the uniform grid");
+            return;
+        }
+
+        // Measuring the grid construction time
+        const ProfilerScope profiler_scope("build the uniform grid", "build", PRINT_SDS_BUILDING_TIME);
+
+        // Computing the bounding boxes of the primitives and of the scene
+        vector<BoundingBox3> primitives_boxes(primitives.size());
+        for(size_t i = 0; i < primitives.size(); i++) {
+            primitives_boxes[i] = primitives[i]->getWorldSpaceBoundingBox();
+            bounding_box = BoundingBox3::Union(bounding_box, primitives_boxes[i]);
+        }
+
+        // Computing the resolution, with cubic voxels as far as the maximum resolution allows
+        const glm::vec3 extent = bounding_box.max_coordinates - bounding_box.min_coordinates;
+        const float max_extent = max(extent.x, max(extent.y, extent.z));
+        const float voxels_per_unit = max_extent > 0 ?
+            GRID_DENSITY * cbrtf(static_cast<float>(primitives.size())) / max_extent : 0.0f;
+        for(int axis = 0; axis < 3; axis++) {
+            voxels_amount[axis] = glm::clamp(static_cast<int>(roundf(extent[axis] * voxels_per_unit)), 1,
+                GRID_MAX_RESOLUTION);
+            voxel_size[axis] = extent[axis] / static_cast<float>(voxels_amount[axis]);
+            inverse_voxel_size[axis] = voxel_size[axis] > 0 ? 1.0f / voxel_size[axis] : 0.0f;
+        }
+
+        // Function that computes the range of voxels overlapped by a primitive, widened against the rounding
+        const auto getVoxelsRange = [&](const BoundingBox3 & primitive_box) {
+            const glm::vec3 margin = GRID_VOXEL_MARGIN * voxel_size;
+            return pair(getVoxel(primitive_box.min_coordinates - margin),
+                getVoxel(primitive_box.max_coordinates + margin));
+        };
+
+        // Counting the primitives of each voxel
+        const int total_voxels = voxels_amount.x * voxels_amount.y * voxels_amount.z;
+        voxels_offsets.assign(total_voxels + 1, 0);
+        for(const auto & primitive_box : primitives_boxes) {
+            const auto [first_voxel, last_voxel] = getVoxelsRange(primitive_box);
+            for(int z = first_voxel.z; z <= last_voxel.z; z++)
+                for(int y = first_voxel.y; y <= last_voxel.y; y++)
+                    for(int x = first_voxel.x; x <= last_voxel.x; x++)
+                        voxels_offsets[getVoxelIndex({x, y, z}) + 1]++;
+        }
+
+        // Turning the counts into offsets
+        for(int i = 0; i < total_voxels; i++)
+            voxels_offsets[i + 1] += voxels_offsets[i];
+
+        // Filling the voxels
+        voxels_primitives.resize(voxels_offsets[total_voxels]);
+        vector<int> voxels_cursors(voxels_offsets.begin(), voxels_offsets.end() - 1);
+        for(size_t i = 0; i < primitives.size(); i++) {
+            const auto [first_voxel, last_voxel] = getVoxelsRange(primitives_boxes[i]);
+            for(int z = first_voxel.z; z <= last_voxel.z; z++)
+                for(int y = first_voxel.y; y <= last_voxel.y; y++)
+                    for(int x = first_voxel.x; x <= last_voxel.x; x++)
+                        voxels_primitives[voxels_cursors[getVoxelIndex({x, y, z})]++] = primitives[i];
+        }
+
+        if(PRINT_SDS_BUILDING_TIME)
+            PrintGenericMessage("The uniform grid has " + to_string(voxels_amount.x) + " x "
+                + to_string(voxels_amount.y) + " x " + to_string(voxels_amount.z) + " voxels referencing "
+                + to_string(voxels_primitives.size()) + " primitives");
+    }
+
+    /**
+    * Reset the grid at factory settings
+    */
+    void clear() override {
+        voxels_offsets.clear();
+        voxels_primitives.clear();
+        bounding_box = BoundingBox3();
+    }
+};
+
+#endif //UNIFORM_GRID_H
@@ -0,0 +1,567 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef SCENE_LOADER_H
+#define SCENE_LOADER_H
+
+/**
+* Loader of the scene description files. A scene file is a list of commands, one per line, "#" starts a comment and
+* paths containing blanks are written between double quotes:
+*
+*   setting <key> <value>                               Render option, same keys as the configuration file
+*   material <name> [parent]                            Starts a material, the property lines right after it apply
+*                                                       to it. The standard materials can be parents, not redefined
+*   <property> <value>                                  diffuse, specular, ambient, self_illuminance, transmission_filter,
+*                                                       reflection_filter (1 or 3 values), reflectivity, refractivity,
+*                                                       refraction_index, glossiness, transparency, roughness,
+*                                                       anisotropy, shininess, density, type (solid, volumetric),
+*                                                       brdf (phong, cook_torrance)
+*   translate <x> <y> <z>                               Composes the transform of the next entity, in order T * R * S
+*   rotate <degrees> <x> <y> <z>
+*   scale <x> [<y> <z>]
+*   texture <name> <path>                               Declares a texture asset
+*   mesh <name> <obj path> [albedo] [normal] [ao_r_m]   Declares a mesh asset, textures are names or "-"
+*   perlin_terrain <name> <width> <depth> <frequency> <amplitude> <time>
+*   perlin_sphere <name> <angular frequency> <frequency> <amplitude> <perturbance> <smooth shading>
+*   instance <mesh> <material>                          Places a mesh asset
+*   sphere | plane | chessboard_plane | disk <material> Places an analytic primitive
+*   perlin_heightfield <material> <width> <depth> <frequency> <amplitude> <time>
+*                                                       Places a Perlin terrain as a single heightfield primitive
+*   camera <name> <width> <height> <fov> [<focal distance> <aperture>]
+*   point_light <r> <g> <b>
+*   directional_light <r> <g> <b> <aperture>
+*   area_light <r> <g> <b> <radius> <aperture> <generate disk>
+*
+* Entities consume the transform composed before them, which is then reset to the identity. Assets are resolved once
+* and cached across frames, so that reloading the scene does not parse meshes and textures again, unless the geometry
+* of the meshes was released after the SDS paged their triangles out.
+*/
+class SceneLoader {
+    // Color properties of the materials, by name
+    static inline const map<string, glm::vec3 Material::*> color_properties {
+        {"self_illuminance", & Material::self_illuminance},
+        {"ambient", & Material::ambient},
+        {"diffuse", & Material::diffuse},
+        {"specular", & Material::specular},
+        {"transmission_filter", & Material::transmission_filter},
+        {"reflection_filter", & Material::reflection_filter}
+    };
+
+    // Scalar properties of the materials, by name
+    static inline const map<string, float Material::*> scalar_properties {
+        {"refractivity", & Material::refractivity},
+        {"refraction_index", & Material::refraction_index},
+        {"reflectivity", & Material::reflectivity},
+        {"glossiness", & Material::glossiness},
+        {"transparency", & Material::transparency},
+        {"roughness", & Material::roughness},
+        {"anisotropy", & Material::anisotropy},
+        {"shininess", & Material::shininess},
+        {"density", & Material::density}
+    };
+
+    map<string, Material *> materials; ///< Materials by name, pre-populated with the standard materials
+    map<string, Texture *> textures; ///< Textures by name
+    map<string, Mesh *> meshes; ///< Meshes by name
+    map<string, Texture *> textures_cache; ///< Textures by path, shared among names
+    map<string, Mesh *> meshes_cache; ///< Meshes by source description, shared among names
+
+    set<string> standard_materials; ///< Names of the standard materials, which the scene files cannot redefine
+
+    glm::mat4 transform = glm::mat4(1); ///< Transform of the next entity
+    Material * current_material = nullptr; ///< Material receiving the property lines
+
+    string path; ///< Path of the file being loaded
+    int line_number = 0; ///< Number of the line being loaded
+
+    /**
+    * Prints an error pointing to the current line
+    * @param message The error message
+    */
+    void printLineError(const string & message) const {
+        PrintError(path + ":" + to_string(line_number) + ": " + message);
+    }
+
+    /**
+    * Reads a vector made of either one value, replicated on the three components, or three values
+    * @param line_stream The stream of the current line
+    * @param result The parsed vector
+    * @return True if at least one value was read, false otherwise
+    */
+    static bool readVector(istringstream & line_stream, glm::vec3 & result) {
+        // Reading the first component
+        if(!(line_stream >> result.x))
+            return false;
+
+        // Reading the remaining components, replicating the first one if absent
+        if(!(line_stream >> result.y >> result.z))
+            result.y = result.z = result.x;
+
+        return true;
+    }
+
+    /**
+    * Finds a material by name
+    * @param name The name of the material
+    * @return A pointer to the material, or nullptr if it is not defined
+    */
+    Material * findMaterial(const string & name) const {
+        // Looking for the material
+        const auto entry = materials.find(name);
+        if(entry == materials.end()) {
+            printLineError("Unknown material " + name);
+            return nullptr;
+        }
+
+        return entry->second;
+    }
+
+    /**
+    * Finds a texture by name, "-" stands for no texture
+    * @param name The name of the texture
+    * @return A pointer to the texture, or nullptr if it is not defined
+    */
+    const Texture * findTexture(const string & name) const {
+        // Case in which no texture is used
+        if(name.empty() || name == "-")
+            return nullptr;
+
+        // Looking for the texture
+        const auto entry = textures.find(name);
+        if(entry == textures.end()) {
+            printLineError("Unknown texture " + name);
+            return nullptr;
+        }
+
+        return entry->second;
+    }
+
+    /**
+    * Binds a name to a mesh, creating the mesh only if no mesh with the same source was created before
+    * @param name The name of the mesh
+    * @param source Description of the source of the mesh, used as cache key
+    * @param create Function creating the mesh
+    */
+    void declareMesh(const string & name, const string & source, const function<Mesh * ()> & create) {
+        // Looking for a mesh with the same source
+        auto entry = meshes_cache.find(source);
+
+        // Creating the mesh again if its geometry was released, the triangles of the previous frame being gone
+        if(entry != meshes_cache.end() && entry->second->is_geometry_released) {
+            Mesh * released_mesh = entry->second;
+            entry->second = create();
+            for(auto & [mesh_name, mesh] : meshes)
+                if(mesh == released_mesh)
+                    mesh = entry->second;
+            delete released_mesh;
+        }
+
+        // Creating the mesh on first use
+        if(entry == meshes_cache.end())
+            entry = meshes_cache.emplace(source, create()).first;
+
+        meshes[name] = entry->second;
+    }
+
+    /**
+    * Consumes the transform composed so far
+    * @return The transform of the entity
+    */
+    glm::mat4 consumeTransform() {
+        const glm::mat4 result = transform;
+        transform = glm::mat4(1);
+        return result;
+    }
+
+    /**
+    * Checks weather a keyword is a property of the materials
+    * @param keyword The keyword
+    * @return True if the keyword names a material property
+    */
+    static bool isMaterialProperty(const string & keyword) {
+        return color_properties.contains(keyword) || scalar_properties.contains(keyword) || keyword == "type"
+            || keyword == "brdf";
+    }
+
+    /**
+    * Applies a property line to the current material
+    * @param property The name of the property
+    * @param line_stream The stream of the current line
+    * @return True if the property was recognized and its value valid, false otherwise
+    */
+    bool setMaterialProperty(const string & property, istringstream & line_stream) const {
+        // Applying a color property
+        if(const auto entry = color_properties.find(property); entry != color_properties.end())
+            return readVector(line_stream, current_material->*(entry->second));
+
+        // Applying a scalar property
+        if(const auto entry = scalar_properties.find(property); entry != scalar_properties.end())
+            return static_cast<bool>(line_stream >> current_material->*(entry->second));
+
+        // Reading the value of the enumerated properties
+        string value;
+        line_stream >> value;
+
+        // Applying the type
+        if(property == "type") {
+            if(value == "solid")
+                current_material->type = SOLID;
+            else if(value == "volumetric")
+                current_material->type = VOLUMETRIC;
+            else
+                return false;
+            return true;
+        }
+
+        // Applying the BRDF
+        if(property == "brdf") {
+            if(value == "phong")
+                current_material->BRDF = PHONG;
+            else if(value == "cook_torrance")
+                current_material->BRDF = COOK_TORRANCE;
+            else
+                return false;
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+    * Executes a single command
+    * @param keyword The command
+    * @param line_stream The stream of the current line, positioned after the command
+    * @param frame_number The current frame number
+    * @return True if the command was executed, false if it was malformed
+    */
+    bool executeCommand(const string & keyword, istringstream & line_stream, const int frame_number) {
+        // MATERIAL PROPERTIES, only valid right after the material they apply to
+        if(isMaterialProperty(keyword)) {
+            if(current_material == nullptr) {
+                printLineError("Property " + keyword + " outside of a material");
+                return false;
+            }
+            return setMaterialProperty(keyword, line_stream);
+        }
+
+        // Ending the definition of the current material on any other command
+        current_material = nullptr;
+
+        // RENDER OPTIONS
+        if(keyword == "setting") {
+            string key, value;
+            return line_stream >> key >> value && render_configuration.setOption(key, value);
+        }
+
+        // MATERIALS
+        if(keyword == "material") {
+            // Reading the name and the optional parent
+            string name, parent;
+            if(!(line_stream >> name))
+                return false;
+            line_stream >> parent;
+
+            // Preventing the scene from altering the materials shared with the compiled-in scenes
+            if(standard_materials.contains(name)) {
+                printLineError("Cannot redefine the standard material " + name);
+                return false;
+            }
+
+            // Creating the material on first definition, keeping its address stable across frames
+            Material * & material = materials[name];
+            if(material == nullptr)
+                material = new Material();
+
+            // Starting from the parent or from the default material
+            if(!parent.empty()) {
+                const Material * parent_material = findMaterial(parent);
+                if(parent_material == nullptr)
+                    return false;
+                * material = * parent_material;
+            }
+            else
+                * material = Material();
+
+            current_material = material;
+            return true;
+        }
+
+        // TRANSFORMS
+        if(keyword == "translate") {
+            glm::vec3 translation;
+            if(!(line_stream >> translation.x >> translation.y >> translation.z))
+                return false;
+            transform = glm::translate(transform, translation);
+            return true;
+        }
+        if(keyword == "rotate") {
+            float degrees;
+            glm::vec3 axis;
+            if(!(line_stream >> degrees >> axis.x >> axis.y >> axis.z) || glm::length(axis) == 0)
+                return false;
+            transform = glm::rotate(transform, glm::radians(degrees), glm::normalize(axis));
+            return true;
+        }
+        if(keyword == "scale") {
+            glm::vec3 scale;
+            if(!readVector(line_stream, scale))
+                return false;
+            transform = glm::scale(transform, scale);
+            return true;
+        }
+
+        // ASSETS
+        if(keyword == "texture") {
+            string name, texture_path;
+            if(!(line_stream >> name >> quoted(texture_path)))
+                return false;
+
+            // Loading the texture only once per path
+            auto entry = textures_cache.find(texture_path);
+            if(entry == textures_cache.end())
+                entry = textures_cache.emplace(texture_path, new Texture(texture_path.c_str())).first;
+
+            textures[name] = entry->second;
+            return true;
+        }
+        if(keyword == "mesh") {
+            string name, obj_path, albedo, normal, AO_R_M;
+            if(!(line_stream >> name >> quoted(obj_path)))
+                return false;
+            line_stream >> albedo >> normal >> AO_R_M;
+
+            // Resolving the textures
+            const Texture * albedo_texture = findTexture(albedo);
+            const Texture * normal_texture = findTexture(normal);
+            const Texture * AO_R_M_texture = findTexture(AO_R_M);
+
+            // Creating the mesh only once per combination of model and textures
+            const string source = "mesh " + obj_path + " " + albedo + " " + normal + " " + AO_R_M;
+            declareMesh(name, source, [&] {
+                return new Mesh(obj_path.c_str(), nullptr, albedo_texture, normal_texture, AO_R_M_texture);
+            });
+            return true;
+        }
+        if(keyword == "perlin_terrain") {
+            string name;
+            float width, depth, frequency, amplitude, time;
+            if(!(line_stream >> name >> width >> depth >> frequency >> amplitude >> time))
+                return false;
+
+            const string source = "perlin_terrain " + to_string(width) + " " + to_string(depth) + " "
+                + to_string(frequency) + " " + to_string(amplitude) + " " + to_string(time);
+            declareMesh(name, source, [&] {
+                return new PerlinTerrainMesh(width, depth, frequency, amplitude, time);
+            });
+            return true;
+        }
+        if(keyword == "perlin_sphere") {
+            string name;
+            float angular_frequency, frequency, amplitude, perturbance;
+            bool smooth_shading;
+            if(!(line_stream >> name >> angular_frequency >> frequency >> amplitude >> perturbance >> smooth_shading))
+                return false;
+
+            const string source = "perlin_sphere " + to_string(angular_frequency) + " " + to_string(frequency) + " "
+                + to_string(amplitude) + " " + to_string(perturbance) + " " + to_string(smooth_shading);
+            declareMesh(name, source, [&] {
+                return new PerlinSphereMesh(angular_frequency, frequency, amplitude, perturbance, smooth_shading);
+            });
+            return true;
+        }
+
+        // PRIMITIVES
+        if(keyword == "instance") {
+            string mesh_name, material_name;
+            if(!(line_stream >> mesh_name >> material_name))
+                return false;
+
+            // Looking for the mesh
+            const auto entry = meshes.find(mesh_name);
+            if(entry == meshes.end()) {
+                printLineError("Unknown mesh " + mesh_name);
+                return false;
+            }
+
+            // Looking for the material
+            const Material * material = findMaterial(material_name);
+            if(material == nullptr)
+                return false;
+
+            buildMaterialMesh(entry->second, consumeTransform(), * material);
+            return true;
+        }
+        if(keyword == "sphere" || keyword == "plane" || keyword == "chessboard_plane" || keyword == "disk") {
+            string material_name;
+            if(!(line_stream >> material_name))
+                return false;
+
+            // Looking for the material
+            const Material * material = findMaterial(material_name);
+            if(material == nullptr)
+                return false;
+
+            // Creating the primitive
+            const glm::mat4 primitive_transform = consumeTransform();
+            if(keyword == "sphere")
+                primitives.push_back(new Sphere(primitive_transform, material));
+            else if(keyword == "disk")
+                primitives.push_back(new Disk(primitive_transform, material));
+            else if(keyword == "plane")
+                planes.push_back(new Plane(primitive_transform, material));
+            else
+                planes.push_back(new ChessboardPlane(primitive_transform, material));
+            return true;
+        }
+        if(keyword == "perlin_heightfield") {
+            string material_name;
+            float width, depth, frequency, amplitude, time;
+            if(!(line_stream >> material_name >> width >> depth >> frequency >> amplitude >> time))
+                return false;
+
+            // Looking for the material
+            const Material * material = findMaterial(material_name);
+            if(material == nullptr)
+                return false;
+
+            buildPerlinHeightfield(consumeTransform(), * material, width, depth, frequency, amplitude, time);
+            return true;
+        }
+
+        // CAMERAS
+        if(keyword == "camera") {
+            string name;
+            glm::vec2 resolution;
+            float fov;
+            float focal_distance = 11;
+            float aperture = 0.25;
+            if(!(line_stream >> name >> resolution.x >> resolution.y >> fov))
+                return false;
+            line_stream >> focal_distance >> aperture;
+
+            cameras.push_back(new Camera(consumeTransform(), name + " - Frame " + to_string(frame_number),
+                resolution, fov, focal_distance, aperture));
+            return true;
+        }
+
+        // LIGHTS
+        if(keyword == "point_light") {
+            glm::vec3 intensity;
+            if(!(line_stream >> intensity.x >> intensity.y >> intensity.z))
+                return false;
+
+            lights.push_back(new PointLight(consumeTransform(), intensity,
+                intensity / max(max(intensity.x, intensity.y), max(intensity.z, 1e-6f))));
+            return true;
+        }
+        if(keyword == "directional_light") {
+            glm::vec3 intensity;
+            float aperture;
+            if(!(line_stream >> intensity.x >> intensity.y >> intensity.z >> aperture))
+                return false;
+
+            directional_lights.push_back(new DirectionalLight(consumeTransform(), intensity, aperture));
+            return true;
+        }
+        if(keyword == "area_light") {
+            glm::vec3 intensity;
+            float radius, aperture;
+            bool generate_disk;
+            if(!(line_stream >> intensity.x >> intensity.y >> intensity.z >> radius >> aperture >> generate_disk))
+                return false;
+
+            // The area light registers its samples and its disk in the scene
+            AreaLight(consumeTransform(), intensity,
+                intensity / max(max(intensity.x, intensity.y), max(intensity.z, 1e-6f)), radius, aperture, generate_disk);
+            return true;
+        }
+
+        printLineError("Unknown command " + keyword);
+        return false;
+    }
+
+public:
+    /**
+    * Initializes the loader, exposing the standard materials to the scene files
+    */
+    SceneLoader() {
+        materials = {
+            {"red", & red_material},
+            {"blue", & blue_material},
+            {"green", & green_material},
+            {"yellow", & yellow_material},
+            {"grey", & grey_material},
+            {"copper", & copper_material},
+            {"brass", & brass_material},
+            {"smooth_reflective", & smooth_reflective_material},
+            {"rough_reflective", & rough_reflective_material},
+            {"black_reflective", & black_reflective_material},
+            {"air", & air_material},
+            {"water", & water_material},
+            {"glass", & glass_material}
+        };
+        for(const auto & [name, material] : materials)
+            standard_materials.insert(name);
+    }
+
+    /**
+    * Releases the geometry of the cached meshes, once the SDS copied their triangles out of them. The meshes are parsed
+    * again when declared by the next load
+    */
+    void releaseMeshesGeometry() {
+        for(const auto & [source, mesh] : meshes_cache)
+            mesh->releaseGeometry();
+    }
+
+    /**
+    * Loads a scene file, adding its entities to the scene. Malformed lines are reported and skipped
+    * @param scene_path The path of the scene file
+    * @param frame_number The current frame number, appended to the cameras names
+    * @return True if the file was read, false otherwise
+    */
+    bool load(const string & scene_path, const int frame_number) {
+        // Measuring the loading time
+        const ProfilerScope profiler_scope("load the scene " + scene_path, "io", PRINT_OBJ_PARSING_TIME);
+
+        // Opening the file
+        ifstream file(scene_path);
+
+        // Verifying that the file opened correctly
+        if(!file.is_open()) {
+            PrintError("Error while opening scene file " + scene_path);
+            return false;
+        }
+
+        // Resetting the state of the previous load
+        path = scene_path;
+        line_number = 0;
+        transform = glm::mat4(1);
+        current_material = nullptr;
+
+        // Reading the file line by line
+        string line;
+        while(getline(file, line)) {
+            line_number++;
+
+            // Removing the comments
+            line = line.substr(0, line.find('#'));
+
+            // Extracting the command
+            istringstream line_stream(line);
+            string keyword;
+            if(!(line_stream >> keyword))
+                continue;
+
+            // Executing the command
+            if(!executeCommand(keyword, line_stream, frame_number))
+                printLineError("Invalid command: " + line);
+        }
+
+        return true;
+    }
+};
+
+inline SceneLoader scene_loader; ///< The loader of the scene files, keeping its assets across frames
+
+#endif //SCENE_LOADER_H
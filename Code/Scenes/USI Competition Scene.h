@@ -399,10 +399,10 @@ inline void defineUSICompetitionScene(const int frame_number) {
 
     // CEILING
     if(frame_number > 168)
-        buildMaterialMesh(new PerlinTerrainMesh(
+        buildPerlinHeightfield(perlin_ceiling, smooth_reflective_material,
             min(70.0f, (static_cast<float>(frame_number) - 168.0f) / 24.0f * 70),
             min(70.0f, (static_cast<float>(frame_number) - 168.0f) / 24.0f * 70),
-            0.25, 0.5, frame_number * 0.1), perlin_ceiling, smooth_reflective_material);
+            0.25, 0.5, frame_number * 0.1);
 
     // CHESSBOARD PLANE
     planes.push_back(new ChessboardPlane(chessboard_plane_transform, & grey_material));
@@ -460,48 +460,52 @@ inline void defineUSICompetitionScene(const int frame_number) {
     //LIGHTS
     // Spawns at 1.5 secs
     if(frame_number >= spawn_frame[0]) {
-        // LEFT LIGHTS
-        buildLightMesh(
-            new PerlinSphereMesh(angular_frequency, noise_frequency, noise_amplitude, noise_perturbance[0], false),
+        // Generating the sphere once, shared by the left and right light
+        const auto first_light_mesh =
+            new PerlinSphereMesh(angular_frequency, noise_frequency, noise_amplitude, noise_perturbance[0], false);
+        buildLightMesh(first_light_mesh,
             left_first_light_transform, lights_buildup[0] * 200.0f * vaporwave_palette_1, vaporwave_palette_1, emission_probability);
-        buildLightMesh(
-            new PerlinSphereMesh(angular_frequency, noise_frequency, noise_amplitude, noise_perturbance[0],false),
+        buildLightMesh(first_light_mesh,
             right_first_light_transform, lights_buildup[0] * 200.0f * vaporwave_palette_1, vaporwave_palette_1, emission_probability);
     }
     // Spawns at 2 seconds
     if(frame_number >= spawn_frame[1]) {
-        buildLightMesh(
-            new PerlinSphereMesh(angular_frequency, noise_frequency, noise_amplitude, noise_perturbance[1],false),
+        // Generating the sphere once, shared by the left and right light
+        const auto second_light_mesh =
+            new PerlinSphereMesh(angular_frequency, noise_frequency, noise_amplitude, noise_perturbance[1], false);
+        buildLightMesh(second_light_mesh,
             left_second_light_transform, lights_buildup[1] * 200.0f * vaporwave_palette_2, vaporwave_palette_2, emission_probability);
-        buildLightMesh(
-            new PerlinSphereMesh(angular_frequency, noise_frequency, noise_amplitude, noise_perturbance[1],false),
+        buildLightMesh(second_light_mesh,
             right_second_light_transform, lights_buildup[1] * 200.0f * vaporwave_palette_2, vaporwave_palette_2, emission_probability);
     }
     // Spawns at 2.5 seconds
     if(frame_number >= spawn_frame[2]) {
-        buildLightMesh(
-            new PerlinSphereMesh(angular_frequency, noise_frequency, noise_amplitude, noise_perturbance[2], false),
+        // Generating the sphere once, shared by the left and right light
+        const auto third_light_mesh =
+            new PerlinSphereMesh(angular_frequency, noise_frequency, noise_amplitude, noise_perturbance[2], false);
+        buildLightMesh(third_light_mesh,
             left_third_light_transform, lights_buildup[2] * 200.0f * vaporwave_palette_3, vaporwave_palette_3, emission_probability);
-        buildLightMesh(
-            new PerlinSphereMesh(angular_frequency, noise_frequency, noise_amplitude, noise_perturbance[2], false),
+        buildLightMesh(third_light_mesh,
             right_third_light_transform, lights_buildup[2] * 200.0f * vaporwave_palette_3, vaporwave_palette_3, emission_probability);
     }
     // Spawns at 3 seconds
     if(frame_number >= spawn_frame[3]) {
-        buildLightMesh(
-            new PerlinSphereMesh(angular_frequency, noise_frequency, noise_amplitude, noise_perturbance[3],false),
+        // Generating the sphere once, shared by the left and right light
+        const auto fourth_light_mesh =
+            new PerlinSphereMesh(angular_frequency, noise_frequency, noise_amplitude, noise_perturbance[3], false);
+        buildLightMesh(fourth_light_mesh,
             left_fourth_light_transform, lights_buildup[3] * 200.0f * vaporwave_palette_4, vaporwave_palette_4, emission_probability);
-        buildLightMesh(
-            new PerlinSphereMesh(angular_frequency, noise_frequency, noise_amplitude, noise_perturbance[3],false),
+        buildLightMesh(fourth_light_mesh,
             right_fourth_light_transform, lights_buildup[3] * 200.0f * vaporwave_palette_4, vaporwave_palette_4, emission_probability);
     }
     // Spawns at 3.5 seconds
     if(frame_number >= spawn_frame[4]) {
-        buildLightMesh(
-            new PerlinSphereMesh(angular_frequency, noise_frequency, noise_amplitude, noise_perturbance[4],false),
+        // Generating the sphere once, shared by the left and right light
+        const auto fifth_light_mesh =
+            new PerlinSphereMesh(angular_frequency, noise_frequency, noise_amplitude, noise_perturbance[4], false);
+        buildLightMesh(fifth_light_mesh,
             left_fifth_light_transform, lights_buildup[4] * 200.0f * vaporwave_palette_5, vaporwave_palette_5, emission_probability);
-        buildLightMesh(
-            new PerlinSphereMesh(angular_frequency, noise_frequency, noise_amplitude, noise_perturbance[4],false),
+        buildLightMesh(fifth_light_mesh,
             right_fifth_light_transform, lights_buildup[4] * 200.0f * vaporwave_palette_5, vaporwave_palette_5, emission_probability);
 
     }
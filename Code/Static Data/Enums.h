@@ -28,9 +28,25 @@ enum split_method {
     // Middle of the primitives centroids mean
     MIDDLE,
     // Equal counts of primitives
-    EQUAL_COUNTS
+    EQUAL_COUNTS,
+    // Surface Area Heuristic also considering spatial splits, which duplicate the primitives straddling the split
+    SBVH,
+    // Linear BVH over the Morton codes of the primitives centroids, its top levels refined with the SAH
+    LBVH
   };
 
+// Layouts of the linear BVH nodes, in pairs of siblings
+enum bvh_node_layout {
+    // Pairs in depth first order
+    DEPTH_FIRST_LAYOUT,
+    // Pairs in van Emde Boas order, recursively splitting the subtrees at half their height
+    VAN_EMDE_BOAS_LAYOUT,
+    // Pairs in page sized clusters, each one filled breadth first
+    PAGE_CLUSTERS_LAYOUT,
+    // The layout traversing a set of incoherent rays the fastest, measured on each scene
+    MEASURED_LAYOUT
+};
+
 // Material type
 enum material_type {
     VOLUMETRIC,
@@ -43,6 +59,28 @@ enum photon_type {
     CAUSTIC
 };
 
+// Messages exchanged between the coordinator and the workers of a distributed render, and with a render server
+enum tile_message : uint32_t {
+    // Command line options of the coordinator, sent to each worker once connected
+    CONFIGURATION_MESSAGE,
+    // Tile to render, along with the frame and the camera it belongs to
+    TILE_REQUEST_MESSAGE,
+    // HDR pixels of a rendered tile
+    TILE_RESULT_MESSAGE,
+    // Request to terminate the worker, or the render server
+    SHUTDOWN_MESSAGE,
+    // Render job submitted to a render server
+    RENDER_JOB_MESSAGE,
+    // HDR pixels of a tile of a render job, streamed as soon as the tile is rendered
+    JOB_TILE_MESSAGE,
+    // Completion of a render job, carrying the error if the job failed
+    JOB_DONE_MESSAGE,
+    // Secret shared with the coordinator, sent by each worker once connected
+    AUTHENTICATION_MESSAGE,
+    // Frame whose scene a worker prepared, its tile requests being timed from then on
+    WORKER_READY_MESSAGE
+};
+
 // Spatial Data Structure (SDS)
 enum SDS {
     // Do not use SDS (computationally expensive)
@@ -51,8 +89,12 @@ enum SDS {
     BASIC_BOXING,
     // Use a BVH SDS with SAH
     BVH_SDS,
-    // Use a K-D Tree SAS with mean centre of mass heuristic
-    KD_TREE_SDS
+    // Use a K-D Tree SDS with SAH
+    KD_TREE_SDS,
+    // Use a uniform grid SDS traversed with a 3D-DDA
+    GRID_SDS,
+    // Use a BVH over spatial bricks, each with its own BVH, paged in on demand from a memory-mapped file
+    BRICKED_SDS
 };
 
 // TMOs
@@ -64,4 +106,64 @@ enum TMO {
     LINEAR
 };
 
+// Baking of the procedural materials
+enum procedural_bake {
+    // Shade the procedural materials with their uniform diffuse
+    NO_BAKE,
+    // Bake the bricks around the primitives of each procedural material before rendering, the others when touched
+    EAGER_BAKE,
+    // Bake the bricks of the volume the first time they are touched
+    LAZY_BAKE
+};
+
+// Render kernel features (bit flags), used to specialize the render kernels at compile time
+enum render_feature : unsigned int {
+    // Supersampling of each pixel
+    ANTIALIASING_FEATURE = 1u << 0,
+    // Lens sampling through the camera aperture
+    DEPTH_OF_FIELD_FEATURE = 1u << 1,
+    // Schlick approximation of the Fresnel effect on refractive surfaces
+    FRESNEL_FEATURE = 1u << 2,
+    // Photon mapping indirect lighting
+    INDIRECT_LIGHTING_FEATURE = 1u << 3,
+    // Photon mapping caustics
+    CAUSTIC_FEATURE = 1u << 4
+};
+
+// Render statistics counters
+enum statistic_counter {
+    // Rays generated by the cameras
+    CAMERA_RAYS,
+    // Rays spawned by reflective surfaces
+    REFLECTED_RAYS,
+    // Rays spawned by refractive surfaces
+    REFRACTED_RAYS,
+    // Rays spawned through volumetric materials
+    VOLUMETRIC_RAYS,
+    // Occlusion rays cast toward the lights
+    SHADOW_RAYS,
+    // Occlusion rays that hit an occluder
+    OCCLUDED_SHADOW_RAYS,
+    // Rays traced by the photons
+    PHOTON_RAYS,
+    // BVH nodes whose bounding box was tested
+    BVH_NODES_VISITED,
+    // BVH leaves whose primitives were tested
+    BVH_LEAVES_TESTED,
+    // Bytes of BVH nodes read to test their bounding boxes
+    BVH_NODE_BYTES_READ,
+    // Bricks paged in from the bricks file
+    BRICK_PAGE_INS,
+    // Ray-triangle intersection tests
+    TRIANGLE_TESTS,
+    // Ray-triangle intersection tests that found a hit
+    TRIANGLE_HITS,
+    // Nearest neighbors queries on the photons KD trees
+    KNN_QUERIES,
+    // Photons visited by the nearest neighbors queries
+    KNN_PHOTONS_TOUCHED,
+    // Amount of counters
+    STATISTIC_COUNTERS_AMOUNT
+};
+
 #endif //ENUMS_H
@@ -11,7 +11,8 @@ class DirectionalLight;
 class Primitive;
 class Camera;
 class Plane;
-class BVH;
+class AccelerationStructure;
+class Material;
 
 // Structs
 struct Ray;
@@ -20,6 +21,7 @@ struct KDTreeNode;
 
 // Functions
 glm::vec3 BlinnPhong(const Interaction & interaction, const Ray & ray);
+template <unsigned int FEATURES>
 glm::vec3 CookTorrance(const Interaction & interaction, const Ray & camera_ray);
 
 #endif //FORWARD_DECLARATION_H
@@ -8,6 +8,8 @@
 // RAY TRACING
 constexpr int MAX_RAY_TRACING_RECURSION_LEVEL = 5;
 constexpr int FRAMES_GENERATED = 1;
+constexpr int RENDER_TILE_SIZE = 32;
+constexpr uint64_t RENDER_SAMPLES_SEED = 0x5EED;
 
 constexpr bool USE_ANTIALIASING = false;
 constexpr float ANTIALIASING_SUBDIVISIONS_AMOUNT = 2;
@@ -18,12 +20,41 @@ constexpr bool PRINT_RAYTRACING_EXECUTION_PERCENTAGE = false;
 constexpr bool PRINT_MAXIMUM_RECURSION_LEVEL_REACHED = false;
 constexpr bool PRINT_RAYTRACING_EXECUTION_TIME = true;
 
+// STATISTICS
+constexpr bool USE_RENDER_STATISTICS = false;
+
+// CHECKPOINTS
+constexpr int CHECKPOINT_INTERVAL_SECONDS = 300;
+
+// DISTRIBUTED RENDERING
+constexpr int DISTRIBUTED_WORKERS_AMOUNT = 0;
+constexpr int DISTRIBUTED_COORDINATOR_PORT = 0;
+constexpr int DISTRIBUTED_TILE_SIZE = 128;
+constexpr int DISTRIBUTED_TILES_IN_FLIGHT = 2;
+constexpr int DISTRIBUTED_TILE_TIMEOUT_SECONDS = 120;
+constexpr int DISTRIBUTED_PREPARATION_TIMEOUT_SECONDS = 3600;
+constexpr int DISTRIBUTED_AUTHENTICATION_TIMEOUT_SECONDS = 2;
+constexpr int DISTRIBUTED_IDLE_TIMEOUT_SECONDS = 60;
+constexpr auto DISTRIBUTED_TOKEN_VARIABLE = "RAYTRACER_DISTRIBUTED_TOKEN";
+constexpr int DISTRIBUTED_MAX_TILE_RETRIES = 3;
+constexpr int DISTRIBUTED_WORKER_RESPAWNS = 4;
+constexpr int DISTRIBUTED_CONNECTION_ATTEMPTS = 100;
+
 // POST PROCESSING
 constexpr bool USE_GAMMA_CORRECTION = true;
 constexpr float GAMMA_CORRECTION_FACTOR = 1.0F / 2.2f;
 constexpr bool USE_TONE_MAPPING = true;
-constexpr auto TONE_MAPPING_OPERATOR = EXTENDED_REINHARD;
+constexpr auto TONE_MAPPING_OPERATOR = LINEAR;
 constexpr bool PRINT_POST_PROCESSING_EXECUTION_TIME = true;
+constexpr int OUTPUT_FRAMEBUFFERS_AMOUNT = 3;
+
+// DENOISER
+constexpr bool USE_DENOISER = false;
+constexpr int DENOISER_ITERATIONS = 4;
+constexpr float DENOISER_COLOR_SIGMA = 0.75f;
+constexpr float DENOISER_NORMAL_EXPONENT = 128.0f;
+constexpr float DENOISER_DEPTH_SIGMA = 1.0f;
+constexpr float DENOISER_ALBEDO_SIGMA = 0.1f;
 
 // LIGHT
 constexpr bool USE_OCCLUSION = true;
@@ -41,18 +72,60 @@ constexpr int MAX_PHOTON_TRACING_RECURSION_LEVEL = 3;
 constexpr bool USE_DEPTH_OF_FIELD = false;
 constexpr int DEPTH_OF_FIELD_SAMPLES_AMOUNT = 15;
 
+// TEXTURES
+constexpr bool USE_TEXTURE_FILTERING = true;
+constexpr int TEXTURE_MAX_ANISOTROPY = 8;
+constexpr int TEXTURE_TILE_SIZE = 64;
+constexpr int TEXTURE_CACHE_SIZE_MB = 256;
+
 // MATERIALS
 constexpr int ROUGH_SURFACES_SAMPLE_SIZE = 25;
+constexpr auto PROCEDURAL_BAKE = NO_BAKE;
+constexpr int PROCEDURAL_BAKE_RESOLUTION = 256;
+constexpr int PROCEDURAL_BAKE_BRICK_SIZE = 8;
 
 // SPECULAR MODELS
 constexpr auto COOK_TORRANCE_ISOTROPIC_DISTRIBUTION = GGX;
 
 // SDS
 constexpr bool PRINT_SDS_BUILDING_TIME = true;
+constexpr auto SDS_TYPE = BVH_SDS;
 
 // BVH
 constexpr auto SPLIT_METHOD = SAH;
+constexpr int BVH_MAX_DEPTH = 64;
 constexpr int SAH_BUCKETS_AMOUNT = 12;
+constexpr int SBVH_SPATIAL_BINS_AMOUNT = 16;
+constexpr float SBVH_OVERLAP_THRESHOLD = 1e-5f;
+constexpr float SBVH_DUPLICATION_BUDGET = 0.5f;
+constexpr int LBVH_TREELET_BITS = 12;
+constexpr int LBVH_RADIX_SORT_BITS = 6;
+constexpr int LBVH_MAX_LEAF_PRIMITIVES = 4;
+constexpr bool USE_TREELET_OPTIMIZATION = false;
+constexpr int TREELET_LEAVES_AMOUNT = 7;
+constexpr int TREELET_OPTIMIZATION_PASSES = 3;
+constexpr int TREELET_PARALLEL_DEPTH = 8;
+constexpr auto BVH_NODE_LAYOUT = DEPTH_FIRST_LAYOUT;
+constexpr size_t BVH_LAYOUT_PAGE_SIZE = 4096;
+constexpr int BVH_LAYOUT_MEASURED_RAYS = 1 << 16;
+constexpr bool USE_QUANTIZED_BVH = false;
+
+// KD TREE
+constexpr float KD_TREE_INTERSECTION_COST = 80.0f;
+constexpr float KD_TREE_TRAVERSAL_COST = 1.0f;
+constexpr float KD_TREE_EMPTY_BONUS = 0.5f;
+constexpr int KD_TREE_MAX_LEAF_PRIMITIVES = 1;
+constexpr int KD_TREE_MAX_DEPTH = -1;
+
+// GRID
+constexpr float GRID_DENSITY = 3.0f;
+constexpr int GRID_MAX_RESOLUTION = 128;
+constexpr float GRID_VOXEL_MARGIN = 1e-4f;
+
+// BRICKS
+constexpr int BRICK_MAX_PRIMITIVES = 1 << 16;
+constexpr int BRICK_LEAF_PRIMITIVES = 4;
+constexpr int BRICKS_CACHE_SIZE_MB = 1024;
 
 // MESH
 constexpr bool PRINT_OBJ_PARSING_TIME = true;
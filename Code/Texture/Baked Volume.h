@@ -0,0 +1,192 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef BAKED_VOLUME_H
+#define BAKED_VOLUME_H
+
+/**
+* A cubic block of samples of a baked volume, stored in row major order (X fastest)
+*/
+struct VolumeBrick {
+    array<glm::vec3, PROCEDURAL_BAKE_BRICK_SIZE * PROCEDURAL_BAKE_BRICK_SIZE * PROCEDURAL_BAKE_BRICK_SIZE>
+        samples; ///< Samples of the brick
+};
+
+/**
+* 3D texture caching a procedural function over an axis aligned box. The function is sampled on a regular grid split
+* in bricks, either all baked upfront or each baked the first time a lookup touches it, and lookups are filtered
+* trilinearly. Points outside the box fall back to the procedural function
+*/
+class BakedVolume {
+    function<glm::vec3 (const glm::vec3 &)> evaluate; ///< The baked procedural function
+
+    glm::vec3 min_coordinates; ///< Position of the first sample
+    float sample_spacing; ///< Distance between adjacent samples
+    glm::ivec3 samples_amount; ///< Amount of samples along each axis
+    glm::ivec3 bricks_amount; ///< Amount of bricks along each axis
+
+    unique_ptr<atomic<VolumeBrick *>[]> bricks; ///< The bricks, null until baked
+
+    /**
+    * Bakes a brick, sampling the procedural function at each of its samples
+    * @param brick_index The index of the brick
+    */
+    [[nodiscard]] VolumeBrick * bakeBrick(const int brick_index) const {
+        constexpr int size = PROCEDURAL_BAKE_BRICK_SIZE;
+
+        // Computing the first sample of the brick
+        const glm::ivec3 first_sample = size * glm::ivec3(brick_index % bricks_amount.x,
+            brick_index / bricks_amount.x % bricks_amount.y, brick_index / (bricks_amount.x * bricks_amount.y));
+
+        // Sampling the function, the samples past the grid end being clamped to it
+        const auto brick = new VolumeBrick();
+        for(int z = 0; z < size; z++)
+            for(int y = 0; y < size; y++)
+                for(int x = 0; x < size; x++) {
+                    const glm::ivec3 sample = glm::min(first_sample + glm::ivec3(x, y, z), samples_amount - 1);
+                    brick->samples[(z * size + y) * size + x] = evaluate(min_coordinates +
+                        sample_spacing * glm::vec3(sample));
+                }
+
+        return brick;
+    }
+
+    /**
+    * Returns a sample of the grid, baking its brick if needed
+    * @param sample The integer coordinates of the sample
+    */
+    [[nodiscard]] glm::vec3 getSample(const glm::ivec3 & sample) const {
+        constexpr int size = PROCEDURAL_BAKE_BRICK_SIZE;
+
+        // Finding the brick of the sample
+        const glm::ivec3 brick_coordinates = sample / size;
+        const int brick_index = (brick_coordinates.z * bricks_amount.y + brick_coordinates.y) * bricks_amount.x
+                              + brick_coordinates.x;
+        VolumeBrick * brick = bricks[brick_index].load(memory_order_acquire);
+
+        // Case in which the brick was never touched, the threads racing on it keeping the first baked copy
+        if(brick == nullptr) {
+            VolumeBrick * baked_brick = bakeBrick(brick_index);
+            if(bricks[brick_index].compare_exchange_strong(brick, baked_brick, memory_order_acq_rel))
+                brick = baked_brick;
+            else
+                delete baked_brick;
+        }
+
+        const glm::ivec3 local = sample - brick_coordinates * size;
+        return brick->samples[(local.z * size + local.y) * size + local.x];
+    }
+
+public:
+    /**
+    * @param min_coordinates The min coordinates of the baked box
+    * @param max_coordinates The max coordinates of the baked box
+    * @param resolution Amount of samples along the longest axis of the box
+    * @param evaluate The procedural function
+    */
+    BakedVolume(const glm::vec3 & min_coordinates, const glm::vec3 & max_coordinates, const int resolution,
+        function<glm::vec3 (const glm::vec3 &)> evaluate)
+    : evaluate(std::move(evaluate)), min_coordinates(min_coordinates) {
+        // Computing the grid, with the same spacing along each axis
+        const glm::vec3 extent = max_coordinates - min_coordinates;
+        sample_spacing = max(glm::max(extent.x, glm::max(extent.y, extent.z)), 1e-6f)
+                       / static_cast<float>(max(resolution, 2) - 1);
+        samples_amount = glm::ivec3(glm::ceil(extent / sample_spacing)) + 1;
+        bricks_amount = (samples_amount + PROCEDURAL_BAKE_BRICK_SIZE - 1) / PROCEDURAL_BAKE_BRICK_SIZE;
+
+        // Initializing the bricks as not baked
+        const int total_bricks = bricks_amount.x * bricks_amount.y * bricks_amount.z;
+        bricks = make_unique<atomic<VolumeBrick *>[]>(total_bricks);
+        for(int i = 0; i < total_bricks; i++)
+            bricks[i].store(nullptr, memory_order_relaxed);
+    }
+
+    BakedVolume(const BakedVolume &) = delete;
+    BakedVolume & operator=(const BakedVolume &) = delete;
+
+    ~BakedVolume() {
+        for(int i = 0; i < bricks_amount.x * bricks_amount.y * bricks_amount.z; i++)
+            delete bricks[i].load(memory_order_relaxed);
+    }
+
+    /**
+    * Bakes upfront, in parallel, the bricks overlapping the given boxes. The other bricks are left to be baked the
+    * first time a lookup touches them, so that the empty space around the surfaces costs no memory
+    * @param boxes The min and max coordinates of the boxes, usually the bounds of the surfaces using the material
+    */
+    void bakeAround(const vector<pair<glm::vec3, glm::vec3>> & boxes) {
+        const int total_bricks = bricks_amount.x * bricks_amount.y * bricks_amount.z;
+
+        // Marking the bricks holding the samples interpolated within the boxes
+        vector<uint8_t> marked_bricks(total_bricks, 0);
+        for(const auto & [box_min, box_max] : boxes) {
+            const glm::ivec3 first_brick = glm::clamp(glm::ivec3(glm::floor((box_min - min_coordinates)
+                / sample_spacing)), glm::ivec3(0), samples_amount - 1) / PROCEDURAL_BAKE_BRICK_SIZE;
+            const glm::ivec3 last_brick = glm::clamp(glm::ivec3(glm::ceil((box_max - min_coordinates)
+                / sample_spacing)), glm::ivec3(0), samples_amount - 1) / PROCEDURAL_BAKE_BRICK_SIZE;
+            for(int z = first_brick.z; z <= last_brick.z; z++)
+                for(int y = first_brick.y; y <= last_brick.y; y++)
+                    for(int x = first_brick.x; x <= last_brick.x; x++)
+                        marked_bricks[(z * bricks_amount.y + y) * bricks_amount.x + x] = 1;
+        }
+
+        // Baking the marked bricks
+        #pragma omp parallel for schedule(dynamic)
+        for(int i = 0; i < total_bricks; i++)
+            if(marked_bricks[i] && bricks[i].load(memory_order_relaxed) == nullptr)
+                bricks[i].store(bakeBrick(i), memory_order_release);
+    }
+
+    /**
+    * Returns the value at the given point, trilinearly filtered from the baked samples
+    * @param point The point in global coordinates
+    */
+    [[nodiscard]] glm::vec3 lookup(const glm::vec3 & point) const {
+        // Computing the continuous coordinates of the point in the grid
+        const glm::vec3 grid_point = (point - min_coordinates) / sample_spacing;
+
+        // Case in which the point is outside the baked box
+        if(glm::any(glm::lessThan(grid_point, glm::vec3(0.0f))) ||
+            glm::any(glm::greaterThan(grid_point, glm::vec3(samples_amount - 1))))
+            return evaluate(point);
+
+        // Finding the cell and the interpolation weights, flat boxes having a single sample along some axis
+        const glm::ivec3 first_sample = glm::clamp(glm::ivec3(grid_point), glm::ivec3(0),
+            glm::max(samples_amount - 2, 0));
+        const glm::vec3 weights = grid_point - glm::vec3(first_sample);
+        const glm::ivec3 last_sample = glm::min(first_sample + 1, samples_amount - 1);
+
+        // Interpolating the eight corners of the cell
+        const glm::vec3 bottom = glm::mix(
+            glm::mix(getSample(first_sample),
+                     getSample({last_sample.x, first_sample.y, first_sample.z}), weights.x),
+            glm::mix(getSample({first_sample.x, last_sample.y, first_sample.z}),
+                     getSample({last_sample.x, last_sample.y, first_sample.z}), weights.x),
+            weights.y);
+        const glm::vec3 top = glm::mix(
+            glm::mix(getSample({first_sample.x, first_sample.y, last_sample.z}),
+                     getSample({last_sample.x, first_sample.y, last_sample.z}), weights.x),
+            glm::mix(getSample({first_sample.x, last_sample.y, last_sample.z}),
+                     getSample(last_sample), weights.x),
+            weights.y);
+
+        return glm::mix(bottom, top, weights.z);
+    }
+};
+
+inline vector<pair<const Material *, unique_ptr<BakedVolume>>> baked_volumes; ///< The baked volumes by material
+
+/**
+* Finds the baked volume of a material
+* @param material The material
+* @return The baked volume of the material, null if the material is not baked
+*/
+inline const BakedVolume * findBakedVolume(const Material * material) {
+    for(const auto & [baked_material, volume] : baked_volumes)
+        if(baked_material == material)
+            return volume.get();
+    return nullptr;
+}
+
+#endif //BAKED_VOLUME_H
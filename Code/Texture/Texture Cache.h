@@ -0,0 +1,167 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+/**
+* A square block of texels of a mip level, stored as floating point RGB values in row major order
+*/
+struct TextureTile {
+    array<glm::vec3, TEXTURE_TILE_SIZE * TEXTURE_TILE_SIZE> texels; ///< Texels of the tile
+};
+
+/**
+* Cache of the texture tiles, shared by all the textures and threads. Tiles are loaded on demand and, once the
+* capacity is reached, the least recently used ones are evicted. A tile requested by several threads at once is
+* loaded a single time, the other threads waiting for it to be ready. Each thread additionally keeps its last tiles in
+* a small private table, which may hold tiles already evicted: the slots of those tables are taken from the budget
+*/
+class TextureCache {
+protected:
+    static TextureCache * singleton_instance;
+
+    /**
+    * An entry of the cache
+    */
+    struct Entry {
+        shared_future<shared_ptr<const TextureTile>> tile; ///< The tile, ready once its loading completed
+        list<uint64_t>::iterator position; ///< Position of the tile in the usage list
+    };
+
+    mutex cache_mutex; ///< Mutex protecting entries and usage list
+    unordered_map<uint64_t, Entry> entries; ///< The cached tiles by key
+    list<uint64_t> usage; ///< Keys of the cached tiles, from the most to the least recently used
+
+    size_t capacity; ///< Maximum amount of tiles kept in memory by the cache itself
+    size_t recent_tiles_amount; ///< Amount of tiles kept in the private table of each thread
+    atomic<uint32_t> textures_amount = 0; ///< Amount of registered textures, used to assign their identifiers
+
+    atomic<uint64_t> hits_amount = 0; ///< Amount of requests served from memory
+    atomic<uint64_t> misses_amount = 0; ///< Amount of requests that loaded the tile
+
+    TextureCache() {
+        singleton_instance = this;
+
+        // Computing the amount of tiles fitting the budget
+        const size_t budget = max(static_cast<size_t>(TEXTURE_CACHE_SIZE_MB) * 1024 * 1024 / sizeof(TextureTile),
+            static_cast<size_t>(1));
+
+        // Reserving the private tables of the threads at most half of the budget, the rest going to the cache
+        const auto threads_amount = static_cast<size_t>(max(omp_get_max_threads(), 1));
+        recent_tiles_amount = min(bit_floor(budget / 2 / threads_amount), MAX_RECENT_TILES_AMOUNT);
+        capacity = max(budget - threads_amount * recent_tiles_amount, static_cast<size_t>(1));
+    }
+
+    /**
+    * Evicts the least recently used tiles until the capacity is respected. Tiles still loading are skipped, evicted
+    * tiles stay alive as long as some thread holds them. Must be called while holding the cache mutex
+    */
+    void evict() {
+        auto current = usage.end();
+        while(entries.size() > capacity && current != usage.begin()) {
+            --current;
+
+            // Skipping the tiles still loading
+            const auto entry = entries.find(* current);
+            if(entry->second.tile.wait_for(chrono::seconds(0)) != future_status::ready)
+                continue;
+
+            // Removing the tile
+            entries.erase(entry);
+            current = usage.erase(current);
+        }
+    }
+
+public:
+    // Maximum amount of tiles kept in the private table of each thread
+    static constexpr size_t MAX_RECENT_TILES_AMOUNT = 16;
+
+    static TextureCache * getInstance();
+
+    /**
+    * Returns the amount of tiles each thread can keep in its private table, a power of two
+    * @return The amount of tiles, 0 if the budget is too small for private tables
+    */
+    [[nodiscard]] size_t getRecentTilesAmount() const {
+        return recent_tiles_amount;
+    }
+
+    /**
+    * Assigns an identifier to a new texture
+    * @return The identifier, used to build the keys of its tiles
+    */
+    uint32_t registerTexture() {
+        return textures_amount++;
+    }
+
+    /**
+    * Builds the key of a tile
+    * @param texture_id The identifier of the texture
+    * @param level The mip level of the tile
+    * @param tile_index The index of the tile within the level
+    */
+    static uint64_t getKey(const uint32_t texture_id, const uint32_t level, const uint32_t tile_index) {
+        return static_cast<uint64_t>(texture_id) << 40 | static_cast<uint64_t>(level) << 32 | tile_index;
+    }
+
+    /**
+    * Returns a tile, loading it if it is not cached
+    * @param key The key of the tile
+    * @param load Function loading the tile, called outside the lock
+    */
+    shared_ptr<const TextureTile> getTile(const uint64_t key, const function<shared_ptr<const TextureTile> ()> & load) {
+        promise<shared_ptr<const TextureTile>> loading;
+        shared_future<shared_ptr<const TextureTile>> cached_tile;
+        {
+            lock_guard lock(cache_mutex);
+
+            // Case in which the tile is cached or being loaded
+            if(const auto entry = entries.find(key); entry != entries.end()) {
+                usage.splice(usage.begin(), usage, entry->second.position);
+                cached_tile = entry->second.tile;
+                hits_amount++;
+            }
+            // Case in which the tile is missing, registering it as loading so that concurrent requests wait for it
+            else {
+                usage.push_front(key);
+                entries.emplace(key, Entry { .tile = loading.get_future().share(), .position = usage.begin() });
+                misses_amount++;
+                evict();
+            }
+        }
+
+        // Waiting outside the lock in case the tile is still loading
+        if(cached_tile.valid())
+            return cached_tile.get();
+
+        // Loading the tile
+        const shared_ptr<const TextureTile> tile = load();
+        loading.set_value(tile);
+        return tile;
+    }
+
+    /**
+    * Prints the usage of the cache
+    */
+    void printStatistics() {
+        lock_guard lock(cache_mutex);
+        cout << "Texture cache: " << entries.size() << " / " << capacity << " tiles, " << recent_tiles_amount
+             << " private tiles per thread, "
+             << hits_amount << " hits, " << misses_amount << " misses" << endl;
+    }
+};
+
+TextureCache * TextureCache::singleton_instance = nullptr;
+
+/**
+* Return the singleton instance of the texture cache
+*/
+inline TextureCache * TextureCache::getInstance() {
+    if(singleton_instance == nullptr)
+        singleton_instance = new TextureCache();
+    return singleton_instance;
+}
+
+#endif //TEXTURE_CACHE_H
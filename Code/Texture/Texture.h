@@ -7,42 +7,404 @@
 
 class Texture {
 
+    /**
+    * A level of the mip pyramid, storing the texels as floating point RGB values in row major order. Only used
+    * while converting the source image to the tiled format
+    */
+    struct MipLevel {
+        int width = 0; ///< Width of the level
+        int height = 0; ///< Height of the level
+        vector<glm::vec3> texels {}; ///< Texels of the level, already mapped to range [0, 1]
+    };
+
+    /**
+    * Layout of a mip level within the tiled file
+    */
+    struct LevelLayout {
+        int width = 0; ///< Width of the level
+        int height = 0; ///< Height of the level
+        int tiles_per_row = 0; ///< Amount of tiles covering a row of the level
+        streamoff offset = 0; ///< Offset of the first tile of the level in the tiled file
+    };
+
+    /**
+    * Header of the tiled file, identifying the source image it was converted from
+    */
+    struct TiledFileHeader {
+        uint32_t magic = 0; ///< Identifier of the format, TILED_FILE_MAGIC
+        uint32_t version = 0; ///< Version of the format, combined with the tile size
+        uint32_t width = 0; ///< Width of the full resolution level
+        uint32_t height = 0; ///< Height of the full resolution level
+        uint32_t levels_amount = 0; ///< Amount of levels of the mip pyramid
+        uint32_t padding = 0; ///< Unused, keeps the layout explicit
+        uint64_t source_size = 0; ///< Size in bytes of the source image
+        int64_t source_modification_time = 0; ///< Time of the last modification of the source image
+    };
+
+    // Identifier of the tiled file format, followed by its version
+    static constexpr uint32_t TILED_FILE_MAGIC = 0x58545452;
+    static constexpr uint32_t TILED_FILE_VERSION = 2;
+
+    // Size in bytes of a tile in the tiled file, stored as 8 bit RGB
+    static constexpr streamoff TILE_FILE_SIZE = TEXTURE_TILE_SIZE * TEXTURE_TILE_SIZE * 3;
+
     string path; ///< Path in file system of the texture
+    string tiled_path; ///< Path in file system of the tiled version of the texture
 
     int width = 0; ///< Width of the texture
     int height = 0; ///< Height of the texture
     int channels = 0; ///< Amount of channels of the texture
 
-    unsigned char * data; ///< Texture data
+    uint32_t texture_id; ///< Identifier of the texture in the texture cache
+    vector<LevelLayout> levels; ///< Layout of the levels of the mip pyramid, level 0 being the full resolution texture
+
+    mutable ifstream tiled_file; ///< The tiled file, from which the tiles are loaded on demand
+    mutable mutex file_mutex; ///< Mutex protecting the reads from the tiled file
 
-public:
     /**
-    * Read and initializes the texture using the provided file system path
+    * Builds the mip pyramid by repeatedly averaging blocks of 2x2 texels, down to a single texel
+    * @param pyramid The pyramid, containing the full resolution level
     */
-    explicit Texture(const char * path) : path(path) {
+    static void buildMipPyramid(vector<MipLevel> & pyramid) {
+        while(pyramid.back().width > 1 || pyramid.back().height > 1) {
+            // Extracting the finest level built so far
+            const MipLevel & source = pyramid.back();
+
+            // Initializing the next level, halving the dimensions
+            MipLevel level;
+            level.width = max(source.width / 2, 1);
+            level.height = max(source.height / 2, 1);
+            level.texels.resize(static_cast<size_t>(level.width) * level.height);
+
+            // Averaging the source texels, clamping the indexes of odd sized levels
+            for(int h = 0; h < level.height; h++) {
+                const int first_row = min(2 * h, source.height - 1) * source.width;
+                const int second_row = min(2 * h + 1, source.height - 1) * source.width;
+
+                for(int w = 0; w < level.width; w++) {
+                    const int first_column = min(2 * w, source.width - 1);
+                    const int second_column = min(2 * w + 1, source.width - 1);
+
+                    level.texels[h * level.width + w] = 0.25f * (
+                        source.texels[first_row + first_column] + source.texels[first_row + second_column] +
+                        source.texels[second_row + first_column] + source.texels[second_row + second_column]);
+                }
+            }
+
+            pyramid.push_back(std::move(level));
+        }
+    }
+
+    /**
+    * Computes the layout of the levels in the tiled file, given the dimensions of the full resolution level
+    * @param levels_amount The amount of levels
+    */
+    void computeLayout(const int levels_amount) {
+        // Offset of the first tile, following the header
+        streamoff offset = sizeof(TiledFileHeader);
+
+        levels.clear();
+        int level_width = width;
+        int level_height = height;
+        for(int i = 0; i < levels_amount; i++) {
+            // Computing the amount of tiles covering the level
+            const int tiles_per_row = (level_width + TEXTURE_TILE_SIZE - 1) / TEXTURE_TILE_SIZE;
+            const int tiles_per_column = (level_height + TEXTURE_TILE_SIZE - 1) / TEXTURE_TILE_SIZE;
+
+            levels.push_back(LevelLayout { level_width, level_height, tiles_per_row, offset });
+
+            // Moving to the next level
+            offset += static_cast<streamoff>(tiles_per_row) * tiles_per_column * TILE_FILE_SIZE;
+            level_width = max(level_width / 2, 1);
+            level_height = max(level_height / 2, 1);
+        }
+    }
+
+    /**
+    * Describes the source image, so that a tiled file converted from an older version of it is not reused
+    * @param header The header receiving the size and the modification time of the source image
+    */
+    void describeSource(TiledFileHeader & header) const {
+        error_code error;
+        const uintmax_t source_size = filesystem::file_size(path, error);
+        header.source_size = error ? 0 : static_cast<uint64_t>(source_size);
+        const auto modification_time = filesystem::last_write_time(path, error);
+        header.source_modification_time = error ? 0 : static_cast<int64_t>(
+            chrono::duration_cast<chrono::nanoseconds>(modification_time.time_since_epoch()).count());
+    }
+
+    /**
+    * Opens an existing tiled file, verifying that it matches the source image and the current tile size and
+    * filtering settings
+    * @return True if the file can be used, false otherwise
+    */
+    bool openTiledFile() {
+        // Opening the file
+        tiled_file.open(tiled_path, ios::binary);
+        if(!tiled_file.is_open())
+            return false;
+
+        // Reading the header
+        TiledFileHeader header;
+        tiled_file.read(reinterpret_cast<char *>(& header), sizeof(TiledFileHeader));
+
+        // Describing the current source image
+        TiledFileHeader source;
+        describeSource(source);
+
+        // Verifying the header
+        const uint32_t expected_levels = USE_TEXTURE_FILTERING ?
+            static_cast<uint32_t>(floor(log2(max(header.width, header.height)))) + 1 : 1;
+        if(!tiled_file || header.magic != TILED_FILE_MAGIC
+           || header.version != (TILED_FILE_VERSION | TEXTURE_TILE_SIZE << 8) || header.width == 0
+           || header.height == 0 || header.levels_amount != expected_levels || header.source_size != source.source_size
+           || header.source_modification_time != source.source_modification_time) {
+            tiled_file.close();
+            return false;
+        }
+
+        // Computing the layout
+        width = static_cast<int>(header.width);
+        height = static_cast<int>(header.height);
+        computeLayout(static_cast<int>(header.levels_amount));
+        return true;
+    }
+
+    /**
+    * Converts the source image to the tiled format, optionally mipmapped, and writes it to the tiled path. The file is
+    * written under a temporary name and renamed once complete, so that an interrupted conversion is never reused
+    * @return True if the tiled file was written, false otherwise
+    */
+    bool writeTiledFile() {
         // Flipping the image
         stbi_set_flip_vertically_on_load(true);
 
         // Read the data using the library stb_image
-        data = stbi_load(path, & width, & height, & channels, 0);
+        unsigned char * data = stbi_load(path.c_str(), & width, & height, & channels, 0);
 
         // Verifying the image was correctly parsed
         if(!data) {
             cerr << "Error reading texture " << path << endl;
-            return;
+            return false;
         }
 
         // Printing some stats
         cout << "Texture: " << path << " loaded" << endl;
         cout << "Size : " << width << " x " << height << ", Channels: " << channels << endl;
+
+        // Converting the data from range [0, 255] to [0, 1], replicating the channels of grayscale textures
+        vector<MipLevel> pyramid(1, MipLevel { .width = width, .height = height });
+        pyramid[0].texels.resize(static_cast<size_t>(width) * height);
+        for(size_t i = 0; i < pyramid[0].texels.size(); i++) {
+            const unsigned char * texel = data + i * channels;
+            pyramid[0].texels[i] = channels >= 3 ?
+                glm::vec3(texel[0], texel[1], texel[2]) / 255.0f : glm::vec3(texel[0]) / 255.0f;
+        }
+
+        // Releasing the 8 bit data
+        stbi_image_free(data);
+
+        // Precomputing the filtered levels
+        if(USE_TEXTURE_FILTERING)
+            buildMipPyramid(pyramid);
+        computeLayout(static_cast<int>(pyramid.size()));
+
+        // Opening the temporary file, named after the process so that concurrent conversions do not collide
+        const string temporary_path = tiled_path + "." + to_string(getpid()) + ".tmp";
+        ofstream file(temporary_path, ios::binary | ios::trunc);
+        if(!file.is_open())
+            return false;
+
+        // Writing the header
+        TiledFileHeader header {
+            .magic = TILED_FILE_MAGIC,
+            .version = TILED_FILE_VERSION | TEXTURE_TILE_SIZE << 8,
+            .width = static_cast<uint32_t>(width),
+            .height = static_cast<uint32_t>(height),
+            .levels_amount = static_cast<uint32_t>(pyramid.size())
+        };
+        describeSource(header);
+        file.write(reinterpret_cast<const char *>(& header), sizeof(TiledFileHeader));
+
+        // Writing the tiles of each level in row major order, replicating the border texels in the padding
+        vector<unsigned char> tile_data(TILE_FILE_SIZE);
+        for(const auto & level : pyramid) {
+            for(int tile_y = 0; tile_y * TEXTURE_TILE_SIZE < level.height; tile_y++) {
+                for(int tile_x = 0; tile_x * TEXTURE_TILE_SIZE < level.width; tile_x++) {
+                    for(int y = 0; y < TEXTURE_TILE_SIZE; y++) {
+                        const int row = min(tile_y * TEXTURE_TILE_SIZE + y, level.height - 1);
+                        for(int x = 0; x < TEXTURE_TILE_SIZE; x++) {
+                            const int column = min(tile_x * TEXTURE_TILE_SIZE + x, level.width - 1);
+                            const glm::vec3 & texel = level.texels[row * level.width + column];
+                            for(int c = 0; c < 3; c++)
+                                tile_data[(y * TEXTURE_TILE_SIZE + x) * 3 + c] =
+                                    static_cast<unsigned char>(glm::clamp(texel[c], 0.0f, 1.0f) * 255.0f + 0.5f);
+                        }
+                    }
+                    file.write(reinterpret_cast<const char *>(tile_data.data()), TILE_FILE_SIZE);
+                }
+            }
+        }
+
+        // Replacing the previous tiled file, removing the partial file in case of failure
+        file.close();
+        error_code error;
+        if(!file.fail())
+            filesystem::rename(temporary_path, tiled_path, error);
+        if(file.fail() || error) {
+            filesystem::remove(temporary_path, error);
+            return false;
+        }
+
+        return true;
     }
 
     /**
-    * Returns the RGB values of the pixel at given UV coordinates
+    * Loads a tile from the tiled file
+    * @param level The mip level of the tile
+    * @param tile_index The index of the tile within the level
+    */
+    [[nodiscard]] shared_ptr<const TextureTile> loadTile(const int level, const int tile_index) const {
+        // Reading the 8 bit data
+        vector<unsigned char> tile_data(TILE_FILE_SIZE);
+        {
+            lock_guard lock(file_mutex);
+            tiled_file.seekg(levels[level].offset + tile_index * TILE_FILE_SIZE);
+            tiled_file.read(reinterpret_cast<char *>(tile_data.data()), TILE_FILE_SIZE);
+        }
+
+        // Converting the data from range [0, 255] to [0, 1]
+        const auto tile = make_shared<TextureTile>();
+        for(int i = 0; i < TEXTURE_TILE_SIZE * TEXTURE_TILE_SIZE; i++)
+            tile->texels[i] = glm::vec3(tile_data[3 * i], tile_data[3 * i + 1], tile_data[3 * i + 2]) / 255.0f;
+
+        return tile;
+    }
+
+    /**
+    * Returns a texel of a mip level, going through the texture cache. The last tiles used by the current thread are
+    * kept in a small private table, so that neighbouring lookups do not contend for the cache
+    * @param level The mip level
+    * @param x The column of the texel, within the level
+    * @param y The row of the texel, within the level
+    */
+    [[nodiscard]] glm::vec3 getTexel(const int level, const int x, const int y) const {
+        // Private table of the tiles recently used by the thread, indexed by a hash of the key
+        thread_local array<pair<uint64_t, shared_ptr<const TextureTile>>, TextureCache::MAX_RECENT_TILES_AMOUNT>
+            recent_tiles;
+
+        // Computing the key of the tile
+        const int tile_index = (y / TEXTURE_TILE_SIZE) * levels[level].tiles_per_row + x / TEXTURE_TILE_SIZE;
+        const uint64_t key = TextureCache::getKey(texture_id, level, tile_index);
+        const int texel_index = (y % TEXTURE_TILE_SIZE) * TEXTURE_TILE_SIZE + x % TEXTURE_TILE_SIZE;
+
+        // Case in which the budget leaves no room for the private table
+        TextureCache * texture_cache = TextureCache::getInstance();
+        const size_t recent_tiles_amount = texture_cache->getRecentTilesAmount();
+        if(recent_tiles_amount == 0)
+            return texture_cache->getTile(key, [&] { return loadTile(level, tile_index); })->texels[texel_index];
+
+        // Requesting the tile to the cache if it is not recently used, using only the slots fitting the budget
+        auto & [recent_key, recent_tile] = recent_tiles[(key ^ key >> 29) & (recent_tiles_amount - 1)];
+        if(recent_tile == nullptr || recent_key != key) {
+            recent_key = key;
+            recent_tile = texture_cache->getTile(key, [&] { return loadTile(level, tile_index); });
+        }
+
+        return recent_tile->texels[texel_index];
+    }
+
+    /**
+    * Returns the bilinearly filtered value of a mip level at given UV coordinates
+    * @param level The mip level
+    * @param UV 2 sized vector containing UV coordinates
+    */
+    [[nodiscard]] glm::vec3 getBilinear(const int level, const glm::vec2 & UV) const {
+        // Extracting the dimensions of the level
+        const int level_width = levels[level].width;
+        const int level_height = levels[level].height;
+
+        // Parsing the value of the UV coordinates [0, 1] to continuous texel coordinates
+        const float x = UV.x * static_cast<float>(level_width) - 0.5f;
+        const float y = UV.y * static_cast<float>(level_height) - 0.5f;
+
+        // Extracting the four surrounding texels, clamped to avoid out-of-bounds access
+        const float floor_x = floor(x);
+        const float floor_y = floor(y);
+        const int first_column = min(max(static_cast<int>(floor_x), 0), level_width - 1);
+        const int second_column = min(max(static_cast<int>(floor_x) + 1, 0), level_width - 1);
+        const int first_row = min(max(static_cast<int>(floor_y), 0), level_height - 1);
+        const int second_row = min(max(static_cast<int>(floor_y) + 1, 0), level_height - 1);
+
+        // Interpolating the texels
+        const float weight_x = x - floor_x;
+        const float weight_y = y - floor_y;
+        return glm::mix(
+            glm::mix(getTexel(level, first_column, first_row), getTexel(level, second_column, first_row), weight_x),
+            glm::mix(getTexel(level, first_column, second_row), getTexel(level, second_column, second_row), weight_x),
+            weight_y);
+    }
+
+    /**
+    * Returns the trilinearly filtered value of the texture at given UV coordinates
+    * @param UV 2 sized vector containing UV coordinates
+    * @param level_of_detail Continuous index of the mip level
+    */
+    [[nodiscard]] glm::vec3 getTrilinear(const glm::vec2 & UV, float level_of_detail) const {
+        // Clamping the level of detail within the pyramid
+        level_of_detail = glm::clamp(level_of_detail, 0.0f, static_cast<float>(levels.size() - 1));
+
+        // Case in which the level falls exactly on the coarsest level
+        const int finer_level = static_cast<int>(level_of_detail);
+        if(finer_level == static_cast<int>(levels.size()) - 1)
+            return getBilinear(finer_level, UV);
+
+        // Interpolating between the two closest levels
+        return glm::mix(getBilinear(finer_level, UV), getBilinear(finer_level + 1, UV),
+            level_of_detail - static_cast<float>(finer_level));
+    }
+
+public:
+    /**
+    * Initializes the texture using the provided file system path. The image is converted once to a tiled file,
+    * stored next to it, whose tiles are then loaded on demand through the texture cache
+    */
+    explicit Texture(const char * path) : path(path), tiled_path(string(path) + ".tiles"),
+        texture_id(TextureCache::getInstance()->registerTexture()) {
+        // Reusing the tiled file of previous runs
+        if(openTiledFile())
+            return;
+
+        // Converting the image, falling back to the temporary directory if the texture directory is read-only
+        if(!writeTiledFile()) {
+            tiled_path = (filesystem::temp_directory_path() /
+                (to_string(hash<string>()(this->path)) + ".tiles")).string();
+
+            // Case in which the texture can not be read or converted
+            if(levels.empty() || !writeTiledFile()) {
+                PrintError("Error converting texture " + this->path);
+                levels.clear();
+                return;
+            }
+        }
+
+        // Opening the converted file
+        if(!openTiledFile()) {
+            PrintError("Error opening tiled texture " + tiled_path);
+            levels.clear();
+        }
+    }
+
+    /**
+    * Returns the RGB values of the pixel at given UV coordinates, without filtering
     * @param UV 2 sized vector containing UV coordinates
     * @returns A vector containing the RGB value of the pixel
     */
     [[nodiscard]] glm::vec3 getPixel(const glm::vec2 & UV) const {
+        // Case in which the texture could not be loaded
+        if(levels.empty())
+            return glm::vec3(0.0f);
+
         // Parsing the value of the UV coordinates [0, 1] to pixel coordinates
         int w = floor(UV.x * width);
         int h = floor(UV.y * height);
@@ -51,15 +413,58 @@ public:
         w = min(max(w, 0), width - 1);
         h = min(max(h, 0), height - 1);
 
-        // Computing the current index
-        const int current_index = (h * width + w) * channels;
+        return getTexel(0, w, h);
+    }
 
-        // Extracting data from the texture after mapping from range [0, 255] to [0, 1]
-        return {
-            static_cast<float>(data[current_index + 0]) / 255.0f,
-            static_cast<float>(data[current_index + 1]) / 255.0f,
-            static_cast<float>(data[current_index + 2]) / 255.0f
-        };
+    /**
+    * Returns the RGB values of the texture filtered over the footprint of a ray. The footprint is the parallelogram
+    * spanned by the UV differentials: the mip level is selected by its minor axis, and up to TEXTURE_MAX_ANISOTROPY
+    * trilinear probes are averaged along its major axis
+    * @param UV 2 sized vector containing UV coordinates
+    * @param UV_dx Change of the UV coordinates between horizontally adjacent pixels
+    * @param UV_dy Change of the UV coordinates between vertically adjacent pixels
+    * @returns A vector containing the filtered RGB value
+    */
+    [[nodiscard]] glm::vec3 getFilteredPixel(const glm::vec2 & UV, const glm::vec2 & UV_dx,
+        const glm::vec2 & UV_dy) const {
+        // Case in which filtering is disabled or the texture could not be loaded
+        if(!USE_TEXTURE_FILTERING || levels.empty())
+            return getPixel(UV);
+
+        // Measuring the footprint axes in texels
+        const glm::vec2 size (width, height);
+        const float length_dx = glm::length(UV_dx * size);
+        const float length_dy = glm::length(UV_dy * size);
+
+        // Sorting the axes of the footprint
+        const bool is_dx_major = length_dx >= length_dy;
+        const float major_length = is_dx_major ? length_dx : length_dy;
+        const float minor_length = is_dx_major ? length_dy : length_dx;
+        const glm::vec2 major_axis = is_dx_major ? UV_dx : UV_dy;
+
+        // Case in which the footprint is unknown, magnifying the finest level
+        if(major_length <= 0.0f)
+            return getBilinear(0, UV);
+
+        // Computing the amount of probes needed to cover the major axis
+        const int probes_amount = static_cast<int>(min(ceil(major_length / max(minor_length, 1e-6f)),
+            static_cast<float>(TEXTURE_MAX_ANISOTROPY)));
+
+        // Selecting the level in which each probe covers about one texel
+        const float level_of_detail = log2(major_length / static_cast<float>(probes_amount));
+
+        // Case in which the footprint is isotropic
+        if(probes_amount == 1)
+            return getTrilinear(UV, level_of_detail);
+
+        // Averaging the probes distributed along the major axis
+        glm::vec3 filtered_value (0.0f);
+        for(int i = 0; i < probes_amount; i++) {
+            const float offset = (static_cast<float>(i) + 0.5f) / static_cast<float>(probes_amount) - 0.5f;
+            filtered_value += getTrilinear(UV + offset * major_axis, level_of_detail);
+        }
+
+        return filtered_value / static_cast<float>(probes_amount);
     }
 };
 
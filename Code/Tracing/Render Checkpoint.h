@@ -0,0 +1,275 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef RENDER_CHECKPOINT_H
+#define RENDER_CHECKPOINT_H
+
+/**
+* Header of a checkpoint file. It is followed by the bitmap of the completed tiles, then by the RGB values of the
+* pixels of each completed tile in tile order, row major within the tile, each tile being followed by the PixelFeatures
+* of its pixels if the denoiser is enabled. The file is written in the native byte order
+*/
+struct CheckpointHeader {
+    char magic[8]; ///< Identifier of the format, CHECKPOINT_MAGIC
+    int32_t width; ///< Width of the image
+    int32_t height; ///< Height of the image
+    int32_t tile_size; ///< Side of the tiles the image is split in
+    int32_t tiles_amount; ///< Amount of tiles of the image
+    uint32_t render_features; ///< The render_feature flags of the kernel rendering the image
+    uint32_t samples_per_pixel; ///< Samples accumulated by every pixel of a completed tile
+    uint64_t samples_seed; ///< Seed of the per pixel sample streams
+    uint64_t render_hash; ///< Hash of the scene file and of the options changing the samples of the pixels
+    uint32_t has_features; ///< 1 if the features guiding the denoiser follow the pixels of each tile, 0 otherwise
+};
+
+// Identifier of the checkpoint format, changed whenever the layout of the file changes
+constexpr char CHECKPOINT_MAGIC[8] = {'R', 'T', 'C', 'K', 'P', 'T', '0', '3'};
+
+/**
+* Checkpoint of the rendering of an image. The tiles are the unit of progress: a tile is either completed, its pixels
+* having accumulated all their samples, or it is rendered again from scratch. Since every pixel draws its samples from
+* its own stream, a resumed render produces the same image as an uninterrupted one. The checkpoint identifies the scene
+* by the path, size and modification time of its file, so that a render of a different or edited scene starts over
+*/
+class RenderCheckpoint {
+    string path; ///< Path of the checkpoint file
+    Image * image; ///< The image being rendered
+    vector<RenderTile> tiles; ///< The tiles the image is split in
+    CheckpointHeader header {}; ///< Header describing the render, compared with the one of a resumed file
+    vector<uint8_t> completed_tiles; ///< Bitmap of the completed tiles
+    chrono::seconds interval; ///< Time between two checkpoints
+    chrono::steady_clock::time_point last_save; ///< Time of the last checkpoint
+    mutex checkpoint_mutex; ///< Mutex serializing the completions and the writes
+
+    /**
+    * Computes the hash identifying the scene and the options changing the samples of the pixels
+    * @param configuration The configuration of the render
+    * @return The FNV-1a hash of the path, size and modification time of the scene file, and of the options
+    */
+    static uint64_t computeRenderHash(const RenderConfiguration & configuration) {
+        // Describing the scene file, the compiled-in scene having neither size nor modification time
+        error_code size_error, time_error;
+        const uintmax_t scene_size = filesystem::file_size(configuration.scene_path, size_error);
+        const auto modification_time = filesystem::last_write_time(configuration.scene_path, time_error);
+        const int64_t scene_description[] = {
+            size_error ? 0 : static_cast<int64_t>(scene_size),
+            time_error ? 0 : static_cast<int64_t>(
+                chrono::duration_cast<chrono::nanoseconds>(modification_time.time_since_epoch()).count()),
+            configuration.antialiasing_subdivisions,
+            configuration.depth_of_field_samples,
+            configuration.procedural_bake_mode,
+            configuration.procedural_bake_resolution
+        };
+
+        // Hashing the path of the scene, followed by its description
+        uint64_t hash = 0xCBF29CE484222325ull;
+        const auto hash_bytes = [&hash](const char * bytes, const size_t size) {
+            for(size_t i = 0; i < size; i++) {
+                hash ^= static_cast<uint8_t>(bytes[i]);
+                hash *= 0x100000001B3ull;
+            }
+        };
+        hash_bytes(configuration.scene_path.data(), configuration.scene_path.size());
+        hash_bytes(reinterpret_cast<const char *>(scene_description), sizeof(scene_description));
+
+        return hash;
+    }
+
+    /**
+    * Function that writes the checkpoint, replacing the previous one only once the new one is complete
+    */
+    void save() {
+        // Gathering the pixels of the completed tiles, followed by their features
+        vector<float> pixels;
+        for(size_t t = 0; t < tiles.size(); t++) {
+            if(!isTileCompleted(static_cast<int>(t)))
+                continue;
+            for(int y = tiles[t].y_start; y < tiles[t].y_end; y++) {
+                for(int x = tiles[t].x_start; x < tiles[t].x_end; x++) {
+                    const glm::vec3 color = image->getHDRPixel(x, y);
+                    pixels.insert(pixels.end(), { color.r, color.g, color.b });
+                }
+            }
+            if(header.has_features) {
+                for(int y = tiles[t].y_start; y < tiles[t].y_end; y++) {
+                    for(int x = tiles[t].x_start; x < tiles[t].x_end; x++) {
+                        const PixelFeatures & features = image->getPixelFeatures(x, y);
+                        pixels.insert(pixels.end(), { features.albedo.r, features.albedo.g, features.albedo.b,
+                            features.normal.x, features.normal.y, features.normal.z, features.depth });
+                    }
+                }
+            }
+        }
+
+        // Writing a temporary file, so that a crash while writing keeps the previous checkpoint
+        const string temporary_path = path + ".tmp";
+        {
+            ofstream file(temporary_path, ios::binary | ios::trunc);
+            file.write(reinterpret_cast<const char *>(& header), sizeof(CheckpointHeader));
+            file.write(reinterpret_cast<const char *>(completed_tiles.data()),
+                static_cast<streamsize>(completed_tiles.size()));
+            file.write(reinterpret_cast<const char *>(pixels.data()),
+                static_cast<streamsize>(pixels.size() * sizeof(float)));
+            if(!file) {
+                PrintError("Cannot write the checkpoint " + temporary_path);
+                return;
+            }
+        }
+
+        // Replacing the previous checkpoint
+        error_code error;
+        filesystem::rename(temporary_path, path, error);
+        if(error)
+            PrintError("Cannot replace the checkpoint " + path);
+        last_save = chrono::steady_clock::now();
+    }
+
+public:
+    /**
+    * Constructor of the checkpoint of an image
+    * @param configuration The configuration of the render, selecting the directory and the interval of the checkpoints
+    * @param image The image being rendered, whose name names the checkpoint file
+    * @param image_tiles The tiles the image is split in
+    * @param samples_seed The seed of the samples of the image
+    */
+    RenderCheckpoint(const RenderConfiguration & configuration, Image * image, const vector<RenderTile> & image_tiles,
+        const uint64_t samples_seed)
+        : path((filesystem::path(configuration.checkpoint_directory) / (image->getName() + ".checkpoint")).string()),
+          image(image), tiles(image_tiles), completed_tiles((image_tiles.size() + 7) / 8, 0),
+          interval(configuration.checkpoint_interval), last_save(chrono::steady_clock::now()) {
+        // Describing the render, clearing the padding since headers are compared bytewise
+        memset(& header, 0, sizeof(CheckpointHeader));
+        memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+        header.width = image->getWidth();
+        header.height = image->getHeight();
+        header.tile_size = tiles.empty() ? 0 : tiles.front().x_end - tiles.front().x_start;
+        header.tiles_amount = static_cast<int32_t>(tiles.size());
+        header.render_features = configuration.getRenderFeatures();
+        header.samples_per_pixel = 1;
+        if(configuration.use_antialiasing)
+            header.samples_per_pixel *= configuration.antialiasing_subdivisions
+                * configuration.antialiasing_subdivisions;
+        if(configuration.use_depth_of_field)
+            header.samples_per_pixel *= configuration.depth_of_field_samples;
+        header.samples_seed = samples_seed;
+        header.render_hash = computeRenderHash(configuration);
+        header.has_features = configuration.use_denoiser && image->hasFeatures() ? 1 : 0;
+
+        // Creating the directory of the checkpoints
+        error_code error;
+        filesystem::create_directories(configuration.checkpoint_directory, error);
+    }
+
+    /**
+    * Opens the checkpoint of an image as requested by the configuration, restoring the previous one when resuming
+    * @param configuration The configuration of the render
+    * @param image The image being rendered
+    * @param image_tiles The tiles the image is split in
+    * @param samples_seed The seed of the samples of the image
+    * @return The checkpoint, null if the checkpoints are disabled
+    */
+    static unique_ptr<RenderCheckpoint> open(const RenderConfiguration & configuration, Image * image,
+        const vector<RenderTile> & image_tiles, const uint64_t samples_seed) {
+        if(configuration.checkpoint_directory.empty())
+            return nullptr;
+
+        // Restoring the tiles completed before the interruption
+        auto checkpoint = make_unique<RenderCheckpoint>(configuration, image, image_tiles, samples_seed);
+        if(configuration.resume_from_checkpoint) {
+            const int restored_tiles = checkpoint->resume();
+            cout << "Resuming " << image->getName() << " from " << restored_tiles << " of " << image_tiles.size()
+                << " tiles" << endl;
+        }
+
+        return checkpoint;
+    }
+
+    /**
+    * Function that restores the completed tiles of a previous checkpoint of the same render
+    * @return The amount of restored tiles, 0 if there is no checkpoint or it belongs to a different render
+    */
+    int resume() {
+        // Opening the checkpoint
+        ifstream file(path, ios::binary);
+        if(!file.is_open())
+            return 0;
+
+        // Verifying that the checkpoint belongs to the same render
+        CheckpointHeader stored_header {};
+        vector<uint8_t> stored_tiles(completed_tiles.size());
+        file.read(reinterpret_cast<char *>(& stored_header), sizeof(CheckpointHeader));
+        file.read(reinterpret_cast<char *>(stored_tiles.data()), static_cast<streamsize>(stored_tiles.size()));
+        if(!file || memcmp(& stored_header, & header, sizeof(CheckpointHeader)) != 0) {
+            PrintError("Ignoring the checkpoint " + path + ", written by a different render");
+            return 0;
+        }
+
+        // Restoring the pixels of the completed tiles
+        int restored_tiles = 0;
+        vector<float> pixels;
+        for(size_t t = 0; t < tiles.size(); t++) {
+            if((stored_tiles[t / 8] & (1u << (t % 8))) == 0)
+                continue;
+            const RenderTile & tile = tiles[t];
+            const size_t tile_pixels = static_cast<size_t>(tile.x_end - tile.x_start) * (tile.y_end - tile.y_start);
+            pixels.resize((header.has_features ? 10 : 3) * tile_pixels);
+            if(!file.read(reinterpret_cast<char *>(pixels.data()),
+                static_cast<streamsize>(pixels.size() * sizeof(float)))) {
+                PrintError("Ignoring the truncated checkpoint " + path);
+                fill(completed_tiles.begin(), completed_tiles.end(), 0);
+                return 0;
+            }
+            int pixel = 0;
+            for(int y = tile.y_start; y < tile.y_end; y++)
+                for(int x = tile.x_start; x < tile.x_end; x++, pixel++)
+                    image->setHDRPixel(x, y, {pixels[3 * pixel], pixels[3 * pixel + 1], pixels[3 * pixel + 2]});
+            if(header.has_features) {
+                const float * features = pixels.data() + 3 * tile_pixels;
+                for(int y = tile.y_start; y < tile.y_end; y++) {
+                    for(int x = tile.x_start; x < tile.x_end; x++, features += 7) {
+                        image->setPixelFeatures(x, y, PixelFeatures {
+                            .albedo = glm::vec3(features[0], features[1], features[2]),
+                            .normal = glm::vec3(features[3], features[4], features[5]),
+                            .depth = features[6]
+                        });
+                    }
+                }
+            }
+            completed_tiles[t / 8] |= static_cast<uint8_t>(1u << (t % 8));
+            restored_tiles++;
+        }
+
+        return restored_tiles;
+    }
+
+    /**
+    * Checks weather a tile is completed
+    * @param tile_index The index of the tile
+    * @return True if the pixels of the tile accumulated all their samples
+    */
+    [[nodiscard]] bool isTileCompleted(const int tile_index) const {
+        return (completed_tiles[tile_index / 8] & (1u << (tile_index % 8))) != 0;
+    }
+
+    /**
+    * Marks a tile as completed, writing the checkpoint if the interval elapsed since the previous one
+    * @param tile_index The index of the tile
+    */
+    void completeTile(const int tile_index) {
+        lock_guard lock(checkpoint_mutex);
+        completed_tiles[tile_index / 8] |= static_cast<uint8_t>(1u << (tile_index % 8));
+        if(chrono::steady_clock::now() - last_save >= interval)
+            save();
+    }
+
+    /**
+    * Function that writes the checkpoint of the completed image, so that resuming does not render it again
+    */
+    void finish() {
+        lock_guard lock(checkpoint_mutex);
+        save();
+    }
+};
+
+#endif //RENDER_CHECKPOINT_H
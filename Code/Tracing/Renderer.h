@@ -0,0 +1,401 @@
+//
+// Created by Guglielmo Mazzesi on 10/19/2026.
+//
+
+#ifndef RENDERER_H
+#define RENDERER_H
+
+/**
+* Kernel rendering a tile of the image captured by a camera
+*/
+using RenderKernel = void (*)(const Camera * current_camera, Image * current_image, const RenderTile & tile,
+    uint64_t samples_seed);
+
+// Amount of possible combinations of the render_feature flags
+constexpr unsigned int RENDER_FEATURES_COMBINATIONS = 1u << 5;
+
+/**
+ * Function that generates the pixel color based on camera and ray direction
+ * @tparam FEATURES The render_feature flags the kernel is specialized on
+ * @param current_camera The camera currently rendering the scene
+ * @param ray_direction The ray pointing at the pixel from the camera prospective
+ * @param footprint Distance between adjacent samples on the image plane at unit distance, used by ray differentials
+ * @param features The features of the pixel accumulating the ones of the camera rays, null if not requested
+ * @param features_weight The weight of the camera rays within the samples of the pixel
+ * @return The color of the pixel
+ */
+template <unsigned int FEATURES>
+glm::vec3 computePixel(const Camera * current_camera, const glm::vec3 ray_direction, const float footprint,
+    PixelFeatures * features = nullptr, const float features_weight = 1.0f) {
+    // Generating the pixel value using depth of field
+    if constexpr ((FEATURES & DEPTH_OF_FIELD_FEATURE) != 0) {
+        // Initializing the pixel color
+        auto pixel_color = glm::vec3(0);
+
+        // Extracting the amount of lens samples
+        const int samples_amount = render_configuration.depth_of_field_samples;
+
+        // Initializing the focal point
+        glm::vec3 focal_point = current_camera->getFocalDistance()
+                                    * (ray_direction / ray_direction.z) ;
+
+        // Creating a samples of ray shifted by the lens aperture
+        for(int k = 0; k < samples_amount; k++) {
+            // Generating a random 2D coordinate withing the lens plane
+            glm::vec2 lens_offset = sample_generator.getDiskSample(current_camera->getAperture());
+            // Generating the new ray origin, shifted by the aperture lens
+            auto shifted_ray_origin = glm::vec3(lens_offset.x, lens_offset.y, 0.0f);
+            // Generating the new ray direction, going from the new origin to the focal point
+            glm::vec3 shifted_ray_direction = normalize(focal_point - shifted_ray_origin);
+
+            // Creating the new ray, whose differentials aim at the focal points of the adjacent samples
+            Ray shifted_ray {
+            .origin = shifted_ray_origin,
+            .direction = shifted_ray_direction,
+            .current_medium_refraction_index = 1.0f,
+            .has_differentials = true,
+            .dx_direction = normalize(focal_point + glm::vec3(footprint * focal_point.z, 0, 0) - shifted_ray_origin),
+            .dy_direction = normalize(focal_point - glm::vec3(0, footprint * focal_point.z, 0) - shifted_ray_origin)
+            };
+
+            // Globalizing the ray
+            shifted_ray = current_camera->globalizeRay(shifted_ray);
+
+            // Creating the pixel color, along with the features of the surface hit by the ray
+            countStatistic(CAMERA_RAYS);
+            pixel_color += traceRay<FEATURES>(shifted_ray, 0, features,
+                features_weight / static_cast<float>(samples_amount));
+        }
+
+        // Computing the mean value of all the shifted rays
+        pixel_color = pixel_color / static_cast<float>(samples_amount);
+
+        // Returning the value
+        return pixel_color;
+    }
+    // Generating the pixel value with an infinitely small aperture
+    else {
+        // Projecting the direction on the image plane at unit distance
+        const glm::vec3 image_plane_point = ray_direction / ray_direction.z;
+
+        // Creating the ray object, whose differentials aim at the adjacent samples
+        Ray current_ray {
+            .origin = glm::vec3(0.0f),
+            .direction = ray_direction,
+            .current_medium_refraction_index = 1.0f,
+            .has_differentials = true,
+            .dx_direction = normalize(image_plane_point + glm::vec3(footprint, 0, 0)),
+            .dy_direction = normalize(image_plane_point - glm::vec3(0, footprint, 0))
+        };
+
+        // Globalizing the ray
+        current_ray = current_camera->globalizeRay(current_ray);
+
+        // Returning the pixel value, along with the features of the surface hit by the ray
+        countStatistic(CAMERA_RAYS);
+        return traceRay<FEATURES>(current_ray, 0, features, features_weight);
+    }
+}
+
+/**
+ * Function that renders the HDR pixels of a tile of the image
+ * @tparam FEATURES The render_feature flags the kernel is specialized on
+ * @param current_camera The camera currently rendering the scene
+ * @param current_image The image storing the HDR pixels
+ * @param tile The tile to render
+ * @param samples_seed The seed of the samples of the image, see SampleGenerator::computeImageSeed
+ */
+template <unsigned int FEATURES>
+void renderTile(const Camera * current_camera, Image * current_image, const RenderTile & tile,
+    const uint64_t samples_seed) {
+    // Ensure camera dimensions are integers
+    const int camera_width = static_cast<int>(current_camera->getWidth());
+    const int camera_height = static_cast<int>(current_camera->getHeight());
+    const float camera_fov = current_camera->getFOV();
+
+    // Compute pixel size and position
+    const float pixel_size = 2 * tan(glm::radians(camera_fov / 2)) / camera_width;
+    const float top_left_X = -(pixel_size * camera_width) / 2;
+    const float top_left_Y = (pixel_size * camera_height) / 2;
+
+    for (int i = tile.x_start; i < tile.x_end; i++) {
+        for (int j = tile.y_start; j < tile.y_end; j++) {
+            glm::vec3 pixel_color(0.0f);
+
+            // Averaging the features of the surfaces hit by the camera rays, if the denoiser needs them
+            PixelFeatures pixel_features;
+            PixelFeatures * features = current_image->hasFeatures() ? & pixel_features : nullptr;
+
+            // Reseeding the samples on the stream of the pixel
+            sample_generator.seedPixel(samples_seed, static_cast<uint64_t>(j) * camera_width + i);
+
+            // Compute pixel value with antialiasing
+            if constexpr ((FEATURES & ANTIALIASING_FEATURE) != 0) {
+                const int subdivisions = render_configuration.antialiasing_subdivisions;
+                const float increment_ray_difference = pixel_size / static_cast<float>(subdivisions);
+
+                for (int delta_x = 0; delta_x < subdivisions; delta_x++) {
+                    for (int delta_y = 0; delta_y < subdivisions; delta_y++) {
+                        glm::vec3 current_ray_direction(
+                            top_left_X + i * pixel_size + increment_ray_difference * delta_x,
+                            top_left_Y - j * pixel_size - increment_ray_difference * delta_y,
+                            1.0f
+                        );
+                        current_ray_direction = normalize(current_ray_direction);
+                        pixel_color += computePixel<FEATURES>(current_camera, current_ray_direction,
+                            increment_ray_difference, features, 1.0f / static_cast<float>(subdivisions * subdivisions));
+                    }
+                }
+                pixel_color /= static_cast<float>(subdivisions * subdivisions);
+            }
+            // Compute pixel value without antialiasing
+            else {
+                glm::vec3 current_ray_direction(
+                    top_left_X + i * pixel_size + pixel_size / 2,
+                    top_left_Y - j * pixel_size - pixel_size / 2,
+                    1.0f
+                );
+                current_ray_direction = normalize(current_ray_direction);
+                pixel_color = computePixel<FEATURES>(current_camera, current_ray_direction, pixel_size, features);
+            }
+
+            // Set the HDR pixel
+            current_image->setHDRPixel(i, j, pixel_color);
+
+            // Set the features guiding the denoiser
+            if(features) {
+                if(glm::length2(pixel_features.normal) > 0.0f)
+                    pixel_features.normal = normalize(pixel_features.normal);
+                current_image->setPixelFeatures(i, j, pixel_features);
+            }
+        }
+    }
+}
+
+/**
+* Builds the table of render kernels, one per combination of the render_feature flags
+* @return The table of kernels, indexed by feature mask, one per index of the sequence
+*/
+template <size_t... INDEXES>
+constexpr array<RenderKernel, sizeof...(INDEXES)> buildRenderKernels(index_sequence<INDEXES...>) {
+    return { & renderTile<static_cast<unsigned int>(INDEXES)>... };
+}
+
+// Table of all the specialized render kernels, indexed by feature mask
+inline constexpr auto render_kernels = buildRenderKernels(make_index_sequence<RENDER_FEATURES_COMBINATIONS>());
+
+/**
+* Selects the render kernel specialized on the features enabled by a configuration
+* @param configuration The render configuration
+* @return The specialized render kernel
+*/
+inline RenderKernel selectRenderKernel(const RenderConfiguration & configuration) {
+    return render_kernels[configuration.getRenderFeatures()];
+}
+
+/**
+* Splits an image in square tiles, of RENDER_TILE_SIZE x RENDER_TILE_SIZE pixels by default
+* @param width The width of the image
+* @param height The height of the image
+* @param tile_size The side of the tiles
+* @return The list of tiles covering the image
+*/
+inline vector<RenderTile> generateRenderTiles(const int width, const int height,
+    const int tile_size = RENDER_TILE_SIZE) {
+    // Initializing the tiles
+    vector<RenderTile> tiles;
+
+    // Splitting the image, the last row and column of tiles may be smaller
+    for(int y = 0; y < height; y += tile_size) {
+        for(int x = 0; x < width; x += tile_size) {
+            tiles.push_back(RenderTile {
+                .x_start = x,
+                .y_start = y,
+                .x_end = min(x + tile_size, width),
+                .y_end = min(y + tile_size, height)
+            });
+        }
+    }
+
+    return tiles;
+}
+
+/**
+* Renders an image by distributing its tiles among the OpenMP threads, checkpointing the completed tiles if the
+* configuration requests it
+* @param render_kernel The kernel used to render each tile
+* @param current_camera The camera currently rendering the scene
+* @param current_image The image storing the HDR pixels
+* @param samples_seed The seed of the samples of the image, see SampleGenerator::computeImageSeed
+* @param on_tile_completed Function invoked by the rendering thread once the pixels of a tile are final, if any
+*/
+inline void renderImage(const RenderKernel render_kernel, const Camera * current_camera, Image * current_image,
+    const uint64_t samples_seed, const function<void (const RenderTile &)> & on_tile_completed = nullptr) {
+    // Splitting the image in tiles
+    const vector<RenderTile> tiles = generateRenderTiles(static_cast<int>(current_camera->getWidth()),
+        static_cast<int>(current_camera->getHeight()));
+
+    // Allocating the features guiding the denoiser
+    if(render_configuration.use_denoiser)
+        current_image->enableFeatures();
+
+    // Skipping the tiles completed before an interruption
+    const auto checkpoint = RenderCheckpoint::open(render_configuration, current_image, tiles, samples_seed);
+    vector<int> remaining_tiles;
+    for(int t = 0; t < static_cast<int>(tiles.size()); t++)
+        if(!checkpoint || !checkpoint->isTileCompleted(t))
+            remaining_tiles.push_back(t);
+
+    // Create a shared progress counter
+    int progress = static_cast<int>(tiles.size() - remaining_tiles.size());
+    const int total_tiles = static_cast<int>(tiles.size());
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int r = 0; r < static_cast<int>(remaining_tiles.size()); r++) {
+        const int t = remaining_tiles[r];
+
+        // Rendering the current tile
+        {
+            const ProfilerScope profiler_scope("render tile", "render", false, tiles[t].x_start, tiles[t].y_start);
+            render_kernel(current_camera, current_image, tiles[t], samples_seed);
+        }
+
+        // Releasing the geometry held while rendering the tile
+        sds->releaseThreadReferences();
+
+        // Recording the completed tile
+        if(checkpoint)
+            checkpoint->completeTile(t);
+        if(on_tile_completed)
+            on_tile_completed(tiles[t]);
+
+        // Updating the progress counter atomically
+        if (PRINT_RAYTRACING_EXECUTION_PERCENTAGE) {
+            #pragma omp atomic
+            progress++;
+        }
+
+        // Print current progress
+        if (PRINT_RAYTRACING_EXECUTION_PERCENTAGE) {
+            #pragma omp critical
+            {
+                // Computing the total progress
+                float percent_complete = ((progress * 100.0f) / total_tiles);
+                // Printing the total progress
+                cout << fixed << setprecision(2) << current_camera->getName()
+                    << " current progress: " << percent_complete << " %" << std::endl;
+            }
+        }
+    }
+
+    // Recording the completed image
+    if(checkpoint)
+        checkpoint->finish();
+}
+
+/**
+* Renders a region of an image by splitting it in tiles distributed among the OpenMP threads
+* @param render_kernel The kernel used to render each tile
+* @param current_camera The camera currently rendering the scene
+* @param current_image The image storing the HDR pixels
+* @param region The region to render
+* @param samples_seed The seed of the samples of the image, see SampleGenerator::computeImageSeed
+*/
+inline void renderRegion(const RenderKernel render_kernel, const Camera * current_camera, Image * current_image,
+    const RenderTile & region, const uint64_t samples_seed) {
+    // Splitting the region in tiles
+    vector<RenderTile> tiles = generateRenderTiles(region.x_end - region.x_start, region.y_end - region.y_start);
+    for(auto & tile : tiles) {
+        tile.x_start += region.x_start;
+        tile.x_end += region.x_start;
+        tile.y_start += region.y_start;
+        tile.y_end += region.y_start;
+    }
+
+    // Allocating the features guiding the denoiser
+    if(render_configuration.use_denoiser)
+        current_image->enableFeatures();
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int t = 0; t < static_cast<int>(tiles.size()); t++) {
+        render_kernel(current_camera, current_image, tiles[t], samples_seed);
+
+        // Releasing the geometry held while rendering the tile
+        sds->releaseThreadReferences();
+    }
+}
+
+/**
+ * Function that bakes the diffuse of the procedural materials over the bounding box of their primitives, so that
+ * their variation along the surfaces is shaded at the cost of a texture fetch
+ * @param configuration The configuration selecting the bake mode and resolution
+ */
+inline void BakeProceduralMaterials(const RenderConfiguration & configuration) {
+    if(configuration.procedural_bake_mode == NO_BAKE)
+        return;
+
+    // Computing the bounding box of the primitives of each procedural material, along with the boxes of the primitives
+    map<const Material *, BoundingBox3> materials_bounds;
+    map<const Material *, vector<pair<glm::vec3, glm::vec3>>> primitives_bounds;
+    for(const auto primitive : primitives) {
+        const Material * material = primitive->getMaterialPointer();
+        if(material == nullptr || !material->isProcedural())
+            continue;
+
+        // Skipping the unbounded primitives
+        const BoundingBox3 bounds = primitive->getWorldSpaceBoundingBox();
+        if(glm::any(glm::isinf(bounds.min_coordinates)) || glm::any(glm::isinf(bounds.max_coordinates)))
+            continue;
+
+        // Extending the bounding box of the material
+        const auto [entry, inserted] = materials_bounds.try_emplace(material, bounds);
+        if(!inserted) {
+            entry->second.min_coordinates = glm::min(entry->second.min_coordinates, bounds.min_coordinates);
+            entry->second.max_coordinates = glm::max(entry->second.max_coordinates, bounds.max_coordinates);
+        }
+        primitives_bounds[material].emplace_back(bounds.min_coordinates, bounds.max_coordinates);
+    }
+
+    // Baking the materials
+    const ProfilerScope profiler_scope("bake the procedural materials", "build", PRINT_SDS_BUILDING_TIME);
+    for(const auto & [material, bounds] : materials_bounds) {
+        auto volume = make_unique<BakedVolume>(bounds.min_coordinates, bounds.max_coordinates,
+            configuration.procedural_bake_resolution,
+            [material](const glm::vec3 & point) { return material->getDiffuse(point); });
+
+        // Baking upfront the bricks around the primitives, unless the bricks are baked when first touched
+        if(configuration.procedural_bake_mode == EAGER_BAKE)
+            volume->bakeAround(primitives_bounds[material]);
+
+        baked_volumes.emplace_back(material, std::move(volume));
+    }
+}
+
+/**
+ * Function tha reset the scene between frames generation
+ */
+inline void ResetScene() {
+    // Releasing the baked volumes, the materials being redefined at each frame
+    baked_volumes.clear();
+
+    // Clearing the containers of entities
+    lights.clear();
+    directional_lights.clear();
+    primitives.clear();
+    planes.clear();
+    cameras.clear();
+
+    // Clearing the photons map
+    caustic_photons.clear();
+    indirect_photons.clear();
+    deleteKDTree(caustic_photons_root);
+    deleteKDTree(indirect_photons_root);
+    caustic_photons_root = nullptr;
+    indirect_photons_root = nullptr;
+
+    // Freeing the SDS memory
+    delete sds;
+    sds = nullptr;
+}
+
+#endif //RENDERER_H
@@ -4,13 +4,36 @@
 
 #ifndef CORE_H
 #define CORE_H
+/**
+ * Function that accumulates the features of the surface hit by a camera ray, guiding the denoiser
+ * @param interaction The interaction of the camera ray, whose UV differentials were computed
+ * @param weight The weight of the ray within the samples of the pixel
+ * @param features The features of the pixel, accumulating the ones of the surface
+ */
+inline void accumulatePixelFeatures(const Interaction & interaction, const float weight, PixelFeatures & features) {
+    // Extracting the features of the surface, the albedo being scaled like the surface intensity by the tracer
+    const Material & surface_material = * interaction.material;
+    features.albedo += weight * interaction.primitive->getDiffuse(interaction)
+        * max(0.0f, 1 - surface_material.refractivity - surface_material.reflectivity);
+    features.normal += weight * interaction.normal;
+    features.depth += weight * interaction.distance;
+}
+
 /**
  Functions that computes a color along the ray
+ @tparam FEATURES The render_feature flags the kernel is specialized on
  @param current_ray Ray that should be traced through the scene
  @param recursion_level The current recursion level, used to prevent infinite ray reflection/refractivity
+ @param features The features of the pixel accumulating the ones of the surface hit by a camera ray, null if none
+ @param features_weight The weight of the camera ray within the samples of the pixel
  @return Color intensity at the intersection point
  */
-inline glm::vec3 traceRay(const Ray & current_ray, unsigned int recursion_level) {
+template <unsigned int FEATURES>
+glm::vec3 traceRay(const Ray & current_ray, unsigned int recursion_level, PixelFeatures * features = nullptr,
+    const float features_weight = 1.0f) {
+    // Recording the recursion depth
+    countRecursionDepth(recursion_level);
+
     // If I reached too deep of a recursion, return
     if(recursion_level >= MAX_RAY_TRACING_RECURSION_LEVEL) {
         if(PRINT_MAXIMUM_RECURSION_LEVEL_REACHED)
@@ -25,12 +48,19 @@ inline glm::vec3 traceRay(const Ray & current_ray, unsigned int recursion_level)
     glm::vec3 refractive_intensity(0.0);
 
     // Computing the first intersection
-    const Interaction closest_interaction = bvh->intersect(current_ray);
+    Interaction closest_interaction = sds->intersect(current_ray);
 
     // Case in which the ray does not intersect anything
     if(!closest_interaction.hit)
         return glm::vec3(0);
 
+    // Estimating the texture footprint of the ray
+    closest_interaction.primitive->computeUVDifferentials(current_ray, closest_interaction);
+
+    // Recording the features of the surface hit by a camera ray, reusing its intersection
+    if(features)
+        accumulatePixelFeatures(closest_interaction, features_weight, * features);
+
     // Extracting the material from the intersected object
     const Material & surface_material = * closest_interaction.material;
 
@@ -51,20 +81,22 @@ inline glm::vec3 traceRay(const Ray & current_ray, unsigned int recursion_level)
 
         // Case in which the ray is leaving the volumetric medium
         if(dot(current_ray.direction, closest_interaction.normal) > 0) {
-            return traceRay(current_ray, recursion_level + 1);
+            countStatistic(VOLUMETRIC_RAYS);
+            return traceRay<FEATURES>(current_ray, recursion_level + 1);
         }
 
         // Computing the distance to the next primitive
-        const auto [hit, normal, intersection, uv_coordinates, distance, primitive, material] = bvh->intersect(volumetric_ray);
+        const float distance = sds->intersect(volumetric_ray).distance;
 
         // Case in which the ray is entering the volumetric medium
         const float intersection_probability = 1 - exp(-distance * surface_material.density);
 
         // Computing the surface intensity of the volumetric render
-        const auto volume_intensity = surface_material.computeSurfaceIntensity(closest_interaction, current_ray) * intersection_probability;
+        const auto volume_intensity = surface_material.computeSurfaceIntensity<FEATURES>(closest_interaction, current_ray) * intersection_probability;
 
         // Computing the intensity of whatever lies withing or behind the medium
-        const auto wrapped_intensity = traceRay(volumetric_ray, recursion_level + 1) * (1 - intersection_probability);
+        countStatistic(VOLUMETRIC_RAYS);
+        const auto wrapped_intensity = traceRay<FEATURES>(volumetric_ray, recursion_level + 1) * (1 - intersection_probability);
 
         // Computing the final value
         return volume_intensity + wrapped_intensity;
@@ -85,7 +117,8 @@ inline glm::vec3 traceRay(const Ray & current_ray, unsigned int recursion_level)
             };
 
             // Computing the reflective intensity of the new ray
-            reflective_intensity = traceRay(reflected_ray, recursion_level + 1);
+            countStatistic(REFLECTED_RAYS);
+            reflective_intensity = traceRay<FEATURES>(reflected_ray, recursion_level + 1);
         }
         // Case in which the material is not perfectly glossy
         else {
@@ -95,7 +128,7 @@ inline glm::vec3 traceRay(const Ray & current_ray, unsigned int recursion_level)
                 float disk_radius = 2e-1 - surface_material.glossiness * 2e-1;
 
                 // Generating a random perturbation
-                glm::vec2 random_perturbation = glm::diskRand(disk_radius);
+                glm::vec2 random_perturbation = sample_generator.getDiskSample(disk_radius);
 
                 // Applying the perturbation
                 glm::vec3 randomized_reflected_direction = normalize(
@@ -108,7 +141,8 @@ inline glm::vec3 traceRay(const Ray & current_ray, unsigned int recursion_level)
                 };
 
                 // Computing the value of this ray
-                reflective_intensity += traceRay(randomized_reflected_ray, recursion_level + 1);
+                countStatistic(REFLECTED_RAYS);
+                reflective_intensity += traceRay<FEATURES>(randomized_reflected_ray, recursion_level + 1);
             }
 
             // Computing the mean value of the scattering
@@ -153,7 +187,8 @@ inline glm::vec3 traceRay(const Ray & current_ray, unsigned int recursion_level)
             };
 
             // Computing the refractive intensity
-            refractive_intensity = traceRay(refracted_ray, recursion_level + 1);
+            countStatistic(REFRACTED_RAYS);
+            refractive_intensity = traceRay<FEATURES>(refracted_ray, recursion_level + 1);
         }
         // Case in which I move between 2 medium with different refraction index
         else {
@@ -163,7 +198,7 @@ inline glm::vec3 traceRay(const Ray & current_ray, unsigned int recursion_level)
             glm::vec3 sub_reflected_direction = reflect(incident_direction, oriented_normal);
 
             // Case in which Fresnel effect is active
-            if(USE_FRESNEL) {
+            if constexpr ((FEATURES & FRESNEL_FEATURE) != 0) {
                 // SCHLICK APPROXIMATION (https://link.springer.com/chapter/10.1007/978-1-4842-7185-8_9)
                 // Computing the dot product between the oriented normal and the incident vector (cos incident)
                 float cos_theta_incident = abs(dot_incident_normal);
@@ -196,13 +231,15 @@ inline glm::vec3 traceRay(const Ray & current_ray, unsigned int recursion_level)
 
                 // Adding the intensity of the sub reflected ray
                 if(sub_reflection_coefficient > 1e-2) {
-                    sub_reflected_intensity = traceRay(reflected_ray, recursion_level + 1)
+                    countStatistic(REFLECTED_RAYS);
+                    sub_reflected_intensity = traceRay<FEATURES>(reflected_ray, recursion_level + 1)
                                             * sub_reflection_coefficient;
                 }
 
                 // Adding the intensity of the sub refracted ray
                 if(sub_refraction_coefficient > 1e-2) {
-                    sub_refracted_intensity = traceRay(refracted_ray, recursion_level + 1)
+                    countStatistic(REFRACTED_RAYS);
+                    sub_refracted_intensity = traceRay<FEATURES>(refracted_ray, recursion_level + 1)
                                             * sub_refraction_coefficient;
                 }
 
@@ -221,7 +258,8 @@ inline glm::vec3 traceRay(const Ray & current_ray, unsigned int recursion_level)
                     };
 
                     // Computing the reflected sub intensity
-                    refractive_intensity = traceRay(refracted_ray, recursion_level + 1)
+                    countStatistic(REFRACTED_RAYS);
+                    refractive_intensity = traceRay<FEATURES>(refracted_ray, recursion_level + 1)
                                            * surface_material.refractivity;
                 }
                 // Angle is greater than the critical angle: only reflection is possible
@@ -234,7 +272,8 @@ inline glm::vec3 traceRay(const Ray & current_ray, unsigned int recursion_level)
                     };
 
                     // Assigning the reflection value
-                    refractive_intensity = traceRay(reflected_ray, recursion_level + 1);
+                    countStatistic(REFLECTED_RAYS);
+                    refractive_intensity = traceRay<FEATURES>(reflected_ray, recursion_level + 1);
                 }
             }
         }
@@ -254,11 +293,11 @@ inline glm::vec3 traceRay(const Ray & current_ray, unsigned int recursion_level)
     //     };
     //
     //     // Computing the transparency intensity
-    //     transparent_intensity = traceRay(transparency_ray, recursion_level + 1) * surface_material.transparency;
+    //     transparent_intensity = traceRay<FEATURES>(transparency_ray, recursion_level + 1) * surface_material.transparency;
     // }
 
     // SURFACE
-    surface_intensity = surface_material.computeSurfaceIntensity(closest_interaction, current_ray);
+    surface_intensity = surface_material.computeSurfaceIntensity<FEATURES>(closest_interaction, current_ray);
 
     // Applying the surface material diffuse coefficient
     surface_intensity *= max(0.0f, 1 - surface_material.refractivity - surface_material.reflectivity);
@@ -284,8 +323,11 @@ inline void tracePhoton(const Photon & current_photon, unsigned int recursion_le
         return;
     }
 
+    // Counting the photon ray
+    countStatistic(PHOTON_RAYS);
+
     // Computing the closest interaction
-    const Interaction closest_interaction = bvh->intersect(current_photon.ray);
+    const Interaction closest_interaction = sds->intersect(current_photon.ray);
 
     // Case in which the photon ray does not intersect anything
     if(!closest_interaction.hit)
@@ -352,7 +394,7 @@ inline void tracePhoton(const Photon & current_photon, unsigned int recursion_le
             glm::vec3 sub_reflected_direction = reflect(incident_direction, oriented_normal);
 
             // Case in which Fresnel effect is active
-            if(USE_FRESNEL) {
+            if(render_configuration.use_fresnel) {
                 // SCHLICK APPROXIMATION (https://link.springer.com/chapter/10.1007/978-1-4842-7185-8_9)
                 // Computing the dot product between the oriented normal and the incident vector (cos incident)
                 float cos_theta_incident = abs(dot_incident_normal);
@@ -472,12 +514,12 @@ inline void tracePhoton(const Photon & current_photon, unsigned int recursion_le
     // Adding the photon
     switch (surface_photon.type) {
         case INDIRECT : {
-            if(USE_INDIRECT_LIGHTING)
+            if(render_configuration.use_indirect_lighting)
                 indirect_photons.push_back(surface_photon);
             break;
         }
         case CAUSTIC : {
-            if(USE_CAUSTIC)
+            if(render_configuration.use_caustic)
                 caustic_photons.push_back(surface_photon);
             break;
         }
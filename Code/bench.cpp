@@ -0,0 +1,482 @@
+/**
+@file bench.cpp
+*/
+
+using namespace std;
+
+#include "Import.h"
+
+// Benchmark settings
+constexpr unsigned int BENCHMARK_SEED = 42; ///< Seed shared by all the benchmarks, used to make the runs reproducible
+constexpr int BENCHMARK_REPETITIONS = 3; ///< Amount of timed repetitions of each benchmark, the best one is reported
+inline auto benchmark_resolution = glm::vec2(256, 192); ///< Resolution of the cameras used by the scene benchmarks
+
+/**
+* Result of a single benchmark
+*/
+struct BenchmarkResult {
+    string name; ///< Name of the benchmark
+    string category; ///< Category of the benchmark (micro or scene)
+    string unit; ///< The unit of work measured by the benchmark (rays, primary_rays, queries, samples, pixels)
+    double operations = 0; ///< Amount of units of work executed by a single repetition
+    double seconds = 0; ///< Wall clock time of the best repetition
+    double checksum = 0; ///< Value accumulated from the results, prevents the compiler from removing the work
+
+    /**
+    * Computes the throughput of the benchmark
+    * @return Millions of units of work per second (Mrays/s for the ray benchmarks)
+    */
+    [[nodiscard]] double getThroughput() const {
+        return seconds > 0 ? operations / seconds / 1e6 : 0;
+    }
+};
+
+vector<BenchmarkResult> results; ///< The results of the executed benchmarks
+string benchmark_filter; ///< Only the benchmarks containing this string in their name are executed
+string output_path = "./bench.json"; ///< Path of the JSON report
+
+/**
+* Verifies whether a benchmark should be executed
+* @param name The name of the benchmark
+*/
+bool isBenchmarkSelected(const string & name) {
+    return benchmark_filter.empty() || name.find(benchmark_filter) != string::npos;
+}
+
+/**
+* Times a benchmark, keeping the best of BENCHMARK_REPETITIONS runs after a warm-up run
+* @param name Name of the benchmark
+* @param category Category of the benchmark
+* @param unit The unit of work measured by the benchmark
+* @param operations Amount of units of work executed by each run
+* @param body The benchmark body, returning a checksum of its results
+*/
+void runBenchmark(const string & name, const string & category, const string & unit, const double operations,
+    const function<double()> & body) {
+    // Initializing the result
+    BenchmarkResult result {
+        .name = name,
+        .category = category,
+        .unit = unit,
+        .operations = operations,
+        .seconds = INFINITY
+    };
+
+    // Warming up caches and lazily initialized data
+    result.checksum = body();
+
+    // Timing the repetitions
+    for(int i = 0; i < BENCHMARK_REPETITIONS; i++) {
+        const double starting_time = GetWallTime();
+        result.checksum = body();
+        result.seconds = min(result.seconds, GetWallTime() - starting_time);
+    }
+
+    // Printing the result
+    cout << fixed << setprecision(3) << left << setw(36) << name << right << setw(12) << result.getThroughput()
+        << " M" << unit << "/s" << setw(12) << result.seconds * 1e3 << " ms" << endl;
+
+    results.push_back(result);
+}
+
+/**
+* Generates rays with origin on a sphere around the unit cube, pointing to random points within it
+* @param amount Amount of rays to generate
+* @param radius Radius of the sphere containing the origins
+*/
+vector<Ray> generateBenchmarkRays(const int amount, const float radius) {
+    // Initializing a generator independent of the global one
+    mt19937 generator(BENCHMARK_SEED);
+    uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    // Generating the rays
+    vector<Ray> rays;
+    rays.reserve(amount);
+    for(int i = 0; i < amount; i++) {
+        // Generating the origin and the target
+        const glm::vec3 origin = normalize(glm::vec3(distribution(generator), distribution(generator),
+            distribution(generator))) * radius;
+        const glm::vec3 target = glm::vec3(distribution(generator), distribution(generator), distribution(generator));
+
+        rays.push_back(Ray {
+            .origin = origin,
+            .direction = normalize(target - origin)
+        });
+    }
+
+    return rays;
+}
+
+/**
+* Benchmarks the slab test of the bounding boxes
+*/
+void benchmarkBoundingBox() {
+    if(!isBenchmarkSelected("box_slab_test"))
+        return;
+
+    // Initializing the data
+    const auto box = BoundingBox3(glm::vec3(-0.5f), glm::vec3(0.5f));
+    const vector<Ray> rays = generateBenchmarkRays(1 << 20, 4.0f);
+
+    // Precomputing the reciprocals, as the BVH traversal does
+    vector<glm::vec3> reciprocals(rays.size());
+    for(size_t i = 0; i < rays.size(); i++)
+        reciprocals[i] = 1.0f / rays[i].direction;
+
+    runBenchmark("box_slab_test", "micro", "rays", static_cast<double>(rays.size()), [&] {
+        double hits = 0;
+        for(size_t i = 0; i < rays.size(); i++) {
+            const int is_direction_negative[3] = {reciprocals[i].x < 0, reciprocals[i].y < 0, reciprocals[i].z < 0};
+            hits += box.DoesRayIntersect(rays[i], reciprocals[i], is_direction_negative);
+        }
+        return hits;
+    });
+}
+
+/**
+* Benchmarks the ray-triangle intersection
+*/
+void benchmarkTriangle() {
+    if(!isBenchmarkSelected("triangle_test"))
+        return;
+
+    // Initializing the triangle
+    static const glm::vec3 coordinates[3] = {glm::vec3(-1, -1, 0), glm::vec3(1, -1, 0), glm::vec3(0, 1, 0)};
+    static const Vertex vertices[3] = {
+        {.coordinates = & coordinates[0], .uv_coordinates = nullptr, .normal = glm::vec3(0), .tangent = glm::vec3(0),
+            .bitangent = glm::vec3(0)},
+        {.coordinates = & coordinates[1], .uv_coordinates = nullptr, .normal = glm::vec3(0), .tangent = glm::vec3(0),
+            .bitangent = glm::vec3(0)},
+        {.coordinates = & coordinates[2], .uv_coordinates = nullptr, .normal = glm::vec3(0), .tangent = glm::vec3(0),
+            .bitangent = glm::vec3(0)}
+    };
+    Triangle triangle(glm::mat4(1), vertices, false, & grey_material);
+
+    // Initializing the rays
+    const vector<Ray> rays = generateBenchmarkRays(1 << 20, 4.0f);
+
+    runBenchmark("triangle_test", "micro", "rays", static_cast<double>(rays.size()), [&] {
+        double hits = 0;
+        for(const auto & ray : rays) {
+            Interaction interaction {.hit = false, .distance = INFINITY};
+            triangle.Intersect(ray, interaction);
+            hits += interaction.hit;
+        }
+        return hits;
+    });
+}
+
+/**
+* Benchmarks the BVH traversal over scenes of increasing size, hence of increasing depth
+*/
+void benchmarkBVH() {
+    for(const int primitives_amount : {64, 1024, 16384, 131072}) {
+        // Composing the name of the benchmark
+        const string name = "bvh_traversal_" + to_string(primitives_amount);
+        if(!isBenchmarkSelected(name))
+            continue;
+
+        // Scattering small spheres within the unit cube
+        mt19937 generator(BENCHMARK_SEED);
+        uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+        const float radius = 0.5f / cbrt(static_cast<float>(primitives_amount));
+        for(int i = 0; i < primitives_amount; i++) {
+            const glm::vec3 position(distribution(generator), distribution(generator), distribution(generator));
+            const glm::mat4 transform = glm::scale(glm::translate(glm::mat4(1), position), glm::vec3(radius));
+            primitives.push_back(new Sphere(transform, & grey_material));
+        }
+
+        // Building the SDS, selected with the sds option
+        sds = buildSDS(render_configuration);
+
+        // Tracing the rays
+        const vector<Ray> rays = generateBenchmarkRays(1 << 18, 4.0f);
+        runBenchmark(name, "micro", "rays", static_cast<double>(rays.size()), [&] {
+            double distance = 0;
+            #pragma omp parallel for schedule(dynamic, 1024) reduction(+ : distance)
+            for(int i = 0; i < static_cast<int>(rays.size()); i++) {
+                const Interaction interaction = sds->intersect(rays[i]);
+                if(interaction.hit)
+                    distance += interaction.distance;
+            }
+            return distance;
+        });
+
+        // Clearing the scene
+        ResetScene();
+    }
+}
+
+/**
+* Benchmarks the k nearest neighbors queries on the photons KD tree
+*/
+void benchmarkKDTree() {
+    if(!isBenchmarkSelected("kd_tree_knn"))
+        return;
+
+    // Generating the photons
+    mt19937 generator(BENCHMARK_SEED);
+    uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    vector<Photon> photons(1 << 17);
+    for(auto & photon : photons) {
+        photon.position = glm::vec3(distribution(generator), distribution(generator), distribution(generator));
+        photon.intensity = glm::vec3(1.0f);
+    }
+
+    // Building the KD tree
+    KDTreeNode * root = buildKDTree(photons);
+
+    // Generating the queries
+    vector<glm::vec3> queries(1 << 14);
+    for(auto & query : queries)
+        query = glm::vec3(distribution(generator), distribution(generator), distribution(generator));
+
+    runBenchmark("kd_tree_knn", "micro", "queries", static_cast<double>(queries.size()), [&] {
+        double found = 0;
+        #pragma omp parallel for schedule(dynamic, 64) reduction(+ : found)
+        for(int i = 0; i < static_cast<int>(queries.size()); i++)
+            found += static_cast<double>(getNearestNeighbors(root, queries[i], 60).size());
+        return found;
+    });
+
+    // Freeing the KD tree
+    deleteKDTree(root);
+}
+
+/**
+* Benchmarks the evaluation of the Perlin noise
+*/
+void benchmarkPerlinNoise() {
+    if(!isBenchmarkSelected("perlin_noise"))
+        return;
+
+    // Extracting the noise generator
+    const PerlinNoise * perlin_noise = PerlinNoise::getInstance();
+
+    // Amount of samples per axis
+    constexpr int samples_per_axis = 128;
+
+    runBenchmark("perlin_noise", "micro", "samples", pow(samples_per_axis, 3), [&] {
+        double noise = 0;
+        for(int x = 0; x < samples_per_axis; x++)
+            for(int y = 0; y < samples_per_axis; y++)
+                for(int z = 0; z < samples_per_axis; z++)
+                    noise += perlin_noise->Noise(x * 0.173, y * 0.173, z * 0.173);
+        return noise;
+    });
+}
+
+/**
+* Benchmarks the batched evaluation of the fractal noise, as used by the procedural materials and meshes
+*/
+void benchmarkFractalNoise() {
+    if(!isBenchmarkSelected("fractal_noise"))
+        return;
+
+    // Extracting the noise generator
+    const PerlinNoise * perlin_noise = PerlinNoise::getInstance();
+    const FractalNoiseParameters parameters {};
+
+    // Amount of samples per axis, the X axis being evaluated in batches
+    constexpr int samples_per_axis = 64;
+    constexpr int batch_size = 8;
+
+    runBenchmark("fractal_noise", "micro", "samples", pow(samples_per_axis, 3), [&] {
+        double noise = 0;
+        alignas(32) float x[batch_size], y[batch_size], z[batch_size], batch_noise[batch_size];
+        for(int k = 0; k < samples_per_axis; k++)
+            for(int j = 0; j < samples_per_axis; j++)
+                for(int i = 0; i < samples_per_axis; i += batch_size) {
+                    for(int lane = 0; lane < batch_size; lane++) {
+                        x[lane] = static_cast<float>(i + lane) * 0.173f;
+                        y[lane] = static_cast<float>(j) * 0.173f;
+                        z[lane] = static_cast<float>(k) * 0.173f;
+                    }
+                    perlin_noise->FractalNoiseBatch<batch_size>(x, y, z, batch_noise, parameters);
+                    for(const float value : batch_noise)
+                        noise += value;
+                }
+        return noise;
+    });
+}
+
+/**
+* Benchmarks the post-processing pipeline (tone mapping, clamping and gamma correction)
+*/
+void benchmarkToneMapping() {
+    if(!isBenchmarkSelected("tone_mapping"))
+        return;
+
+    // Image resolution
+    constexpr int width = 1024;
+    constexpr int height = 768;
+
+    // Generating the HDR values
+    mt19937 generator(BENCHMARK_SEED);
+    uniform_real_distribution<float> distribution(0.0f, 4.0f);
+    vector<glm::vec3> hdr_values(width * height);
+    for(auto & value : hdr_values)
+        value = glm::vec3(distribution(generator), distribution(generator), distribution(generator));
+
+    // Initializing the image
+    Image image("Tone Mapping Benchmark", width, height);
+
+    runBenchmark("tone_mapping", "micro", "pixels", width * height, [&] {
+        // Restoring the HDR values, since the pipeline works in place
+        for(int h = 0; h < height; h++)
+            for(int w = 0; w < width; w++)
+                image.setHDRPixel(w, h, hdr_values[h * width + w]);
+
+        // Applying the post-processing
+        image.applyPostProcessing();
+        return 0.0;
+    });
+}
+
+/**
+* Benchmarks the rendering of a shipped scene
+* @param name Name of the benchmark
+* @param define_scene Function populating the scene
+*/
+void benchmarkScene(const string & name, const function<void(int)> & define_scene) {
+    if(!isBenchmarkSelected(name))
+        return;
+
+    // Making the scene generation reproducible, the scene being defined by a single thread
+    RandomGenerator::getInstance()->setSeed(BENCHMARK_SEED);
+
+    // Defining the scene
+    defineStandardMaterials(0);
+    define_scene(0);
+
+    // Gathering the targets of the caustics photons, before the SDS may page the primitives out of memory
+    vector<CausticTarget> caustic_targets;
+    if(render_configuration.use_photon_mapping && render_configuration.use_caustic)
+        caustic_targets = collectCausticTargets();
+
+    // Building the SDS
+    sds = buildSDS(render_configuration);
+
+    // Tracing the photons
+    if(render_configuration.use_photon_mapping && render_configuration.use_caustic) {
+        traceCausticsPhotons(caustic_targets);
+        caustic_photons_root = buildKDTree(caustic_photons);
+    }
+
+    // Initializing the camera, placed as the default one in main
+    const glm::mat4 camera_transform = glm::translate(glm::mat4(1),glm::vec3(0, 3, -5));
+    const Camera camera(camera_transform, name, benchmark_resolution, 90, 11, 0.25);
+    Image image(name, static_cast<int>(benchmark_resolution.x), static_cast<int>(benchmark_resolution.y));
+
+    // Computing the amount of primary rays per frame, the secondary rays not being counted
+    double camera_rays = benchmark_resolution.x * benchmark_resolution.y;
+    if(render_configuration.use_antialiasing)
+        camera_rays *= render_configuration.antialiasing_subdivisions * render_configuration.antialiasing_subdivisions;
+    if(render_configuration.use_depth_of_field)
+        camera_rays *= render_configuration.depth_of_field_samples;
+
+    // Selecting the kernel
+    const RenderKernel render_kernel = selectRenderKernel(render_configuration);
+
+    runBenchmark(name, "scene", "primary_rays", camera_rays, [&] {
+        // Rendering the frame, every pixel drawing its samples from its own stream so that every repetition and every
+        // thread count trace the same rays
+        renderImage(render_kernel, & camera, & image, SampleGenerator::computeImageSeed(0, 0));
+
+        // Summing the pixels, so that the checksum verifies the reproducibility of the render
+        double radiance = 0;
+        for(int h = 0; h < image.getHeight(); h++)
+            for(int w = 0; w < image.getWidth(); w++) {
+                const glm::vec3 color = image.getHDRPixel(w, h);
+                radiance += color.r + color.g + color.b;
+            }
+        return radiance;
+    });
+
+    // Clearing the scene
+    ResetScene();
+}
+
+/**
+* Writes the results to a JSON file, so that they can be compared across commits
+* @param path The path of the JSON file
+*/
+void writeResults(const string & path) {
+    // Opening the file
+    ofstream file(path);
+
+    // Verifying that the file opened correctly
+    if(!file.is_open()) {
+        PrintError("Error opening file: " + path);
+        return;
+    }
+
+    // Writing the run information
+    file << "{" << endl;
+    file << "  \"seed\": " << BENCHMARK_SEED << "," << endl;
+    file << "  \"threads\": " << omp_get_max_threads() << "," << endl;
+    file << "  \"render_features\": " << render_configuration.getRenderFeatures() << "," << endl;
+    file << "  \"benchmarks\": [" << endl;
+
+    // Writing the benchmarks
+    for(size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult & result = results[i];
+        file << setprecision(6) << fixed
+            << "    {\"name\": \"" << result.name << "\", "
+            << "\"category\": \"" << result.category << "\", "
+            << "\"unit\": \"" << result.unit << "\", "
+            << "\"operations\": " << result.operations << ", "
+            << "\"seconds\": " << result.seconds << ", "
+            << "\"throughput\": " << result.getThroughput() << ", "
+            << "\"checksum\": " << result.checksum << "}"
+            << (i + 1 < results.size() ? "," : "") << endl;
+    }
+
+    file << "  ]" << endl;
+    file << "}" << endl;
+
+    cout << "Writing benchmark results to " << path << endl;
+}
+
+/**
+ Benchmarks entry point. Accepts the render configuration options, plus "--filter=name" to select the benchmarks
+ and "--output=path" to choose the JSON report path
+ @param argc Counter of input arguments
+ @param argv Array of pointers to the arguments
+ @return
+ */
+int main(int argc, const char * argv[]) {
+    // Reading the runtime configuration from the command line
+    render_configuration.parseCommandLine(argc, argv, true, { "filter", "output" });
+
+    // Reading the benchmark options
+    for(int i = 1; i < argc; i++) {
+        const string argument = argv[i];
+        if(argument.rfind("--filter=", 0) == 0)
+            benchmark_filter = argument.substr(9);
+        else if(argument.rfind("--output=", 0) == 0)
+            output_path = argument.substr(9);
+    }
+
+    // Making the runs reproducible
+    RandomGenerator::getInstance()->setSeed(BENCHMARK_SEED);
+
+    // Micro benchmarks
+    benchmarkBoundingBox();
+    benchmarkTriangle();
+    benchmarkBVH();
+    benchmarkKDTree();
+    benchmarkPerlinNoise();
+    benchmarkFractalNoise();
+    benchmarkToneMapping();
+
+    // Scene benchmarks
+    benchmarkScene("scene_default", defineDefaultScene);
+    benchmarkScene("scene_photon_mapping", definePhotonMappingScene);
+    benchmarkScene("scene_usi_competition", defineUSICompetitionScene);
+
+    // Writing the report
+    writeResults(output_path);
+
+    return 0;
+}
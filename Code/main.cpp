@@ -7,7 +7,9 @@ using namespace std;
 #include "Import.h"
 
 // Scene variables
-vector<Image *> images; ///< A list of all the rendered images
+FrameWriter * frame_writer; ///< The stage post-processing and writing the rendered images in background
+TileCoordinator * tile_coordinator = nullptr; ///< The coordinator distributing the tiles, if rendering distributed
+vector<pair<string, RenderStatistics>> frames_statistics; ///< The render statistics of each frame
 
 /**
  * Function that defines the cameras capturing the scene
@@ -33,200 +35,112 @@ void defineCameras(const int frame_number){
 }
 
 /**
- * Function that generates the pixel color based on camera and ray direction
- * @param current_camera The camera currently rendering the scene
- * @param ray_direction The ray pointing at the pixel from the camera prospective
- * @return
+ * Function that prepares the scene of a frame, building its SDS and photon maps
+ * @param frame_number The number of the frame, starting from 0
+ * @param argc Counter of the command line arguments
+ * @param argv The command line arguments, taking precedence over the settings of the scene file
  */
-glm::vec3 computePixel(const Camera * current_camera, const glm::vec3 ray_direction) {
-    // Generating the pixel value using depth of field
-    if(USE_DEPTH_OF_FIELD) {
-        // Initializing the pixel color
-        auto pixel_color = glm::vec3(0);
-
-        // Initializing the focal point
-        glm::vec3 focal_point = current_camera->getFocalDistance()
-                                    * (ray_direction / ray_direction.z) ;
-
-        // Creating a samples of ray shifted by the lens aperture
-        for(int k = 0; k < DEPTH_OF_FIELD_SAMPLES_AMOUNT; k++) {
-            // Generating a random 2D coordinate withing the lens plane
-            glm::vec2 lens_offset = glm::diskRand(current_camera->getAperture());
-            // Generating the new ray origin, shifted by the aperture lens
-            auto shifted_ray_origin = glm::vec3(lens_offset.x, lens_offset.y, 0.0f);
-            // Generating the new ray direction, going from the new origin to the focal point
-            glm::vec3 shifted_ray_direction = normalize(focal_point - shifted_ray_origin);
-
-            // Creating the new ray
-            Ray shifted_ray {
-            .origin = shifted_ray_origin,
-            .direction = shifted_ray_direction,
-            .current_medium_refraction_index = 1.0f
-            };
-
-            // Globalizing the ray
-            shifted_ray = current_camera->globalizeRay(shifted_ray);
-
-            // Creating the pixel color
-            pixel_color += traceRay(shifted_ray, 0);
-        }
+void prepareScene(const int frame_number, const int argc, const char * argv[]) {
+    // Reseeding the random elements of the scene, so that every process preparing the frame builds the same scene
+    scene_generator.seedScene(frame_number);
 
-        // Computing the mean value of all the shifted rays
-        pixel_color = pixel_color / (float)DEPTH_OF_FIELD_SAMPLES_AMOUNT;
+    // Initializing the materials
+    defineStandardMaterials(frame_number);
 
-        // Returning the value
-        return pixel_color;
-    }
-    // Generating the pixel value with an infinitely small aperture
-    else {
-        // Creating the ray object
-        Ray current_ray {
-            .origin = glm::vec3(0.0f),
-            .direction = ray_direction,
-            .current_medium_refraction_index = 1.0f
-        };
-
-        // Globalizing the ray
-        current_ray = current_camera->globalizeRay(current_ray);
-
-        // Returning the pixel value
-        return traceRay(current_ray, 0);
+    // Defining the scene to be rendered, either from the scene file or from the compiled-in scene
+    if(!render_configuration.scene_path.empty()) {
+        scene_loader.load(render_configuration.scene_path, frame_number + 1);
+
+        // Giving precedence to the command line over the settings of the scene file
+        render_configuration.parseCommandLine(argc, argv, false);
     }
-}
+    else
+        defineDefaultScene(frame_number);
 
-/**
- * Function that render the HDR pixels representing the current scene
- */
-void renderCurrentScene() {
-    for (const auto current_camera : cameras) {
-        if (PRINT_RAYTRACING_EXECUTION_TIME)
-            std::cout << "Starting rendering of camera " << current_camera->getName() << std::endl;
+    // Inserting the default cameras if the scene does not define any
+    if(cameras.empty())
+        defineCameras(frame_number + 1);
 
-        // Ensure camera dimensions are integers
-        const int camera_width = static_cast<int>(current_camera->getWidth());
-        const int camera_height = static_cast<int>(current_camera->getHeight());
-        const float camera_fov = current_camera->getFOV();
-
-        // Compute pixel size and position
-        const float pixel_size = 2 * tan(glm::radians(camera_fov / 2)) / camera_width;
-        const float top_left_X = -(pixel_size * camera_width) / 2;
-        const float top_left_Y = (pixel_size * camera_height) / 2;
-
-        // Initializing a new image
-        auto current_image = new Image(current_camera->getName(), camera_width, camera_height);
-
-        clock_t current_time = clock();
-
-        // Create a shared progress counter
-        int progress = 0;
-        const int total_rays = camera_width * camera_height;
-
-        #pragma omp parallel for schedule(dynamic)
-        for (int i = 0; i < camera_width; i++) {
-            for (int j = 0; j < camera_height; j++) {
-                glm::vec3 pixel_color(0.0f);
-
-                // Compute pixel value with antialiasing
-                if (USE_ANTIALIASING) {
-                    float increment_ray_difference = pixel_size / ANTIALIASING_SUBDIVISIONS_AMOUNT;
-                    glm::vec3 thread_pixel_color(0.0f);
-
-                    for (unsigned int delta_x = 0; delta_x < ANTIALIASING_SUBDIVISIONS_AMOUNT; delta_x++) {
-                        for (unsigned int delta_y = 0; delta_y < ANTIALIASING_SUBDIVISIONS_AMOUNT; delta_y++) {
-                            glm::vec3 current_ray_direction(
-                                top_left_X + i * pixel_size + increment_ray_difference * delta_x,
-                                top_left_Y - j * pixel_size - increment_ray_difference * delta_y,
-                                1.0f
-                            );
-                            current_ray_direction = normalize(current_ray_direction);
-                            thread_pixel_color += computePixel(current_camera, current_ray_direction);
-                        }
-                    }
-                    pixel_color = thread_pixel_color / (ANTIALIASING_SUBDIVISIONS_AMOUNT * ANTIALIASING_SUBDIVISIONS_AMOUNT);
-                }
-                // Compute pixel value without antialiasing
-                else {
-                    glm::vec3 current_ray_direction(
-                        top_left_X + i * pixel_size + pixel_size / 2,
-                        top_left_Y - j * pixel_size - pixel_size / 2,
-                        1.0f
-                    );
-                    current_ray_direction = normalize(current_ray_direction);
-                    pixel_color = computePixel(current_camera, current_ray_direction);
-                }
-
-                // Updating the progress counter atomically
-                if (PRINT_RAYTRACING_EXECUTION_PERCENTAGE) {
-                    #pragma omp atomic
-                    progress++;
-                }
-
-                // Print current progress
-                if (PRINT_RAYTRACING_EXECUTION_PERCENTAGE) {
-                    #pragma omp critical
-                    {
-                        // Computing the total progress
-                        float percent_complete = ((progress * 100.0f) / total_rays);
-                        // Printing the total progress
-                        cout << fixed << setprecision(2) << current_camera->getName()
-                            << " current progress: " << percent_complete << " %" << std::endl;
-                    }
-                }
-
-                // Set the HDR pixel
-                current_image->setHDRPixel(i, j, pixel_color);
+    // Baking the procedural materials, before the SDS may page the primitives out of memory
+    BakeProceduralMaterials(render_configuration);
+
+    // Gathering the targets of the caustics photons, for the same reason
+    vector<CausticTarget> caustic_targets;
+    if(render_configuration.use_photon_mapping && render_configuration.use_caustic)
+        caustic_targets = collectCausticTargets();
+
+    // Building the SDS selected for the scene
+    sds = buildSDS(render_configuration);
+
+    // Releasing the geometry of the loaded meshes once the SDS paged their triangles out
+    if(sds->hasPagedOutTriangles())
+        scene_loader.releaseMeshesGeometry();
+
+    // Applying photon mapping
+    if(render_configuration.use_photon_mapping) {
+        // Building the indirect lights KD tree
+        if(render_configuration.use_indirect_lighting) {
+            PrintStartingProcess("construction of the indirect lights KD Tree");
+
+            // Building the KD Tree
+            {
+                const ProfilerScope profiler_scope("build the KD tree", "build", true);
+                indirect_photons_root = buildKDTree(indirect_photons);
             }
+
+            cout << "Amount of indirect photons : " << caustic_photons.size() << endl;
         }
 
-        // Measure execution time
-        current_time = clock() - current_time;
-        if (PRINT_RAYTRACING_EXECUTION_TIME)
-            PrintExecutionTime(current_time, "render camera " + current_camera->getName());
+        // Building the caustics KD tree
+        if(render_configuration.use_caustic) {
+            // Generating photons
+            traceCausticsPhotons(caustic_targets);
+
+            PrintStartingProcess("construction of the caustics KD Tree");
+
+            // Building the KD Tree
+            const ProfilerScope profiler_scope("build the KD tree", "build", true);
+            caustic_photons_root = buildKDTree(caustic_photons);
+        }
 
-        images.push_back(current_image);
     }
 }
 
 /**
- * Function that applies post-processing to images
+ * Function that render the HDR pixels representing the current scene, handing each image to the frame writer
+ * @param frame_number The number of the frame, starting from 0
  */
-void postprocessImages(){
-    // Iterating the images and applying the post-process pipeline
-    for (const auto & current_image : images) {
-        // Clock time at the beginning of the rendering
-        clock_t current_time = clock();
+void renderCurrentScene(const int frame_number) {
+    // Selecting the kernel specialized on the features of the current configuration
+    const RenderKernel render_kernel = selectRenderKernel(render_configuration);
 
-        // Applying the post-processing pipeline
-        current_image->applyPostProcessing();
+    for (int camera_index = 0; camera_index < static_cast<int>(cameras.size()); camera_index++) {
+        const auto current_camera = cameras[camera_index];
+        if (PRINT_RAYTRACING_EXECUTION_TIME)
+            std::cout << "Starting rendering of camera " << current_camera->getName() << std::endl;
 
-        // Printing useful data regarding the ray tracing time
-        current_time = clock() - current_time;
+        // Ensure camera dimensions are integers
+        const int camera_width = static_cast<int>(current_camera->getWidth());
+        const int camera_height = static_cast<int>(current_camera->getHeight());
 
-        // Printing execution time
-        if(PRINT_POST_PROCESSING_EXECUTION_TIME)
-            PrintExecutionTime(current_time, "execute post processing");
-    }
-}
+        // Acquiring a framebuffer, waiting for a previous image to be written if none is available
+        const auto current_image = frame_writer->acquireImage(current_camera->getName(), camera_width, camera_height);
+
+        // Rendering the image
+        {
+            const ProfilerScope profiler_scope("render camera " + current_camera->getName(), "render",
+                PRINT_RAYTRACING_EXECUTION_TIME);
+            if(tile_coordinator)
+                tile_coordinator->renderImage(frame_number, camera_index, render_kernel, current_camera,
+                    current_image);
+            else
+                renderImage(render_kernel, current_camera, current_image,
+                    SampleGenerator::computeImageSeed(frame_number, camera_index));
+        }
 
-/**
- * Function tha reset the scene between frames generation
- */
-inline void ResetScene() {
-    // Clearing the containers of entities
-    lights.clear();
-    directional_lights.clear();
-    primitives.clear();
-    planes.clear();
-    cameras.clear();
-
-    // Clearing the photons map
-    caustic_photons.clear();
-    indirect_photons.clear();
-    caustic_photons_root = nullptr;
-    indirect_photons_root = nullptr;
-
-    // Freeing the BVH memory
-    bvh->clear();
+        // Post-processing and writing the image in background, while the next one renders
+        frame_writer->submitImage(current_image, render_configuration);
+    }
 }
 
 inline void testingFunction () {
@@ -284,77 +198,56 @@ int main(int argc, const char * argv[]) {
     // Testing function
     // testingFunction();
 
-    // Generating an arbitrary amount of frames, passing down the frame number to scene constructor
-    for(int frame_number = 0; frame_number < FRAMES_GENERATED; frame_number++) {
-        // Initializing the materials
-        defineStandardMaterials(frame_number);
+    // Reading the runtime configuration from the command line
+    render_configuration.parseCommandLine(argc, argv);
 
-        // Defining the scene to be rendered
-        defineDefaultScene(frame_number);
+    // Rendering the requested tiles in case the process is a worker of a distributed render
+    if(!render_configuration.worker_address.empty())
+        return runTileWorker(render_configuration.worker_address, argc, argv, prepareScene);
 
-        // Inserting cameras in the scene
-        defineCameras(frame_number + 1);
-
-        // Building the BVH
-        bvh = new BVH();
+    // Serving the render jobs on the resident scene in case the process is a render server
+    if(!render_configuration.server_path.empty())
+        return runRenderServer(render_configuration.server_path, argc, argv, prepareScene);
 
-        // Applying photon mapping
-        if(USE_PHOTON_MAPPING) {
-            // Building the indirect lights KD tree
-            if(USE_INDIRECT_LIGHTING) {
-                PrintStartingProcess("construction of the indirect lights KD Tree");
+    // Starting the coordinator distributing the tiles to the workers
+    if(render_configuration.isCoordinator())
+        tile_coordinator = new TileCoordinator(render_configuration, argc, argv);
 
-                // Storing the starting time for KD Tree building
-                clock_t current_time = clock();
-
-                // Building the KD Tree
-                indirect_photons_root = buildKDTree(indirect_photons);
-
-                PrintExecutionTime(clock() - current_time, "build the KD tree");
-
-                cout << "Amount of indirect photons : " << caustic_photons.size() << endl;
-            }
+    // Starting the background output stage
+    frame_writer = new FrameWriter();
 
-            // Building the caustics KD tree
-            if(USE_CAUSTIC) {
-                // Generating photons
-                traceCausticsPhotons();
-
-                PrintStartingProcess("construction of the caustics KD Tree");
-
-                // Storing the starting time for KD Tree building
-                clock_t current_time = clock();
-
-                // Building the KD Tree
-                caustic_photons_root = buildKDTree(caustic_photons);
+    // Generating an arbitrary amount of frames, passing down the frame number to scene constructor
+    for(int frame_number = 0; frame_number < FRAMES_GENERATED; frame_number++) {
+        // Preparing the scene of the frame
+        prepareScene(frame_number, argc, argv);
 
-                // Printing execution time
-                PrintExecutionTime(clock() - current_time, "build the KD tree");
-            }
+        // Rendering the scene
+        renderCurrentScene(frame_number);
 
+        // Aggregating the statistics of the frame
+        if(USE_RENDER_STATISTICS) {
+            frames_statistics.emplace_back("Frame " + to_string(frame_number + 1), collectRenderStatistics());
+            frames_statistics.back().second.print(frames_statistics.back().first);
+            TextureCache::getInstance()->printStatistics();
         }
 
-        Ray test_ray {
-            .origin = glm::vec3(0,0,0),
-            .direction = glm::vec3(0, 0, 1),
-        };
-
-        traceRay(test_ray, 0);
-
-        // Rendering the scene
-        renderCurrentScene();
-
         // Resetting the scene
         ResetScene();
     }
 
-    // Applying post-processing
-    postprocessImages();
+    // Shutting the workers down
+    delete tile_coordinator;
 
-    // Iterating the images and applying the post-process pipeline
-    for (const auto & current_image : images) {
-        current_image->writeImage("./" + current_image->getName() + ".ppm");
-    }
+    // Waiting for the last images to be written
+    delete frame_writer;
+
+    // Writing the render statistics
+    if(USE_RENDER_STATISTICS && !render_configuration.statistics_path.empty())
+        writeRenderStatistics(render_configuration.statistics_path, frames_statistics);
+
+    // Writing the profiler timeline
+    if(isProfilerRecording())
+        writeProfilerTrace(render_configuration.trace_path);
 
     return 0;
 }
\ No newline at end of file